@@ -0,0 +1,73 @@
+/**
+ * @file alloc_hook.cpp
+ * @brief 替换全局 operator new / delete，统计分配次数与峰值占用
+ */
+#include "bench.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+#include <sys/resource.h>
+
+namespace
+{
+  std::atomic<uint64_t> s_allocations{0};
+  std::atomic<uint64_t> s_bytes{0};
+  std::atomic<uint64_t> s_live{0};
+  std::atomic<uint64_t> s_peak{0};
+
+  void *countedAlloc(size_t size)
+  {
+    void *p = malloc(size ? size : 1);
+    if (!p)
+      throw std::bad_alloc();
+    size_t usable = malloc_usable_size(p);
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(usable, std::memory_order_relaxed);
+    uint64_t live = s_live.fetch_add(usable, std::memory_order_relaxed) + usable;
+    uint64_t peak = s_peak.load(std::memory_order_relaxed);
+    while (live > peak && !s_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+    return p;
+  }
+
+  void countedFree(void *p)
+  {
+    if (!p)
+      return;
+    s_live.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    free(p);
+  }
+}
+
+void *operator new(size_t size) { return countedAlloc(size); }
+void *operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void *p) noexcept { countedFree(p); }
+void operator delete[](void *p) noexcept { countedFree(p); }
+void operator delete(void *p, size_t) noexcept { countedFree(p); }
+void operator delete[](void *p, size_t) noexcept { countedFree(p); }
+
+namespace bench
+{
+  AllocStats allocStats()
+  {
+    AllocStats s;
+    s.allocations = s_allocations.load(std::memory_order_relaxed);
+    s.bytes = s_bytes.load(std::memory_order_relaxed);
+    s.live_bytes = s_live.load(std::memory_order_relaxed);
+    s.peak_bytes = s_peak.load(std::memory_order_relaxed);
+    return s;
+  }
+
+  void resetAllocPeak() { s_peak.store(s_live.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+  long maxRssKb()
+  {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+  }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file bench.h
+ * @brief 主机基准测试框架：注册、计时、内存统计
+ *
+ * 每个基准测试是一个函数，通过 BENCH_REGISTER 注册；
+ * bench_main.cpp 按名称运行其中一个或全部。
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace bench
+{
+  //===========================================================
+  // 注册
+  //===========================================================
+  struct Args
+  {
+    double seconds = 60.0;                      // 每个场景处理的音频时长（秒）
+    std::map<std::string, std::string> options; // 其他 --key value 参数
+
+    double option(const char *key, double def) const
+    {
+      auto it = options.find(key);
+      return it == options.end() ? def : atof(it->second.c_str());
+    }
+  };
+
+  using Fn = void (*)(const Args &args);
+
+  struct Entry
+  {
+    const char *name;
+    const char *description;
+    Fn fn;
+  };
+
+  std::vector<Entry> &registry();
+
+  struct Registrar
+  {
+    Registrar(const char *name, const char *description, Fn fn) { registry().push_back({name, description, fn}); }
+  };
+
+#define BENCH_REGISTER(name, description, fn) static ::bench::Registrar bench_registrar_##fn(name, description, fn)
+
+  //===========================================================
+  // 计时
+  //===========================================================
+  /** @brief 周期计数（x86 为 TSC，其他平台为纳秒） */
+  inline uint64_t cycles()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  /** @brief 墙钟时间（秒） */
+  inline double wallSeconds()
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  //===========================================================
+  // 内存统计（alloc_hook.cpp 替换全局 operator new / delete）
+  //===========================================================
+  struct AllocStats
+  {
+    uint64_t allocations = 0; // 分配次数
+    uint64_t bytes = 0;       // 分配总字节数
+    uint64_t live_bytes = 0;  // 当前占用
+    uint64_t peak_bytes = 0;  // 峰值占用
+  };
+
+  /** @brief 当前统计快照 */
+  AllocStats allocStats();
+
+  /** @brief 把峰值重置为当前占用，用于测量一个区间内的峰值 */
+  void resetAllocPeak();
+
+  /** @brief 进程最大常驻内存（KB） */
+  long maxRssKb();
+}
@@ -0,0 +1,34 @@
+/**
+ * @file bench_battery.cpp
+ * @brief 电池监视：每个样本的处理开销（滤波 + 电量映射 + 区间）
+ *
+ * 映射、IIR 与区间滞回的检查在 test/test_battery_monitor。
+ */
+#include "bench.h"
+
+#include "battery_monitor.h"
+
+namespace
+{
+  volatile uint32_t s_sink;
+
+  void benchBattery(const bench::Args &args)
+  {
+    // 开销：每个样本（滤波 + 映射 + 区间）
+    size_t samples = (size_t)(args.seconds * 10 * 1000); // 10 帧 / 秒，放大 1000 倍以便计时
+    BatteryFilter cost;
+    BatteryZone z = BatteryZone::Ok;
+    uint64_t c0 = bench::cycles();
+    for (size_t i = 0; i < samples; i++)
+    {
+      uint32_t mv = cost.update(3300 + (uint32_t)(i % 900));
+      z = batteryZone(batteryLevel(mv), z);
+      s_sink = (uint32_t)z;
+    }
+    uint64_t c1 = bench::cycles();
+    printf("per sample: %.1f cycles (%d frames / s)\n", (double)(c1 - c0) / (double)samples,
+           BATTERY_ADC_SAMPLE_HZ / BATTERY_ADC_FRAME);
+  }
+}
+
+BENCH_REGISTER("battery", "battery monitor: per-sample cost of IIR average, level and zone", benchBattery);
@@ -0,0 +1,134 @@
+/**
+ * @file bench_es8311.cpp
+ * @brief ES8311 寄存器访问基准：原驱动逐寄存器读-改-写（100 kHz）vs 影子缓存批量写（400 kHz）
+ *
+ * 在模拟 I2C 总线上（按时钟频率推进虚拟时间，见 Wire.h）比较：
+ *  - 音量渐变：DAC 音量 0x32 分 N 步
+ *  - 模式切换：录音 ↔ 播放时 ADC / DAC 电源与通路相关的一组寄存器
+ * 输出 I2C 事务数、字节数与总线时间。
+ *
+ * 参数：--steps 渐变步数（默认 32）--clock 缓存时的 I2C 时钟（默认 ES8311_I2C_CLOCK_HZ）
+ */
+#include "bench.h"
+
+#include "AudioBoard.h"
+#include "es8311_regs.h"
+
+namespace
+{
+  // 录音 → 播放：ADC 掉电、DAC 上电、输出通路（寄存器, 值）
+  const uint8_t MODE_PLAY[][2] = {
+      {0x0D, 0x01}, {0x0E, 0x6A}, {0x12, 0x00}, {0x13, 0x10}, {0x14, 0x1A},
+      {0x15, 0x40}, {0x17, 0x00}, {0x31, 0x00}, {0x32, 0xBF}, {0x37, 0x08},
+  };
+  // 播放 → 录音
+  const uint8_t MODE_RECORD[][2] = {
+      {0x0D, 0x01}, {0x0E, 0x02}, {0x12, 0x02}, {0x13, 0x00}, {0x14, 0x1A},
+      {0x15, 0x40}, {0x17, 0xBF}, {0x31, 0x60}, {0x32, 0x00}, {0x37, 0x48},
+  };
+
+  struct Cost
+  {
+    uint32_t transactions;
+    uint32_t bytes;
+    uint64_t bus_us;
+  };
+
+  template <class Fn>
+  Cost measure(TwoWire &wire, Fn &&fn)
+  {
+    host::I2CStats s0 = wire.stats();
+    uint64_t t0 = host::nowMicros();
+    fn();
+    host::I2CStats s1 = wire.stats();
+    return {s1.transactions - s0.transactions, s1.bytes - s0.bytes, host::nowMicros() - t0};
+  }
+
+  /** @brief 原驱动的做法：每个寄存器读出再写回（updateReg） */
+  void rmw(TwoWire &wire, uint8_t reg, uint8_t val)
+  {
+    wire.beginTransmission(ES8311_I2C_ADDR);
+    wire.write(reg);
+    wire.endTransmission(false);
+    wire.requestFrom((uint8_t)ES8311_I2C_ADDR, (size_t)1);
+    wire.read();
+    wire.beginTransmission(ES8311_I2C_ADDR);
+    wire.write(reg);
+    wire.write(val);
+    wire.endTransmission();
+  }
+
+  void print(const char *name, const char *mode, const Cost &c, size_t ops)
+  {
+    printf("%-14s %-22s %8u %8u %12.1f %12.1f\n", name, mode, c.transactions, c.bytes, (double)c.bus_us,
+           (double)c.bus_us / (double)ops);
+  }
+
+  void benchEs8311(const bench::Args &args)
+  {
+    size_t steps = (size_t)args.option("steps", 32);
+    uint32_t clock = (uint32_t)args.option("clock", ES8311_I2C_CLOCK_HZ);
+
+    TwoWire wire(1);
+    DriverPins pins;
+    pins.addI2C(PinFunction::CODEC, 0, 0, ES8311_I2C_ADDR, 100000, wire);
+    pins.begin();
+    wire.device(ES8311_I2C_ADDR)->ready_at_us = 0;
+    AudioDriverES8311Class driver;
+    driver.begin(pins);
+
+    printf("%-14s %-22s %8s %8s %12s %12s\n", "scenario", "mode", "trans", "bytes", "bus us", "us/op");
+
+    // 音量渐变
+    wire.setClock(100000);
+    Cost drv_ramp = measure(wire,
+                            [&]
+                            {
+                              for (size_t i = 0; i < steps; i++)
+                                rmw(wire, 0x32, (uint8_t)(i * 255 / steps));
+                            });
+
+    Es8311Registers cache;
+    Cost seed = measure(wire, [&] { cache.begin(wire, ES8311_I2C_ADDR, clock); });
+    Cost cache_ramp = measure(wire,
+                              [&]
+                              {
+                                for (size_t i = 0; i < steps; i++)
+                                  cache.write(0x32, (uint8_t)(255 - i * 255 / steps));
+                              });
+    print("volume ramp", "driver rmw 100k", drv_ramp, steps);
+    print("volume ramp", "cache 400k", cache_ramp, steps);
+
+    // 模式切换
+    size_t n = sizeof(MODE_PLAY) / sizeof(MODE_PLAY[0]);
+    wire.setClock(100000);
+    Cost drv_mode = measure(wire,
+                            [&]
+                            {
+                              for (auto &rv : MODE_PLAY)
+                                rmw(wire, rv[0], rv[1]);
+                              for (auto &rv : MODE_RECORD)
+                                rmw(wire, rv[0], rv[1]);
+                            });
+    cache.refresh();
+    wire.setClock(clock);
+    Cost cache_mode = measure(wire,
+                              [&]
+                              {
+                                cache.writeBatch(MODE_PLAY, n);
+                                cache.writeBatch(MODE_RECORD, n);
+                              });
+    print("mode switch x2", "driver rmw 100k", drv_mode, 2);
+    print("mode switch x2", "cache batch 400k", cache_mode, 2);
+
+    printf("cache seed (one-time burst read of all registers): %u transactions, %.1f us\n", seed.transactions,
+           (double)seed.bus_us);
+    bool same = true;
+    for (auto &rv : MODE_RECORD)
+      same = same && wire.device(ES8311_I2C_ADDR)->regs[rv[0]] == rv[1];
+    printf("chip registers match shadow: %s\n", same ? "yes" : "NO");
+  }
+}
+
+BENCH_REGISTER("es8311", "ES8311 I2C cost: driver read-modify-write at 100 kHz vs shadow cache bursts at 400 kHz",
+               benchEs8311);
@@ -0,0 +1,82 @@
+/**
+ * @file bench_es8311_driver.cpp
+ * @brief 精简 ES8311 驱动（src/es8311.c）在模拟 I2C 总线上的初始化开销
+ *
+ * 初始化的 I2C 事务数、字节数与总线时间，对比 arduino-audio-driver 的逐寄存器初始化。
+ * 寄存器值、时钟分频、音量 / 静音 / 待机与错误路径的检查在 test/test_es8311_driver。
+ *
+ * 参数：--clock I2C 时钟（默认 100000）
+ */
+#include "bench.h"
+
+#include "AudioBoard.h"
+#include "es8311.h"
+#include "es8311_regs.h"
+
+namespace
+{
+  struct Bus
+  {
+    TwoWire wire{1};
+    host::I2CRegisterDevice *dev;
+    es8311_bus_t bus;
+
+    explicit Bus(uint32_t clock_hz)
+    {
+      wire.begin(-1, -1, clock_hz);
+      dev = &host::attachEs8311(wire);
+      dev->ready_at_us = 0;
+      bus = es8311WireBus(wire, ES8311_DEFAULT_ADDR);
+    }
+  };
+
+  struct Cost
+  {
+    uint32_t transactions;
+    uint32_t bytes;
+    double us;
+  };
+
+  template <class Fn>
+  Cost measure(TwoWire &wire, Fn &&fn)
+  {
+    host::I2CStats s0 = wire.stats();
+    uint64_t t0 = host::nowMicros();
+    fn();
+    return {wire.stats().transactions - s0.transactions, wire.stats().bytes - s0.bytes,
+            (double)(host::nowMicros() - t0)};
+  }
+
+  void benchEs8311Driver(const bench::Args &args)
+  {
+    uint32_t clock_hz = (uint32_t)args.option("clock", 100000);
+    // 本项目的格式：16 kHz、32 位，MCLK = 256 fs
+    es8311_clock_t clk = {4096000, 16000, 32, false};
+
+    Bus b(clock_hz);
+    es8311_t dev;
+    es8311_err_t err = ES8311_ERR_ARG;
+    Cost lean = measure(b.wire, [&] { err = es8311_init(&dev, &b.bus, &clk, ES8311_MODE_BOTH); });
+    if (err != ES8311_OK)
+      printf("es8311_init failed: %d\n", (int)err);
+
+    // arduino-audio-driver：芯片 ID 两次单独读取 + 逐寄存器写入
+    Bus ref_bus(clock_hz);
+    DriverPins pins;
+    pins.addI2C(PinFunction::CODEC, 0, 0, ES8311_DEFAULT_ADDR, clock_hz, ref_bus.wire);
+    pins.begin(); // 重新挂载寄存器模型
+    ref_bus.dev->ready_at_us = 0;
+    bool ref_ok = false;
+    Cost ref = measure(ref_bus.wire, [&] { ref_ok = AudioDriverES8311.begin(pins); });
+    if (!ref_ok)
+      printf("reference driver init failed\n");
+
+    printf("\ninit cost at %lu Hz I2C\n", (unsigned long)clock_hz);
+    printf("%-24s %12s %8s %10s\n", "driver", "transactions", "bytes", "bus us");
+    printf("%-24s %12u %8u %10.0f\n", "arduino-audio-driver", ref.transactions, ref.bytes, ref.us);
+    printf("%-24s %12u %8u %10.0f\n", "es8311.c", lean.transactions, lean.bytes, lean.us);
+  }
+}
+
+BENCH_REGISTER("es8311_driver", "lean ES8311 driver vs arduino-audio-driver: init I2C cost on the mock bus",
+               benchEs8311Driver);
@@ -0,0 +1,136 @@
+/**
+ * @file bench_fanout.cpp
+ * @brief 块分发基准：1 到 8 个消费者，逐个复制 vs 引用计数共享
+ *
+ * 每个块模拟一次 I2S 读取（从合成波形复制进块），然后交给 N 个消费者；
+ * 消费者对块做一次只读扫描（求峰值，相当于电平表 / VAD 的最小工作量）。
+ *  - copy：每个消费者从自己的块池取块并复制一份（当前复制 WVA_RECORDBuf 的做法）
+ *  - shared：BlockFanout 分发同一块，消费者从各自队列取出、扫描、释放引用
+ * 输出每块周期数、吞吐量与运行期间的分配次数。
+ *
+ * 参数：--block 字节（默认 512）
+ */
+#include "bench.h"
+
+#include "block_fanout.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+  constexpr size_t MAX_CONSUMERS = BLOCK_FANOUT_MAX_SINKS;
+
+  volatile uint32_t s_sink; // 防止扫描被优化掉
+
+  inline void scan(const AudioBlock *block)
+  {
+    const int32_t *s = (const int32_t *)block->data;
+    uint32_t peak = 0;
+    for (size_t i = 0; i < block->length / 4; i++)
+    {
+      uint32_t a = (uint32_t)(s[i] < 0 ? -(int64_t)s[i] : s[i]);
+      peak = a > peak ? a : peak;
+    }
+    s_sink = peak;
+  }
+
+  struct Result
+  {
+    double cycles_per_block;
+    double mb_per_s;
+    uint64_t allocations;
+    uint32_t exhausted;
+  };
+
+  template <class Fn>
+  Result run(size_t blocks, size_t block_bytes, BlockPool &pool, Fn &&per_block)
+  {
+    bench::AllocStats a0 = bench::allocStats();
+    uint32_t ex0 = pool.exhausted();
+    double w0 = bench::wallSeconds();
+    uint64_t c0 = bench::cycles();
+    for (size_t i = 0; i < blocks; i++)
+      per_block();
+    uint64_t c1 = bench::cycles();
+    double w1 = bench::wallSeconds();
+    bench::AllocStats a1 = bench::allocStats();
+
+    Result r;
+    r.cycles_per_block = (double)(c1 - c0) / (double)blocks;
+    r.mb_per_s = (double)blocks * (double)block_bytes / (w1 - w0) / 1e6;
+    r.allocations = a1.allocations - a0.allocations;
+    r.exhausted = pool.exhausted() - ex0;
+    return r;
+  }
+
+  void benchFanout(const bench::Args &args)
+  {
+    size_t block_bytes = (size_t)args.option("block", 512) & ~(size_t)3;
+    size_t blocks = (size_t)(args.seconds * 16000 * 4 / (double)block_bytes);
+
+    // 块池：生产者 1 块 + 每个消费者各 1 块（copy）或队列中的引用（shared）
+    std::vector<uint8_t> memory((MAX_CONSUMERS + 2) * block_bytes);
+    std::vector<AudioBlock> descs(MAX_CONSUMERS + 2);
+    BlockPool pool;
+    pool.init(memory.data(), descs.data(), (uint16_t)descs.size(), (uint32_t)block_bytes);
+
+    std::vector<int32_t> wave(block_bytes / 4);
+    for (size_t i = 0; i < wave.size(); i++)
+      wave[i] = (int32_t)(sin(i * 0.05) * 1e9);
+
+    printf("block %zu B, %zu blocks per run\n", block_bytes, blocks);
+    printf("%-9s %-7s %14s %10s %8s %10s\n", "consumers", "mode", "cycles/block", "MB/s", "allocs", "exhausted");
+
+    for (size_t n = 1; n <= MAX_CONSUMERS; n++)
+    {
+      // copy：每个消费者一份拷贝
+      Result copy = run(blocks, block_bytes, pool,
+                        [&]
+                        {
+                          AudioBlock *src = pool.acquire();
+                          memcpy(src->data, wave.data(), block_bytes);
+                          src->length = (uint32_t)block_bytes;
+                          for (size_t c = 0; c < n; c++)
+                          {
+                            AudioBlock *own = pool.acquire();
+                            memcpy(own->data, src->data, src->length);
+                            own->length = src->length;
+                            scan(own);
+                            releaseAudioBlock(own);
+                          }
+                          releaseAudioBlock(src);
+                        });
+
+      // shared：分发同一块，各消费者从自己的队列取出
+      BlockFanout fanout;
+      std::vector<BlockQueueSink<4>> queues(n);
+      for (auto &q : queues)
+        fanout.add(q);
+      Result shared = run(blocks, block_bytes, pool,
+                          [&]
+                          {
+                            AudioBlock *src = pool.acquire();
+                            memcpy(src->data, wave.data(), block_bytes);
+                            src->length = (uint32_t)block_bytes;
+                            fanout.dispatch(src);
+                            for (auto &q : queues)
+                            {
+                              while (AudioBlock *b = q.pop())
+                              {
+                                scan(b);
+                                releaseAudioBlock(b);
+                              }
+                            }
+                          });
+
+      printf("%-9zu %-7s %14.0f %10.1f %8llu %10u\n", n, "copy", copy.cycles_per_block, copy.mb_per_s,
+             (unsigned long long)copy.allocations, copy.exhausted);
+      printf("%-9zu %-7s %14.0f %10.1f %8llu %10u\n", n, "shared", shared.cycles_per_block, shared.mb_per_s,
+             (unsigned long long)shared.allocations, shared.exhausted);
+    }
+    printf("pool peak in use %u of %u\n", pool.peakInUse(), pool.count());
+  }
+}
+
+BENCH_REGISTER("fanout", "one RX block to 1..8 consumers: per-consumer copy vs refcounted sharing", benchFanout);
@@ -0,0 +1,166 @@
+/**
+ * @file bench_format.cpp
+ * @brief 录音软件处理：按格式在编译期实例化的内核（InputDsp）与运行时判断的通用内核对比
+ *
+ *  - runtime：原来的实现，逐块判断字长、逐采样判断是否高通
+ *  - kernel：InputDsp<sample_t>，字长在编译期确定，高通 × 增益 各一个循环，逐块选定一次
+ * 对 16 / 32 位与 高通 / 增益 / 两者 的组合，输出每块周期数与占块时长的比例
+ * （16 kHz 单声道，AUDIO_DMA_BLOCK_SIZE 字节的块）。两者输出相同由 test/test_input_dsp 检查。
+ *
+ * 参数：--reps 重复次数（默认 5，取最小值）
+ */
+#include "bench.h"
+
+#include "audio_format.h"
+#include "input_dsp.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+  //===========================================================
+  // 参考实现：运行时判断字长与高通（与修改前的 InputDsp 相同）
+  //===========================================================
+  class RuntimeDsp
+  {
+  public:
+    void setGainDb(float db)
+    {
+      float g = powf(10.0f, db / 20.0f);
+      gain_q16_ = (int32_t)lrintf((g > 128.0f ? 128.0f : g) * 65536.0f);
+    }
+    void setHpf(bool enable) { hpf_ = enable; }
+    bool active() const { return hpf_ || gain_q16_ != (1 << 16); }
+
+    void process(AudioBlock *block, size_t bytes_per_sample)
+    {
+      if (!active())
+        return;
+      if (bytes_per_sample == 2)
+        processSamples((int16_t *)block->data, block->length / 2);
+      else
+        processSamples((int32_t *)block->data, block->length / 4);
+    }
+
+  private:
+    template <class T>
+    void processSamples(T *s, size_t n)
+    {
+      const int64_t lo = std::numeric_limits<T>::min();
+      const int64_t hi = std::numeric_limits<T>::max();
+      int64_t x1 = x1_, y1 = y1_;
+      for (size_t i = 0; i < n; i++)
+      {
+        int64_t v = s[i];
+        if (hpf_)
+        {
+          int64_t y = v - x1 + y1 - (y1 >> INPUT_DSP_HPF_SHIFT);
+          x1 = v;
+          y1 = y;
+          v = y;
+        }
+        v = (v * gain_q16_) >> 16;
+        s[i] = (T)(v < lo ? lo : v > hi ? hi : v);
+      }
+      x1_ = x1;
+      y1_ = y1;
+    }
+
+    int32_t gain_q16_ = 1 << 16;
+    bool hpf_ = false;
+    int64_t x1_ = 0;
+    int64_t y1_ = 0;
+  };
+
+  volatile uint8_t s_sink;
+
+  struct Case
+  {
+    const char *name;
+    bool hpf;
+    float gain_db;
+  };
+
+  /** @brief 合成输入：正弦 + 直流偏移，块号不同内容不同 */
+  template <class Fmt>
+  void fill(std::vector<uint8_t> &mem, size_t block_index)
+  {
+    typename Fmt::sample_t *s = (typename Fmt::sample_t *)mem.data();
+    double full = (double)std::numeric_limits<typename Fmt::sample_t>::max();
+    for (size_t i = 0; i < mem.size() / Fmt::bytes_per_sample; i++)
+    {
+      double t = (double)(block_index * Fmt::block_frames + i);
+      s[i] = (typename Fmt::sample_t)(sin(t * 0.05) * full * 0.6 + full * 0.1);
+    }
+  }
+
+  template <class Fmt>
+  void runFormat(const char *label, size_t blocks, int reps)
+  {
+    const Case cases[] = {{"hpf", true, 0.0f}, {"gain +6 dB", false, 6.0f}, {"hpf + gain +6 dB", true, 6.0f}};
+    const size_t kBlocks = 64; // 输入块（循环使用）
+    std::vector<std::vector<uint8_t>> input(kBlocks, std::vector<uint8_t>(AUDIO_DMA_BLOCK_SIZE));
+    for (size_t b = 0; b < kBlocks; b++)
+      fill<Fmt>(input[b], b);
+    std::vector<uint8_t> mem(AUDIO_DMA_BLOCK_SIZE);
+    AudioBlock block{};
+    block.data = mem.data();
+    block.capacity = AUDIO_DMA_BLOCK_SIZE;
+    block.length = AUDIO_DMA_BLOCK_SIZE;
+
+    for (const Case &c : cases)
+    {
+      RuntimeDsp ref;
+      InputDsp<typename Fmt::sample_t> dsp;
+      ref.setHpf(c.hpf);
+      ref.setGainDb(c.gain_db);
+      dsp.setHpf(c.hpf);
+      dsp.setGainDb(c.gain_db);
+
+      // 每块周期数（最小值）：每块先复制新的输入（避免反复处理同一块后饱和），减去只复制的时间
+      double best[3] = {0, 0, 0};
+      for (int r = 0; r < reps; r++)
+      {
+        for (int k = 0; k < 3; k++)
+        {
+          uint64_t c0 = bench::cycles();
+          for (size_t b = 0; b < blocks; b++)
+          {
+            memcpy(mem.data(), input[b % kBlocks].data(), AUDIO_DMA_BLOCK_SIZE);
+            if (k == 0)
+              ref.process(&block, Fmt::bytes_per_sample);
+            else if (k == 1)
+              dsp.process(&block);
+            s_sink = mem[b % AUDIO_DMA_BLOCK_SIZE];
+          }
+          double cyc = (double)(bench::cycles() - c0) / (double)blocks;
+          if (!r || cyc < best[k])
+            best[k] = cyc;
+        }
+      }
+      best[0] -= best[2];
+      best[1] -= best[2];
+      for (int k = 0; k < 2; k++)
+        printf("%-8s %-18s %-8s %14.0f %11.3f%%\n", label, c.name, k ? "kernel" : "runtime", best[k],
+               best[k] / 240.0 / Fmt::block_us * 100.0);
+      printf("%-8s %-18s %-8s %13.2fx\n", label, c.name, "speedup", best[0] / best[1]);
+    }
+  }
+
+  void benchFormat(const bench::Args &args)
+  {
+    int reps = (int)args.option("reps", 5);
+    reps = reps < 1 ? 1 : reps;
+    size_t blocks = (size_t)(args.seconds * 16000 * 4 / AUDIO_DMA_BLOCK_SIZE);
+    printf("%zu blocks of %d B per run, best of %d (realtime at 240 MHz, host cycles are only relative)\n", blocks,
+           AUDIO_DMA_BLOCK_SIZE, reps);
+    printf("%-8s %-18s %-8s %14s %12s\n", "format", "processing", "path", "cycles/block", "realtime");
+    runFormat<AudioFormat<16000, 1, 32>>("32 bit", blocks, reps);
+    runFormat<AudioFormat<16000, 1, 16>>("16 bit", blocks, reps);
+  }
+}
+
+BENCH_REGISTER("format", "format-specialized InputDsp kernels vs runtime-branching kernel: cycles/block",
+               benchFormat);
@@ -0,0 +1,77 @@
+/**
+ * @file bench_main.cpp
+ * @brief 主机基准测试入口
+ *
+ * 用法：
+ *   .pio/build/native_bench/program              运行全部
+ *   .pio/build/native_bench/program record       只运行 record
+ *   .pio/build/native_bench/program --list       列出全部
+ *   .pio/build/native_bench/program record --seconds 10
+ *   .pio/build/native_bench/program sd_stall --stall-prob 0.01   其他 --key value 由各基准自行解释
+ */
+#include "bench.h"
+
+#include "Arduino.h"
+
+#include <cstring>
+#include <filesystem>
+
+namespace bench
+{
+  std::vector<Entry> &registry()
+  {
+    static std::vector<Entry> entries;
+    return entries;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  bench::Args args;
+  std::vector<std::string> names;
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--list"))
+    {
+      for (auto &e : bench::registry())
+        printf("%-16s %s\n", e.name, e.description);
+      return 0;
+    }
+    else if (!strcmp(argv[i], "--seconds") && i + 1 < argc)
+      args.seconds = atof(argv[++i]);
+    else if (!strncmp(argv[i], "--", 2) && i + 1 < argc)
+    {
+      args.options[argv[i] + 2] = argv[i + 1];
+      i++;
+    }
+    else
+      names.push_back(argv[i]);
+  }
+
+  // 基准测试不按采样率计时：尽可能快地运行
+  host::env().pace_i2s = false;
+  host::env().sd_root = "host_bench_sd";
+  host::env().i2s_tx_path.clear();
+  std::error_code ec;
+  std::filesystem::create_directories(host::env().sd_root, ec);
+
+  int ran = 0;
+  for (auto &e : bench::registry())
+  {
+    bool selected = names.empty();
+    for (auto &n : names)
+      selected |= n == e.name;
+    if (!selected)
+      continue;
+    printf("=== %s: %s\n", e.name, e.description);
+    e.fn(args);
+    printf("\n");
+    ran++;
+  }
+  if (!ran)
+  {
+    fprintf(stderr, "no benchmark matched, see --list\n");
+    return 2;
+  }
+  return 0;
+}
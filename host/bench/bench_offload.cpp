@@ -0,0 +1,111 @@
+/**
+ * @file bench_offload.cpp
+ * @brief 增益 / 高通：软件处理 vs ES8311 硬件处理的 CPU 开销对比
+ *
+ *  - 软件：录音 InputDsp（32 位单声道，直流去除高通 + 增益），播放音量（16 位立体声，浮点乘法，
+ *          与 AudioPlayer 的软件音量相同）；每块周期数与占实时的比例
+ *  - 硬件：每块 0 周期；只在设置时产生一次 I2C 写入（模拟总线上的事务数与时间）
+ *
+ * 参数：--block 字节（默认 512）
+ */
+#include "bench.h"
+
+#include "AudioBoard.h"
+#include "es8311_controls.h"
+#include "input_dsp.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  volatile int32_t s_sink; // 防止处理被优化掉
+
+  struct Result
+  {
+    double cycles_per_block;
+    double ns_per_block;
+  };
+
+  template <class Fn>
+  Result run(size_t blocks, Fn &&fn)
+  {
+    double w0 = bench::wallSeconds();
+    uint64_t c0 = bench::cycles();
+    for (size_t i = 0; i < blocks; i++)
+      fn();
+    uint64_t c1 = bench::cycles();
+    double w1 = bench::wallSeconds();
+    return {(double)(c1 - c0) / (double)blocks, (w1 - w0) * 1e9 / (double)blocks};
+  }
+
+  void print(const char *stage, const char *path, const Result &r, double block_us)
+  {
+    printf("%-22s %-9s %14.0f %12.0f %10.3f%%\n", stage, path, r.cycles_per_block, r.ns_per_block,
+           r.ns_per_block / 1000.0 / block_us * 100.0);
+  }
+
+  void benchOffload(const bench::Args &args)
+  {
+    size_t block_bytes = (size_t)args.option("block", 512) & ~(size_t)3;
+    size_t blocks = (size_t)(args.seconds * 64000 / (double)block_bytes);
+
+    // 录音：16 kHz 32 位单声道（64000 B/s）；播放：44.1 kHz 16 位立体声（176400 B/s）
+    double rec_block_us = (double)block_bytes / 64000.0 * 1e6;
+    double play_block_us = (double)block_bytes / 176400.0 * 1e6;
+
+    std::vector<uint8_t> mem(block_bytes);
+    AudioBlock block{};
+    block.data = mem.data();
+    block.capacity = (uint32_t)block_bytes;
+    block.length = (uint32_t)block_bytes;
+    int32_t *s32 = (int32_t *)mem.data();
+    for (size_t i = 0; i < block_bytes / 4; i++)
+      s32[i] = (int32_t)(sin((double)i * 0.05) * 1e9) + 50000000; // 带直流偏移
+
+    printf("block %zu B, %zu blocks; record block %.0f us, playback block %.0f us\n", block_bytes, blocks,
+           rec_block_us, play_block_us);
+    printf("%-22s %-9s %14s %12s %11s\n", "stage", "path", "cycles/block", "ns/block", "realtime");
+
+    InputDsp<int32_t> dsp;
+    dsp.setHpf(true);
+    dsp.setGainDb(6.0f);
+    Result rec_sw = run(blocks,
+                        [&]
+                        {
+                          dsp.process(&block);
+                          s_sink = s32[0];
+                        });
+    print("record hpf + gain", "software", rec_sw, rec_block_us);
+    print("record hpf + gain", "es8311", {0, 0}, rec_block_us);
+
+    int16_t *s16 = (int16_t *)mem.data();
+    float volume = 0.55f;
+    Result play_sw = run(blocks,
+                         [&]
+                         {
+                           for (size_t i = 0; i < block_bytes / 2; i++)
+                             s16[i] = (int16_t)lrintf((float)s16[i] * volume);
+                           s_sink = s16[0];
+                         });
+    print("playback volume", "software", play_sw, play_block_us);
+    print("playback volume", "es8311", {0, 0}, play_block_us);
+
+    // 硬件：一次性寄存器写入（模拟 I2C 总线，寄存器缓存 400 kHz）
+    TwoWire wire(1);
+    DriverPins pins;
+    pins.addI2C(PinFunction::CODEC, 0, 0, ES8311_I2C_ADDR, 100000, wire);
+    pins.begin();
+    wire.device(ES8311_I2C_ADDR)->ready_at_us = 0;
+    g_es8311.begin(wire);
+    host::I2CStats s0 = wire.stats();
+    uint64_t t0 = host::nowMicros();
+    es8311SetAdcHpf(true);
+    es8311SetAdcVolumeDb(6.0f);
+    es8311SetDacVolumeDb(es8311VolumeDb((uint8_t)(volume * 255)));
+    printf("es8311 setup: %u I2C transactions, %.0f us bus time (once, not per block)\n",
+           wire.stats().transactions - s0.transactions, (double)(host::nowMicros() - t0));
+  }
+}
+
+BENCH_REGISTER("offload", "gain/HPF CPU cost: software per block vs ES8311 hardware (one-time I2C setup)", benchOffload);
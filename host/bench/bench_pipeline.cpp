@@ -0,0 +1,215 @@
+/**
+ * @file bench_pipeline.cpp
+ * @brief 编译期组合流水线（fused_pipeline.h）与运行时 Print 链的吞吐量对比
+ *
+ * 处理：I2S 32 位单声道 → 直流去除 → 增益 +6 dB → 打包 24 位 → 输出
+ *  - fused：Pipeline<I2SRx, DcBlock, Gain, Pack24, PrintSink>，每块一个循环
+ *  - chain：与 AudioTools 相同的结构，每级一个 Print，逐级虚函数调用、各自遍历一遍缓冲区（--chunk 字节）
+ * 输出每采样周期数、每块周期数与占实时的比例，以及两条路径输出的字节数与校验和
+ * （逐字节相同的检查在 test/test_fused_pipeline）。
+ *
+ * 参数：--chunk 运行时链每次传递的字节数（默认 512）、--reps 重复次数（默认 5，取最小值）
+ */
+#include "bench.h"
+
+#include "fused_pipeline.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  //===========================================================
+  // 输入：循环输出一段合成信号（正弦 + 直流偏移）
+  //===========================================================
+  class ToneStream : public Stream
+  {
+  public:
+    ToneStream()
+    {
+      table_.resize(16000 * 4);
+      for (size_t i = 0; i < 16000; i++)
+      {
+        int32_t v = (int32_t)(sin(2.0 * M_PI * 440.0 * i / 16000.0) * 1.2e9) + 150000000;
+        memcpy(&table_[i * 4], &v, 4);
+      }
+    }
+
+    size_t readBytes(uint8_t *data, size_t len) override
+    {
+      for (size_t done = 0; done < len;)
+      {
+        size_t n = std::min(len - done, table_.size() - pos_);
+        memcpy(data + done, &table_[pos_], n);
+        done += n;
+        pos_ = (pos_ + n) % table_.size();
+      }
+      return len;
+    }
+    size_t write(const uint8_t *, size_t len) override { return len; }
+
+  private:
+    std::vector<uint8_t> table_;
+    size_t pos_ = 0;
+  };
+
+  //===========================================================
+  // 输出：保存全部字节（预先分配，计时结束后再算校验和，避免输出端的开销掩盖差别）
+  //===========================================================
+  class CapturePrint : public Print
+  {
+  public:
+    explicit CapturePrint(size_t reserve) { data_.reserve(reserve); }
+
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      data_.insert(data_.end(), data, data + len);
+      return len;
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+    // FNV-1a
+    uint32_t hash() const
+    {
+      uint32_t h = 2166136261u;
+      for (uint8_t b : data_)
+        h = (h ^ b) * 16777619u;
+      return h;
+    }
+    uint64_t bytes() const { return data_.size(); }
+
+  private:
+    std::vector<uint8_t> data_;
+  };
+
+  //===========================================================
+  // 运行时链：每级一个 Print，处理后传给下一级（与 AudioTools 的 Stream 链相同的结构）
+  //===========================================================
+  template <class Stage>
+  class StagePrint : public Print
+  {
+  public:
+    explicit StagePrint(Print &next, Stage stage = Stage()) : next_(&next), stage_(stage) {}
+
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      size_t n = len / 4;
+      for (size_t i = 0; i < n; i++)
+      {
+        int32_t v;
+        memcpy(&v, data + i * 4, 4);
+        v = stage_.process(v);
+        memcpy(&buf_[i * 4], &v, 4);
+      }
+      return next_->write(buf_, n * 4);
+    }
+
+  private:
+    Print *next_;
+    Stage stage_;
+    uint8_t buf_[4096];
+  };
+
+  template <class Pack>
+  class PackPrint : public Print
+  {
+  public:
+    explicit PackPrint(Print &next) : next_(&next) {}
+
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      uint8_t *o = buf_;
+      for (size_t i = 0; i < len / 4; i++)
+      {
+        int32_t v;
+        memcpy(&v, data + i * 4, 4);
+        o = Pack::put(o, v);
+      }
+      next_->write(buf_, (size_t)(o - buf_));
+      return len;
+    }
+
+  private:
+    Print *next_;
+    uint8_t buf_[4096];
+  };
+
+  struct Result
+  {
+    double cycles_per_sample = 0;
+    uint32_t hash = 0;
+    uint64_t bytes = 0;
+  };
+
+  Result runFused(size_t samples)
+  {
+    ToneStream src;
+    CapturePrint out(samples * Pack24::kBytes);
+    Pipeline<I2SRx, DcBlock, Gain, Pack24, PrintSink> fused(I2SRx(src), DcBlock(), Gain(6.0f), Pack24(),
+                                                            PrintSink(out));
+    uint64_t c0 = bench::cycles();
+    size_t done = fused.run(samples);
+    uint64_t c1 = bench::cycles();
+    return {(double)(c1 - c0) / (double)done, out.hash(), out.bytes()};
+  }
+
+  Result runChain(size_t samples, size_t chunk)
+  {
+    ToneStream src;
+    CapturePrint out(samples * Pack24::kBytes);
+    PackPrint<Pack24> pack(out);
+    StagePrint<Gain> gain(pack, Gain(6.0f));
+    StagePrint<DcBlock> dc(gain);
+    Print *head = &dc;
+    std::vector<uint8_t> buf(chunk);
+    size_t done = 0;
+    uint64_t c0 = bench::cycles();
+    while (done < samples)
+    {
+      size_t n = src.readBytes(buf.data(), std::min(chunk, (samples - done) * 4));
+      head->write(buf.data(), n);
+      done += n / 4;
+    }
+    uint64_t c1 = bench::cycles();
+    return {(double)(c1 - c0) / (double)done, out.hash(), out.bytes()};
+  }
+
+  void benchPipeline(const bench::Args &args)
+  {
+    size_t chunk = (size_t)args.option("chunk", 512) & ~(size_t)3;
+    if (chunk < 4 || chunk > 4096)
+      chunk = 512;
+    int reps = (int)args.option("reps", 5);
+    // 整块，两条路径处理相同的采样数
+    size_t samples = ((size_t)(args.seconds * 16000) + FUSED_BLOCK_SAMPLES - 1) / FUSED_BLOCK_SAMPLES * FUSED_BLOCK_SAMPLES;
+    double block_us = (double)FUSED_BLOCK_SAMPLES / 16000.0 * 1e6;
+
+    // 交替运行，取每条路径的最小值
+    Result best[2];
+    for (int r = 0; r < (reps < 1 ? 1 : reps); r++)
+    {
+      Result rs[2] = {runFused(samples), runChain(samples, chunk)};
+      for (int i = 0; i < 2; i++)
+      {
+        if (!r || rs[i].cycles_per_sample < best[i].cycles_per_sample)
+          best[i] = rs[i];
+      }
+    }
+
+    printf("%.0f s of 16 kHz 32-bit mono, dc block + gain + pack 24 bit, chain chunk %zu B, best of %d\n",
+           args.seconds, chunk, reps);
+    printf("%-8s %14s %16s %12s %12s\n", "path", "cycles/sample", "cycles/block", "realtime", "output");
+    const char *names[] = {"fused", "chain"};
+    for (int i = 0; i < 2; i++)
+    {
+      double per_block = best[i].cycles_per_sample * FUSED_BLOCK_SAMPLES;
+      // 按 240 MHz 折算实时占比（主机周期只作相对比较）
+      printf("%-8s %14.2f %16.0f %11.3f%% %8llu B %08x\n", names[i], best[i].cycles_per_sample, per_block,
+             per_block / 240.0 / block_us * 100.0, (unsigned long long)best[i].bytes, best[i].hash);
+    }
+    printf("fused / chain: %.2fx\n", best[1].cycles_per_sample / best[0].cycles_per_sample);
+  }
+}
+
+BENCH_REGISTER("pipeline", "compile-time fused block pipeline vs runtime Print chain: cycles/sample",
+               benchPipeline);
@@ -0,0 +1,132 @@
+/**
+ * @file bench_power.cpp
+ * @brief 电源管理：不同调频策略下的截止时间与估算电流
+ *
+ *  - 负载模型：空闲（--idle 比例）之后播放，storage 每块解码 --base-us（240 MHz 下），
+ *    以 --burst-prob 的概率进入 --burst-blocks 块的重负载 --burst-us；DMA 可吸收 --dma-ms 的累计延迟
+ *  - 策略：固定 240 MHz / 固定 80 MHz / 只在播放时 240 MHz / PmGovernor 按负载升频
+ *    输出超过块时长的块数、DMA 溢出次数、估算平均电流
+ *  - 空闲：固件的 I2S 通道一直运行，空闲时在 80 MHz 等待；--idle-sleep 1 估算空闲时停止 I2S、浅睡眠的情况
+ * PmGovernor 与电流估算本身由 test/test_power_manager 检查。
+ *
+ * 参数：--idle 0.5、--idle-sleep 0、--base-us 800、--burst-us 4000、--burst-prob 0.005、--burst-blocks 40、--dma-ms 40
+ */
+#include "bench.h"
+
+#include "power_manager.h"
+
+namespace
+{
+  const uint32_t kBlockUs = 8000; // 512 字节，16 kHz 32 位单声道
+
+  enum class Strategy
+  {
+    Fixed240,
+    Fixed80,
+    StreamOnly,
+    Governor
+  };
+
+  struct Load
+  {
+    double seconds;
+    double idle;
+    bool idle_sleep;
+    uint32_t base_us;
+    uint32_t burst_us;
+    double burst_prob;
+    uint32_t burst_blocks;
+    uint32_t dma_us;
+  };
+
+  struct Outcome
+  {
+    PmTimes times;
+    uint32_t late;
+    uint32_t overruns;
+    uint32_t boosts;
+    uint32_t max_backlog_us;
+    uint32_t ua;
+  };
+
+  Outcome simulate(Strategy s, const Load &load)
+  {
+    Outcome o{};
+    uint64_t total = (uint64_t)(load.seconds * 1e6);
+    uint64_t idle = (uint64_t)(total * load.idle);
+    size_t blocks = (size_t)((total - idle) / kBlockUs);
+    o.times.total_us = total;
+    o.times.stream_us = (uint64_t)blocks * kBlockUs;
+    o.times.sleep_us = load.idle_sleep ? total - o.times.stream_us : 0;
+
+    PmGovernor g;
+    uint32_t seed = 2024;
+    uint32_t burst_left = 0;
+    uint64_t backlog = 0;
+    for (size_t i = 0; i < blocks; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      if (!burst_left && (double)(seed >> 8) / (double)(1u << 24) < load.burst_prob)
+        burst_left = load.burst_blocks;
+      uint32_t cycles_us = burst_left ? load.burst_us : load.base_us; // 240 MHz 下的处理时间
+      if (burst_left)
+        burst_left--;
+
+      uint32_t mhz = s == Strategy::Fixed80 ? PM_MIN_MHZ
+                     : s == Strategy::Governor ? (g.boost() ? PM_MAX_MHZ : PM_MIN_MHZ)
+                                               : PM_MAX_MHZ;
+      uint32_t work = (uint32_t)((uint64_t)cycles_us * PM_MAX_MHZ / mhz);
+      if (mhz >= PM_MAX_MHZ)
+        o.times.work_max_us += work;
+      else
+        o.times.work_min_us += work;
+      if (s == Strategy::Governor)
+        g.update(work, mhz, kBlockUs);
+
+      if (work > kBlockUs)
+        o.late++;
+      backlog = backlog + work > kBlockUs ? backlog + work - kBlockUs : 0;
+      o.max_backlog_us = backlog > o.max_backlog_us ? (uint32_t)backlog : o.max_backlog_us;
+      if (backlog > load.dma_us)
+      {
+        o.overruns++; // DMA 环被覆盖 / 播放饥饿，之后重新同步
+        backlog = 0;
+      }
+    }
+    o.boosts = g.boosts();
+    PmMode mode = s == Strategy::Fixed240 ? PmMode::Off : s == Strategy::StreamOnly ? PmMode::Stream : PmMode::Dfs;
+    o.ua = pmEstimateUa(o.times, mode);
+    return o;
+  }
+
+  void benchPower(const bench::Args &args)
+  {
+    Load load;
+    load.seconds = args.seconds;
+    load.idle = args.option("idle", 0.5);
+    load.idle_sleep = args.option("idle-sleep", 0) != 0;
+    load.base_us = (uint32_t)args.option("base-us", 800);
+    load.burst_us = (uint32_t)args.option("burst-us", 4000);
+    load.burst_prob = args.option("burst-prob", 0.005);
+    load.burst_blocks = (uint32_t)args.option("burst-blocks", 40);
+    load.dma_us = (uint32_t)(args.option("dma-ms", 40) * 1000);
+
+    printf("%.0f s, %.0f%% idle (%s), playback work %lu us / block (bursts %lu us) at %d MHz, 8 ms blocks, "
+           "DMA slack %lu ms\n",
+           load.seconds, load.idle * 100, load.idle_sleep ? "light sleep" : "I2S running", (unsigned long)load.base_us,
+           (unsigned long)load.burst_us, PM_MAX_MHZ, (unsigned long)(load.dma_us / 1000));
+    printf("%-22s %8s %10s %12s %8s %10s\n", "strategy", "late", "overruns", "backlog ms", "boosts", "est mA");
+    const char *names[] = {"fixed 240 MHz", "fixed 80 MHz", "240 MHz while playing", "load-aware (governor)"};
+    Outcome out[4];
+    for (int i = 0; i < 4; i++)
+    {
+      out[i] = simulate((Strategy)i, load);
+      printf("%-22s %8lu %10lu %12.1f %8lu %10.2f\n", names[i], (unsigned long)out[i].late,
+             (unsigned long)out[i].overruns, out[i].max_backlog_us / 1000.0, (unsigned long)out[i].boosts,
+             out[i].ua / 1000.0);
+    }
+  }
+}
+
+BENCH_REGISTER("power", "PM scaling strategies: deadlines and estimated current under a playback load model",
+               benchPower);
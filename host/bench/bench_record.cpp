@@ -0,0 +1,188 @@
+/**
+ * @file bench_record.cpp
+ * @brief 录音采集流程基准：块池 → I2S 读取 → 对齐 → InputDsp → BlockFanout → WAV 编码器 → 文件
+ *
+ * 逐块使用与固件 audio 任务相同的 readBlock()、InputDsp<T>（高通与 +6 dB 增益都打开，
+ * 即编解码器不可用时的软件退路）与 BlockFanout（录音队列 + 电平表），随后在同一线程中
+ * 取出队列写入编码器。storage 任务的调度与 PSRAM 写入批次不在测量范围内（编码器逐块写入）。
+ * I2S 为合成正弦波源且不按采样率计时，对不同的块大小（固件为 AUDIO_DMA_BLOCK_SIZE）与采样格式输出：
+ *  - MB/s（编码输出字节 / 墙钟时间，倍数为相对实时的速度）
+ *  - 每块各阶段的周期数（读取 / 对齐 / 软件处理 / 分发 / 编码 / 文件写入）
+ *  - 运行期间的分配次数与峰值堆占用、进程最大常驻内存
+ */
+#include "bench.h"
+
+#include "AudioTools.h"
+#include "block_fanout.h"
+#include "input_dsp.h"
+#include "record_pipeline.h"
+
+namespace
+{
+  //===========================================================
+  // 阶段计时
+  //===========================================================
+  // 前三项与 RecordStage 相同
+  enum Stage
+  {
+    StageRead,
+    StageAlign,
+    StageEncode,
+    StageDsp,
+    StageFanout,
+    StageSink,
+    StageCount
+  };
+
+  struct StageTimes
+  {
+    uint64_t start[StageCount];
+    uint64_t total[StageCount];
+    uint64_t count[StageCount];
+  };
+
+  StageTimes s_times;
+
+  struct CycleProbe
+  {
+    static inline void begin(RecordStage stage) { s_times.start[(int)stage] = bench::cycles(); }
+    static inline void end(RecordStage stage)
+    {
+      s_times.total[(int)stage] += bench::cycles() - s_times.start[(int)stage];
+      s_times.count[(int)stage]++;
+    }
+  };
+
+  /**
+   * @brief 文件输出包装：单独统计文件写入阶段
+   */
+  class TimedSink : public Print
+  {
+  public:
+    explicit TimedSink(Print &out) : out_(&out) {}
+    using Print::write;
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      uint64_t t0 = bench::cycles();
+      size_t n = out_->write(data, len);
+      s_times.total[StageSink] += bench::cycles() - t0;
+      s_times.count[StageSink]++;
+      return n;
+    }
+
+  private:
+    Print *out_;
+  };
+
+  struct Format
+  {
+    const char *name;
+    int bits;
+    size_t bytes_per_sample;
+  };
+
+  template <class T>
+  void runOne(const bench::Args &args, const Format &fmt, size_t block_len)
+  {
+    const int sample_rate = 16000;
+    const uint16_t block_count = 4;
+    static DriverPins pins;
+    AudioBoard board(AudioDriverES8311, pins);
+    I2SCodecStream i2s(&board);
+    auto cfg = i2s.defaultConfig(RX_MODE);
+    cfg.copyFrom(AudioInfo(sample_rate, 1, fmt.bits));
+    i2s.begin(cfg);
+
+    File file = SD.open("/bench_rec.wav", FILE_WRITE);
+    TimedSink sink(file);
+    WAVEncoder encoder;
+    encoder.begin(AudioInfo(sample_rate, 1, fmt.bits));
+    encoder.setOutput(sink);
+
+    // 与固件相同的各级对象，块大小按本次测量设置
+    std::vector<uint8_t> memory((size_t)block_len * block_count);
+    std::vector<AudioBlock> descriptors(block_count);
+    BlockPool pool;
+    pool.init(memory.data(), descriptors.data(), block_count, (uint32_t)block_len);
+    InputDsp<T> dsp;
+    dsp.setHpf(true);
+    dsp.setGainDb(6.0f);
+    BlockQueueSink<block_count> queue;
+    LevelMeterSink meter((uint8_t)fmt.bytes_per_sample);
+    EncoderSink encoder_sink(encoder);
+    BlockFanout fanout;
+    fanout.add(queue);
+    fanout.add(meter);
+
+    size_t total_samples = (size_t)(args.seconds * sample_rate);
+    size_t samples = 0;
+
+    s_times = StageTimes();
+    bench::resetAllocPeak();
+    bench::AllocStats before = bench::allocStats();
+    double t0 = bench::wallSeconds();
+
+    while (samples < total_samples)
+    {
+      AudioBlock *block = pool.acquire();
+      if (!readBlock<CycleProbe>(i2s, block, fmt.bytes_per_sample)) // 数据不足，继续读取
+      {
+        releaseAudioBlock(block);
+        continue;
+      }
+      samples += block->length / fmt.bytes_per_sample;
+
+      uint64_t t = bench::cycles();
+      dsp.process(block);
+      s_times.total[StageDsp] += bench::cycles() - t;
+
+      t = bench::cycles();
+      fanout.dispatch(block);
+      s_times.total[StageFanout] += bench::cycles() - t;
+
+      while (AudioBlock *queued = queue.pop())
+      {
+        CycleProbe::begin(RecordStage::Encode);
+        encoder_sink.push(queued);
+        CycleProbe::end(RecordStage::Encode);
+      }
+    }
+    encoder.end();
+    file.close();
+
+    double elapsed = bench::wallSeconds() - t0;
+    bench::AllocStats after = bench::allocStats();
+    double bytes = (double)samples * fmt.bytes_per_sample;
+    uint64_t blocks = s_times.count[StageRead] ? s_times.count[StageRead] : 1;
+    uint64_t encode = s_times.total[StageEncode] - s_times.total[StageSink];
+
+    printf("%-6s %6zu %9.1f %8.0fx %9llu %9llu %9llu %9llu %9llu %9llu %7llu %9llu\n", fmt.name, block_len,
+           bytes / elapsed / 1e6, args.seconds / elapsed, (unsigned long long)(s_times.total[StageRead] / blocks),
+           (unsigned long long)(s_times.total[StageAlign] / blocks),
+           (unsigned long long)(s_times.total[StageDsp] / blocks),
+           (unsigned long long)(s_times.total[StageFanout] / blocks), (unsigned long long)(encode / blocks),
+           (unsigned long long)(s_times.total[StageSink] / blocks),
+           (unsigned long long)(after.allocations - before.allocations),
+           (unsigned long long)(after.peak_bytes - before.live_bytes));
+  }
+
+  void benchRecord(const bench::Args &args)
+  {
+    static const Format formats[] = {
+        {"s16", 16, 2},
+        {"s24", 24, 4},
+        {"s32", 32, 4},
+    };
+    static const size_t block_lengths[] = {128, 256, 512, 1024, 2048, 4096};
+
+    printf("%-6s %6s %9s %9s %9s %9s %9s %9s %9s %9s %7s %9s\n", "format", "block", "MB/s", "realtime",
+           "read/blk", "align/blk", "dsp/blk", "fan/blk", "enc/blk", "sink/blk", "allocs", "peak(B)");
+    for (auto &fmt : formats)
+      for (size_t len : block_lengths)
+        fmt.bytes_per_sample == 2 ? runOne<int16_t>(args, fmt, len) : runOne<int32_t>(args, fmt, len);
+    printf("max rss: %ld KB\n", bench::maxRssKb());
+  }
+}
+
+BENCH_REGISTER("record", "block pool -> I2S read -> align -> InputDsp -> fanout -> WAVEncoder -> file, per block size and format",
+               benchRecord);
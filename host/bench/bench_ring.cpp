@@ -0,0 +1,159 @@
+/**
+ * @file bench_ring.cpp
+ * @brief 环形缓冲区基准（ring_buffer.h）
+ *
+ * ring：
+ *  - 单线程：push/pop 逐个、write/read 批量复制、writeSpan/readSpan 原地读写，每元素周期数
+ *  - 双线程 SPSC：生产者 / 消费者各一个线程，每秒元素数
+ *  - MPSC：1 到 4 个生产者线程，每秒元素数
+ *
+ * 顺序与内容的检查（含多线程）在 test/test_ring_buffer，ThreadSanitizer 下运行：
+ * pio test -e native_tsan -f test_ring_buffer
+ *
+ * 参数：--items 每项元素数（默认 1e7）
+ */
+#include "bench.h"
+
+#include "ring_buffer.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  constexpr size_t RING_SIZE = 1024;
+  constexpr size_t BATCH = 128;
+
+  volatile uint32_t s_sink; // 防止读取被优化掉
+
+  template <class Fn>
+  double cyclesPerItem(size_t items, Fn &&fn)
+  {
+    uint64_t c0 = bench::cycles();
+    fn();
+    return (double)(bench::cycles() - c0) / (double)items;
+  }
+
+  //===========================================================
+  // ring
+  //===========================================================
+  void benchRing(const bench::Args &args)
+  {
+    size_t items = (size_t)args.option("items", 1e7);
+    static SpscRing<uint32_t, RING_SIZE> ring;
+    uint32_t buf[BATCH];
+
+    printf("ring %zu x uint32_t, %zu items per run\n", RING_SIZE, items);
+    printf("%-24s %14s\n", "single thread", "cycles/item");
+
+    double one = cyclesPerItem(items,
+                               [&]
+                               {
+                                 uint32_t v = 0;
+                                 for (size_t i = 0; i < items; i++)
+                                 {
+                                   ring.push((uint32_t)i);
+                                   ring.pop(v);
+                                 }
+                                 s_sink = v;
+                               });
+    printf("%-24s %14.2f\n", "push/pop", one);
+
+    double bulk = cyclesPerItem(items,
+                                [&]
+                                {
+                                  for (size_t i = 0; i < items; i += BATCH)
+                                  {
+                                    for (size_t k = 0; k < BATCH; k++)
+                                      buf[k] = (uint32_t)(i + k);
+                                    ring.write(buf, BATCH);
+                                    ring.read(buf, BATCH);
+                                  }
+                                  s_sink = buf[0];
+                                });
+    printf("%-24s %14.2f\n", "write/read (copy)", bulk);
+
+    double span = cyclesPerItem(items,
+                                [&]
+                                {
+                                  size_t done = 0;
+                                  while (done < items)
+                                  {
+                                    RingSpan<uint32_t> w = ring.writeSpan(BATCH);
+                                    for (size_t k = 0; k < w.count; k++)
+                                      w.data[k] = (uint32_t)(done + k);
+                                    ring.commitWrite(w.count);
+                                    RingSpan<const uint32_t> r = ring.readSpan(BATCH);
+                                    uint32_t sum = 0;
+                                    for (size_t k = 0; k < r.count; k++)
+                                      sum += r.data[k];
+                                    ring.commitRead(r.count);
+                                    s_sink = sum;
+                                    done += r.count;
+                                  }
+                                });
+    printf("%-24s %14.2f\n", "writeSpan/readSpan", span);
+
+    // 双线程 SPSC
+    double w0 = bench::wallSeconds();
+    std::thread producer(
+        [&]
+        {
+          size_t i = 0;
+          while (i < items)
+          {
+            RingSpan<uint32_t> w = ring.writeSpan(BATCH);
+            for (size_t k = 0; k < w.count; k++)
+              w.data[k] = (uint32_t)(i + k);
+            ring.commitWrite(w.count);
+            i += w.count;
+            if (!w.count)
+              std::this_thread::yield();
+          }
+        });
+    size_t got = 0;
+    while (got < items)
+    {
+      RingSpan<const uint32_t> r = ring.readSpan(BATCH);
+      ring.commitRead(r.count);
+      got += r.count;
+      if (!r.count)
+        std::this_thread::yield();
+    }
+    producer.join();
+    printf("%-24s %11.1f M/s\n", "spsc 2 threads", (double)items / (bench::wallSeconds() - w0) / 1e6);
+
+    // MPSC
+    static MpscRing<uint32_t, RING_SIZE> mpsc;
+    for (int producers = 1; producers <= 4; producers++)
+    {
+      size_t per = items / (size_t)producers;
+      double t0 = bench::wallSeconds();
+      std::vector<std::thread> threads;
+      for (int p = 0; p < producers; p++)
+        threads.emplace_back(
+            [&, p]
+            {
+              for (size_t i = 0; i < per; i++)
+                while (!mpsc.push((uint32_t)(i + (size_t)p)))
+                  std::this_thread::yield();
+            });
+      size_t total = per * (size_t)producers;
+      size_t n = 0;
+      while (n < total)
+      {
+        RingSpan<const uint32_t> r = mpsc.readSpan(BATCH);
+        mpsc.commitRead(r.count);
+        n += r.count;
+        if (!r.count)
+          std::this_thread::yield();
+      }
+      for (auto &t : threads)
+        t.join();
+      printf("mpsc %d producer(s)%*s %11.1f M/s\n", producers, 5, "", (double)total / (bench::wallSeconds() - t0) / 1e6);
+    }
+  }
+}
+
+BENCH_REGISTER("ring", "SPSC/MPSC ring: per-item cycles for push/pop, bulk copy and spans; threaded throughput", benchRing);
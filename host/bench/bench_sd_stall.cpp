@@ -0,0 +1,173 @@
+/**
+ * @file bench_sd_stall.cpp
+ * @brief SD 卡停顿压力场景：录音 / 播放需要多大的环形缓冲区才能不丢音
+ *
+ * 在启用故障注入的 SD 模拟上（见 sd_faults.h）按虚拟时间运行：
+ *  - 录音：I2S 每个缓冲区周期产生一个块，SD 写入（含停顿、部分写入重试）消费；
+ *          每次写入完成时，尚未写出的块数 + 正在写的块 = 该时刻所需的环形缓冲区
+ *  - 播放：SD 按需读取（落后时连续追赶），I2S 每个周期消费一个块；
+ *          块的读取完成时间落后于其播放时间的量 = 所需的预读深度
+ * 输出各分位（p50 ... max）下保证不丢音所需的缓冲块数与字节数。
+ *
+ * 参数：--block 字节（默认 512）--byte-rate 字节/秒（默认 16k*32bit 单声道 = 64000）
+ *       --stall-prob P --read-stall-prob P --stall-ms MIN --stall-max-ms MAX --short-prob P --seed N --percentile P
+ */
+#include "bench.h"
+
+#include "AudioTools.h"
+#include "sd_faults.h"
+
+#include <algorithm>
+
+namespace
+{
+  struct Scenario
+  {
+    size_t block_bytes;
+    double period_us; // 一个块对应的音频时长
+    size_t blocks;
+  };
+
+  uint32_t percentileOf(std::vector<uint32_t> v, double p)
+  {
+    if (v.empty())
+      return 0;
+    std::sort(v.begin(), v.end());
+    size_t idx = (size_t)std::min((double)v.size() - 1, p / 100.0 * (double)(v.size() - 1) + 0.5);
+    return v[idx];
+  }
+
+  /**
+   * @brief 录音：返回每次写入完成时所需的缓冲块数
+   */
+  std::vector<uint32_t> simulateCapture(const Scenario &sc)
+  {
+    std::vector<uint8_t> block(sc.block_bytes, 0x5A);
+    std::vector<uint32_t> need;
+    need.reserve(sc.blocks);
+
+    File file = SD.open("/stall_rec.pcm", FILE_WRITE);
+    uint64_t t0 = host::nowMicros();
+    for (size_t c = 0; c < sc.blocks; c++)
+    {
+      // 第 c 块在 (c + 1) 个周期末才由 I2S 产生
+      double ready = (double)(c + 1) * sc.period_us;
+      double now = (double)(host::nowMicros() - t0);
+      if (now < ready)
+        host::advanceMicros((uint64_t)(ready - now));
+
+      // 部分写入时继续写剩余部分
+      size_t done = 0;
+      while (done < sc.block_bytes)
+        done += file.write(block.data() + done, sc.block_bytes - done);
+
+      uint64_t produced = (uint64_t)((double)(host::nowMicros() - t0) / sc.period_us);
+      need.push_back((uint32_t)(produced > c ? produced - c : 1));
+    }
+    file.close();
+    return need;
+  }
+
+  /**
+   * @brief 播放：返回每个块所需的预读块数
+   *
+   * 读取方只在块的名义时刻（k 个周期）开始读第 k 块，落后时连续读取追赶；
+   * 第 k 块需在 (k + 1) 个周期前就绪，超出的时间折算为额外的预读块数。
+   */
+  std::vector<uint32_t> simulatePlayback(const Scenario &sc)
+  {
+    std::vector<uint8_t> block(sc.block_bytes);
+    std::vector<uint32_t> need;
+    need.reserve(sc.blocks);
+
+    File file = SD.open("/stall_play.pcm", FILE_READ);
+    uint64_t t0 = host::nowMicros();
+    for (size_t k = 0; k < sc.blocks; k++)
+    {
+      double start = (double)k * sc.period_us;
+      double now = (double)(host::nowMicros() - t0);
+      if (now < start)
+        host::advanceMicros((uint64_t)(start - now));
+
+      file.read(block.data(), sc.block_bytes);
+      double lag = (double)(host::nowMicros() - t0) - (double)(k + 1) * sc.period_us;
+      need.push_back(lag > 0 ? (uint32_t)(lag / sc.period_us) + 2 : 1);
+    }
+    file.close();
+    return need;
+  }
+
+  void benchSdStall(const bench::Args &args)
+  {
+    Scenario sc;
+    sc.block_bytes = (size_t)args.option("block", 512);
+    double byte_rate = args.option("byte-rate", 16000 * 4);
+    sc.period_us = (double)sc.block_bytes * 1e6 / byte_rate;
+    sc.blocks = (size_t)(args.seconds * byte_rate / (double)sc.block_bytes);
+
+    host::SdFaultConfig cfg;
+    cfg.seed = (uint32_t)args.option("seed", 1);
+    cfg.stall_probability = args.option("stall-prob", cfg.stall_probability);
+    cfg.read_stall_probability = args.option("read-stall-prob", cfg.read_stall_probability);
+    cfg.stall_min_us = (uint32_t)(args.option("stall-ms", cfg.stall_min_us / 1000.0) * 1000);
+    cfg.stall_max_us = (uint32_t)(args.option("stall-max-ms", cfg.stall_max_us / 1000.0) * 1000);
+    cfg.stall_max_us = std::max(cfg.stall_max_us, cfg.stall_min_us);
+    cfg.short_write_probability = args.option("short-prob", 0.01);
+
+    // 播放用的源文件在无故障时生成
+    host::disableSdFaults(SD);
+    {
+      File f = SD.open("/stall_play.pcm", FILE_WRITE);
+      std::vector<uint8_t> zero(sc.block_bytes);
+      for (size_t i = 0; i < sc.blocks; i++)
+        f.write(zero.data(), zero.size());
+      f.close();
+    }
+
+    printf("block %zu B, period %.2f ms, %zu blocks, stall p=%.4f (read %.4f) %u..%u ms, short-write p=%.3f\n",
+           sc.block_bytes, sc.period_us / 1000.0, sc.blocks, cfg.stall_probability, cfg.read_stall_probability,
+           cfg.stall_min_us / 1000, cfg.stall_max_us / 1000, cfg.short_write_probability);
+
+    host::enableSdFaults(SD, cfg);
+    std::vector<uint32_t> capture = simulateCapture(sc);
+    host::SdFaultStats write_stats = host::sdFaultStats();
+
+    host::enableSdFaults(SD, cfg);
+    std::vector<uint32_t> playback = simulatePlayback(sc);
+    host::SdFaultStats read_stats = host::sdFaultStats();
+    host::disableSdFaults(SD);
+
+    static const double percentiles[] = {50, 90, 99, 99.9, 100};
+    printf("%-10s", "pipeline");
+    for (double p : percentiles)
+      printf(" %16s", p >= 100 ? "max" : (std::string("p") + std::to_string(p).substr(0, p == 99.9 ? 4 : 2)).c_str());
+    printf("\n");
+    for (int i = 0; i < 2; i++)
+    {
+      const std::vector<uint32_t> &v = i == 0 ? capture : playback;
+      printf("%-10s", i == 0 ? "capture" : "playback");
+      for (double p : percentiles)
+      {
+        uint32_t blocks = percentileOf(v, p);
+        printf(" %5u blk %6.1fKB", blocks, blocks * sc.block_bytes / 1024.0);
+      }
+      printf("\n");
+    }
+
+    if (args.options.count("percentile"))
+    {
+      double p = args.option("percentile", 99);
+      uint32_t c = percentileOf(capture, p), r = percentileOf(playback, p);
+      printf("at p%g: capture ring %u blocks (%zu B), playback prefetch %u blocks (%zu B)\n", p, c,
+             c * sc.block_bytes, r, r * sc.block_bytes);
+    }
+
+    printf("sd writes %u (stalls %u, short %u, worst %.1f ms), reads %u (stalls %u, worst %.1f ms)\n",
+           write_stats.writes, write_stats.stalls, write_stats.short_writes,
+           percentileOf(write_stats.write_latency, 100) / 1000.0, read_stats.reads, read_stats.stalls,
+           percentileOf(read_stats.read_latency, 100) / 1000.0);
+  }
+}
+
+BENCH_REGISTER("sd_stall", "ring buffer needed by capture/playback to survive SD stalls, per percentile",
+               benchSdStall);
@@ -0,0 +1,8 @@
+"""
+clang.py - env:native_fuzz 的 extra_script：libFuzzer（-fsanitize=fuzzer）只有 clang 支持，
+编译与链接都换成 clang，链接时同样带上 sanitizer 选项
+"""
+Import("env")
+
+env.Replace(CC="clang", CXX="clang++", LINK="clang++")
+env.Append(LINKFLAGS=["-fsanitize=fuzzer,address"])
@@ -0,0 +1,128 @@
+/**
+ * @file fuzz_wav.cpp
+ * @brief libFuzzer 目标：WAV 头检查（parseWavHeader / probeWavFile）与 WAV 解码器
+ *
+ * 每个输入按播放前的顺序经过三步：
+ *  1. parseWavHeader：内存中解析，结果必须落在文件范围内
+ *  2. probeWavFile：写入模拟 SD 卡后按 audio_control 的 checkWavFile 读取检查，结果必须与 1 一致
+ *  3. WAVDecoder：按播放器的方式分块写入（块大小由输入决定），输出字节数不能超过输入
+ * 违反约束时 __builtin_trap()，内存错误由 AddressSanitizer 报告，死循环 / 过慢由 -timeout 报告。
+ * 主机上的 WAVDecoder 是 host/mock 的实现；MP3 解码在本项目中未启用，没有对应目标。
+ *
+ * 运行（需要 clang）：
+ *   pio run -e native_fuzz
+ *   .pio/build/native_fuzz/program -timeout=2 -max_len=4096 -rss_limit_mb=512 \
+ *       .pio/fuzz_corpus host/fuzz/corpus/wav test/test_golden/golden
+ * 第一个目录保存新发现的输入；host/fuzz/corpus/wav 由 host/fuzz/make_corpus.py 生成
+ * （截断、块长度越界、未回填长度等），test/test_golden/golden 为录音 / 播放输出。
+ * 重现崩溃：.pio/build/native_fuzz/program crash-<hash>
+ */
+#include "AudioTools.h"
+#include "SD.h"
+#include "wav_header.h"
+
+#include <filesystem>
+
+namespace
+{
+  /** @brief 解码器输出：只计数 */
+  class CountingPrint : public Print
+  {
+  public:
+    using Print::write;
+    size_t write(uint8_t) override
+    {
+      bytes++;
+      return 1;
+    }
+    size_t write(const uint8_t *, size_t len) override
+    {
+      bytes += len;
+      return len;
+    }
+
+    size_t bytes = 0;
+  };
+
+  const char *kFuzzFile = "/fuzz.wav";
+
+  void require(bool ok)
+  {
+    if (!ok)
+      __builtin_trap();
+  }
+
+  /** @brief 解析成功时 PCM 范围必须在文件内，格式字段在允许范围内 */
+  void checkFormat(WavError err, const WavFormat &fmt, size_t file_size)
+  {
+    if (err != WavError::None)
+      return;
+    require((uint64_t)fmt.data_offset + fmt.data_length <= file_size);
+    require(fmt.channels >= 1 && fmt.channels <= 8);
+    require(fmt.block_align >= fmt.channels * (fmt.bits_per_sample / 8));
+  }
+}
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***)
+{
+  // 模拟 SD 卡根目录放在临时目录，避免与 env:native 的 host_sd 混用
+  std::error_code ec;
+  std::filesystem::path root = std::filesystem::temp_directory_path(ec) / "es8311_fuzz_sd";
+  std::filesystem::create_directories(root, ec);
+  host::env().sd_root = root.string();
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+  //===========================================================
+  // 1. 内存解析：实际文件大小，以及 data 长度未回填 / 只读到开头的更大文件
+  //===========================================================
+  WavFormat fmt{};
+  WavError err = parseWavHeader(data, size, size, fmt);
+  checkFormat(err, fmt, size);
+
+  WavFormat big{};
+  size_t big_size = size + ((size_t)1 << 20);
+  checkFormat(parseWavHeader(data, size, big_size, big), big, big_size);
+
+  //===========================================================
+  // 2. 文件检查（与播放前的 checkWavFile 相同），只读取前 WAV_PROBE_HEADER_SIZE 字节
+  //===========================================================
+  File out = SD.open(kFuzzFile, FILE_WRITE);
+  require((bool)out);
+  require(out.write(data, size) == size);
+  out.close();
+
+  File in = SD.open(kFuzzFile);
+  require((bool)in);
+  WavFormat probed{};
+  WavError probe_err = probeWavFile(in, probed);
+  require(in.position() == 0);
+  in.close();
+
+  WavFormat prefix{};
+  size_t head = size < WAV_PROBE_HEADER_SIZE ? size : WAV_PROBE_HEADER_SIZE;
+  require(probe_err == parseWavHeader(data, head, size, prefix));
+  if (probe_err == WavError::None)
+    require(probed.data_offset == prefix.data_offset && probed.data_length == prefix.data_length);
+
+  //===========================================================
+  // 3. 解码器：对所有输入运行（覆盖解码器自身的检查），块大小 1..1021
+  //===========================================================
+  WAVDecoder decoder;
+  CountingPrint pcm;
+  decoder.setOutput(pcm);
+  decoder.begin();
+  size_t chunk = 1 + (size ? data[size - 1] : 0) * 4;
+  for (size_t pos = 0; pos < size; pos += chunk)
+  {
+    size_t n = size - pos < chunk ? size - pos : chunk;
+    require(decoder.write(data + pos, n) == n);
+  }
+  require(pcm.bytes <= size);
+  if (decoder.isHeaderValid())
+    require(pcm.bytes + 44 <= size); // RIFF + fmt（至少 16 字节）+ data 块头之后才是 PCM
+  decoder.end();
+  return 0;
+}
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+make_corpus.py - 生成 fuzz_wav 的种子语料（host/fuzz/corpus/wav）
+
+覆盖头检查的各个分支：正常的 16 / 32 位 PCM、EXTENSIBLE、奇数长度块的填充字节、
+未回填的 data 长度（录音中断）、截断的头部、长度越界 / 超大的块、缺少 fmt、非 PCM 编码。
+PCM 数据很短：语料只需要覆盖头部，-max_len 限制变异后的长度。
+
+用法：
+  python3 host/fuzz/make_corpus.py [输出目录]
+"""
+import os
+import struct
+import sys
+
+
+def chunk(tag, body, size=None):
+    n = len(body) if size is None else size
+    pad = b"\0" if len(body) & 1 else b""
+    return tag + struct.pack("<I", n) + body + pad
+
+
+def fmt_pcm(channels=1, rate=16000, bits=32, fmt=1, align=None, extra=b""):
+    align = channels * ((bits + 7) // 8) if align is None else align
+    return struct.pack("<HHIIHH", fmt, channels, rate, rate * align, align, bits) + extra
+
+
+def riff(*chunks, size=None):
+    body = b"WAVE" + b"".join(chunks)
+    return b"RIFF" + struct.pack("<I", len(body) if size is None else size) + body
+
+
+def pcm(n, width):
+    return bytes((i * 37) & 0xFF for i in range(n * width))
+
+
+def seeds():
+    yield "pcm32_mono", riff(chunk(b"fmt ", fmt_pcm()), chunk(b"data", pcm(32, 4)))
+    yield "pcm16_stereo_44k", riff(chunk(b"fmt ", fmt_pcm(2, 44100, 16)), chunk(b"data", pcm(32, 4)))
+    yield "pcm24_in_32", riff(chunk(b"fmt ", fmt_pcm(1, 48000, 24, align=4)), chunk(b"data", pcm(16, 4)))
+    yield "pcm8", riff(chunk(b"fmt ", fmt_pcm(1, 8000, 8)), chunk(b"data", pcm(64, 1)))
+    ext = struct.pack("<HHI", 22, 32, 4) + struct.pack("<H", 1) + b"\0\0\0\0\x10\0\x80\0\0\xaa\0\x38\x9b\x71"
+    yield "extensible", riff(chunk(b"fmt ", fmt_pcm(1, 16000, 32, fmt=0xFFFE, extra=ext)), chunk(b"data", pcm(8, 4)))
+    yield "odd_list_pad", riff(chunk(b"fmt ", fmt_pcm()), chunk(b"LIST", b"INFOabc"), chunk(b"data", pcm(8, 4)))
+    # 录音中断：WAVEncoder 写入的占位长度
+    yield "unpatched_len", riff(chunk(b"fmt ", fmt_pcm()), chunk(b"data", pcm(8, 4), size=0xFFFFFFFF - 36),
+                                size=0xFFFFFFFF)
+    yield "data_len_zero", riff(chunk(b"fmt ", fmt_pcm()), chunk(b"data", pcm(8, 4), size=0))
+    full = riff(chunk(b"fmt ", fmt_pcm()), chunk(b"data", pcm(8, 4)))
+    yield "truncated_in_fmt", full[:30]
+    yield "truncated_before_data", full[:44]
+    yield "truncated_riff", full[:10]
+    yield "oversized_list", riff(chunk(b"fmt ", fmt_pcm()), chunk(b"LIST", b"INFO", size=0xFFFFFFF0), chunk(b"data", pcm(8, 4)))
+    yield "oversized_fmt", riff(chunk(b"fmt ", fmt_pcm(), size=0x7FFFFFFF), chunk(b"data", pcm(8, 4)))
+    yield "data_before_fmt", riff(chunk(b"data", pcm(8, 4)), chunk(b"fmt ", fmt_pcm()))
+    yield "two_fmt", riff(chunk(b"fmt ", fmt_pcm()), chunk(b"fmt ", fmt_pcm(2)), chunk(b"data", pcm(8, 4)))
+    yield "not_pcm", riff(chunk(b"fmt ", fmt_pcm(fmt=3)), chunk(b"data", pcm(8, 4)))
+    yield "zero_channels", riff(chunk(b"fmt ", fmt_pcm(channels=0, align=4)), chunk(b"data", pcm(8, 4)))
+    yield "bad_align", riff(chunk(b"fmt ", fmt_pcm(align=1)), chunk(b"data", pcm(8, 4)))
+    yield "data_past_probe", riff(chunk(b"fmt ", fmt_pcm()), chunk(b"junk", b"\0" * 1100), chunk(b"data", pcm(8, 4)))
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(os.path.abspath(__file__)), "corpus", "wav")
+    os.makedirs(out, exist_ok=True)
+    for name, data in seeds():
+        with open(os.path.join(out, name + ".wav"), "wb") as f:
+            f.write(data)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,68 @@
+/**
+ * @file host_main.cpp
+ * @brief 主机（Linux）入口：在模拟硬件上运行 src/main.cpp 的 setup() / loop()
+ *
+ * 用法：
+ *   .pio/build/native/program [--sd DIR] [--spiffs DIR] [--rx FILE.pcm] [--tx FILE.pcm|FILE.wav]
+ *                             [--tone HZ] [--serial "cmd\n"] [--loops N] [--no-pace]
+ *                             [--sd-faults SEED] [--sd-stall-prob P] [--sd-short-prob P] [--adc-mv MV]
+ *
+ * --loops N 至少运行 N 次 loop()，之后继续运行直到命令队列为空且状态机空闲（录音 / 播放完成）。
+ * 所有 delay() 与 I2S 读写都只推进虚拟时钟，运行结果可复现；
+ * 主机上没有日志任务，每次 loop() 之后输出延迟日志；结束时打印虚拟耗时。
+ *
+ * pio test（PIO_UNIT_TESTING）时入口由 test/ 下的测试提供，这里不编译 main()。
+ */
+#include "Arduino.h"
+#include "AudioTools.h"
+#include "Wire.h"
+#include "sd_faults.h"
+#include "deferred_log.h"
+#include "audio_control.h"
+
+#include <filesystem>
+
+#ifndef PIO_UNIT_TESTING
+void setup();
+void loop();
+
+int main(int argc, char **argv)
+{
+  if (!host::parseArgs(argc, argv))
+    return 2;
+
+  host::Env &e = host::env();
+  std::error_code ec;
+  std::filesystem::create_directories(e.sd_root, ec);
+  std::filesystem::create_directories(e.spiffs_root, ec);
+
+  if (e.sd_faults)
+  {
+    host::SdFaultConfig cfg;
+    cfg.seed = e.sd_fault_seed;
+    cfg.stall_probability = e.sd_stall_probability;
+    cfg.short_write_probability = e.sd_short_write_probability;
+    host::enableSdFaults(SD, cfg);
+  }
+
+  setup();
+  deferredLogFlush(Serial);
+  uint64_t setup_us = host::nowMicros();
+  for (int i = 0; i < e.loops || !audioControlIdle(); i++)
+  {
+    loop();
+    deferredLogFlush(Serial);
+  }
+  host::finishAudio();
+
+  fflush(stdout);
+  fprintf(stderr, "[host] setup %.3f ms, total %.3f ms (virtual)\n", setup_us / 1000.0, host::nowMicros() / 1000.0);
+  if (e.sd_faults)
+  {
+    host::SdFaultStats &st = host::sdFaultStats();
+    fprintf(stderr, "[host] sd writes %u, reads %u, stalls %u, short writes %u, busy %.3f ms\n", st.writes, st.reads,
+            st.stalls, st.short_writes, st.busy_us / 1000.0);
+  }
+  return 0;
+}
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file Arduino.h
+ * @brief 主机模拟：Arduino 核心 API 的最小子集
+ *
+ * 只实现 src/ 中实际用到的接口，时间相关函数基于 host_env.h 的虚拟时钟。
+ */
+#pragma once
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <string>
+
+#include "host_env.h"
+
+//===========================================================
+// GPIO
+//===========================================================
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+//===========================================================
+// ADC
+//===========================================================
+uint32_t analogReadMilliVolts(uint8_t pin);
+
+//===========================================================
+// 时间（虚拟时钟）
+//===========================================================
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+//===========================================================
+// CPU
+//===========================================================
+#define HOST_CPU_MHZ 240 // 与 ESP32-S3 默认主频一致，用于把虚拟时间换算为周期数
+
+uint32_t getCpuFrequencyMhz();
+
+//===========================================================
+// FreeRTOS 最小子集（ESP32 Arduino.h 会间接包含）
+//===========================================================
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+#define portTICK_PERIOD_MS 1
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+void vTaskDelay(TickType_t ticks);
+
+//===========================================================
+// Print / Stream
+//===========================================================
+class Print
+{
+public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t c) { return write(&c, 1); }
+  virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+  virtual int availableForWrite() { return 1024; }
+  virtual void flush() {}
+
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+  size_t print(const char *str) { return write(str); }
+  size_t print(const std::string &str) { return write((const uint8_t *)str.data(), str.size()); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t println() { return write("\n"); }
+  size_t println(const char *str) { return print(str) + println(); }
+  size_t println(const std::string &str) { return print(str) + println(); }
+  size_t println(long v) { return print(v) + println(); }
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  virtual size_t readBytes(uint8_t *buffer, size_t length);
+  size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+  void setTimeout(unsigned long) {}
+};
+
+/**
+ * @brief 主机串口：输出到 stdout，输入来自预置字符串（Env::serial_input / feed()）
+ */
+class HardwareSerial : public Stream
+{
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void end() {}
+  using Print::write;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  int available() override;
+  int read() override;
+  int peek() override;
+  operator bool() const { return true; }
+
+  /** @brief 追加模拟串口输入 */
+  void feed(const std::string &data) { rx_ += data; }
+
+private:
+  std::string rx_;
+  size_t rx_pos_ = 0;
+};
+
+extern HardwareSerial Serial;
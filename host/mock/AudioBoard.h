@@ -0,0 +1,132 @@
+/**
+ * @file AudioBoard.h
+ * @brief 主机模拟：arduino-audio-driver 的 DriverPins / AudioBoard / ES8311 驱动
+ *
+ * ES8311 驱动通过模拟的 TwoWire 访问一个寄存器模型（地址 0x18），
+ * 初始化与音量调整按原驱动的“逐寄存器读-改-写”方式产生 I2C 事务。
+ */
+#pragma once
+
+#include "Arduino.h"
+#include "Wire.h"
+
+namespace audio_driver
+{
+  enum class PinFunction
+  {
+    UNDEFINED,
+    HEADPHONE_DETECT,
+    AUXIN_DETECT,
+    PA,
+    LED,
+    KEY,
+    SD,
+    CODEC,
+    CODEC_ADC,
+    MCLK_SOURCE,
+  };
+
+  enum class AudioDriverLogLevel
+  {
+    Debug,
+    Info,
+    Warning,
+    Error
+  };
+
+  class AudioDriverLoggerClass
+  {
+  public:
+    void begin(Print &out, AudioDriverLogLevel level)
+    {
+      out_ = &out;
+      level_ = level;
+    }
+
+  private:
+    Print *out_ = nullptr;
+    AudioDriverLogLevel level_ = AudioDriverLogLevel::Warning;
+  };
+
+  /**
+   * @brief 引脚定义（只保存 I2C / I2S 参数）
+   */
+  class DriverPins
+  {
+  public:
+    bool addI2C(PinFunction function, int scl, int sda, int port = -1, uint32_t frequency = 100000,
+                TwoWire &wire = Wire, bool active = true);
+    bool addI2S(PinFunction function, int mclk, int bck, int ws, int data_out, int data_in = -1, int port = 0);
+    bool begin();
+
+    TwoWire *i2cWire() { return wire_; }
+    uint32_t i2cFrequency() const { return i2c_freq_; }
+
+  private:
+    TwoWire *wire_ = nullptr;
+    uint32_t i2c_freq_ = 100000;
+    int scl_ = -1, sda_ = -1;
+    int mclk_ = -1, bck_ = -1, ws_ = -1, dout_ = -1, din_ = -1;
+  };
+
+  /**
+   * @brief 编解码器驱动基类
+   */
+  class AudioDriver
+  {
+  public:
+    virtual ~AudioDriver() = default;
+    virtual bool begin(DriverPins &pins) = 0;
+    virtual bool end() { return true; }
+    /** @brief 音量 0..100 */
+    virtual bool setVolume(int volume) = 0;
+    virtual bool setMute(bool mute) = 0;
+  };
+
+  /**
+   * @brief ES8311 驱动模拟（I2C 地址 0x18）
+   */
+  class AudioDriverES8311Class : public AudioDriver
+  {
+  public:
+    static constexpr uint8_t I2C_ADDR = 0x18;
+
+    bool begin(DriverPins &pins) override;
+    bool setVolume(int volume) override;
+    bool setMute(bool mute) override;
+
+  private:
+    bool writeReg(uint8_t reg, uint8_t val);
+    bool readReg(uint8_t reg, uint8_t &val);
+    bool updateReg(uint8_t reg, uint8_t mask, uint8_t val);
+
+    TwoWire *wire_ = nullptr;
+  };
+
+  class AudioBoard
+  {
+  public:
+    AudioBoard(AudioDriver &driver, DriverPins &pins) : driver_(&driver), pins_(&pins) {}
+    bool begin();
+    bool end() { return driver_->end(); }
+    bool setVolume(int volume) { return driver_->setVolume(volume); }
+    bool setMute(bool mute) { return driver_->setMute(mute); }
+    DriverPins &getPins() { return *pins_; }
+    AudioDriver *getDriver() { return driver_; }
+
+  private:
+    AudioDriver *driver_;
+    DriverPins *pins_;
+  };
+
+  extern AudioDriverES8311Class AudioDriverES8311;
+  extern AudioDriverLoggerClass AudioDriverLogger;
+}
+
+namespace host
+{
+  /** @brief 在 I2C 总线上挂载 ES8311 寄存器模型（芯片 ID 0x83 0x11） */
+  I2CRegisterDevice &attachEs8311(TwoWire &wire);
+}
+
+using namespace audio_driver;
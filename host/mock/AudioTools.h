@@ -0,0 +1,346 @@
+/**
+ * @file AudioTools.h
+ * @brief 主机模拟：arduino-audio-tools 中本工程用到的类
+ *
+ * 接口与原库保持一致（名称、参数、返回值），实现尽量简单：
+ *  - WAVEncoder / WAVDecoder：真实的 WAV 头写入与解析，PCM 原样透传
+ *  - I2SCodecStream：RX 读取 host::Env 指定的输入，TX 写入主机文件（.wav 后缀时带 WAV 头）
+ *  - AudioPlayer：SD/SPIFFS 文件 → 解码器 → 软件音量 → 输出流
+ */
+#pragma once
+
+#include "Arduino.h"
+#include "AudioBoard.h"
+#include "SD.h"
+#include "SPIFFS.h"
+
+#include <vector>
+
+namespace audio_tools
+{
+  //===========================================================
+  // 基础类型
+  //===========================================================
+  struct AudioInfo
+  {
+    AudioInfo() = default;
+    AudioInfo(int sampleRate, int channelCount, int bitsPerSample)
+        : sample_rate(sampleRate), channels(channelCount), bits_per_sample(bitsPerSample) {}
+
+    void copyFrom(AudioInfo info)
+    {
+      sample_rate = info.sample_rate;
+      channels = info.channels;
+      bits_per_sample = info.bits_per_sample;
+    }
+    bool operator==(const AudioInfo &o) const
+    {
+      return sample_rate == o.sample_rate && channels == o.channels && bits_per_sample == o.bits_per_sample;
+    }
+    bool operator!=(const AudioInfo &o) const { return !(*this == o); }
+
+    int sample_rate = 44100;
+    int channels = 2;
+    int bits_per_sample = 16;
+  };
+
+  enum RxTxMode
+  {
+    UNDEFINED_MODE = 0,
+    TX_MODE = 1,
+    RX_MODE = 2,
+    RXTX_MODE = 3
+  };
+
+  enum I2SFormat
+  {
+    I2S_STD_FORMAT,
+    I2S_LSB_FORMAT,
+    I2S_MSB_FORMAT,
+    I2S_PHILIPS_FORMAT,
+    I2S_RIGHT_JUSTIFIED_FORMAT,
+    I2S_LEFT_JUSTIFIED_FORMAT,
+    I2S_PCM,
+  };
+
+  class AudioLogger
+  {
+  public:
+    enum LogLevel
+    {
+      Debug,
+      Info,
+      Warning,
+      Error
+    };
+
+    static AudioLogger &instance()
+    {
+      static AudioLogger logger;
+      return logger;
+    }
+    void begin(Print &out, LogLevel level)
+    {
+      out_ = &out;
+      level_ = level;
+    }
+
+  private:
+    Print *out_ = nullptr;
+    LogLevel level_ = Warning;
+  };
+
+  class AudioStream : public Stream
+  {
+  public:
+    virtual bool begin() { return true; }
+    virtual void end() {}
+    virtual void setAudioInfo(AudioInfo newInfo) { info_ = newInfo; }
+    virtual AudioInfo audioInfo() { return info_; }
+
+  protected:
+    AudioInfo info_;
+  };
+
+  //===========================================================
+  // 编码器 / 解码器
+  //===========================================================
+  class AudioEncoder : public Print
+  {
+  public:
+    virtual void setOutput(Print &out) = 0;
+    virtual bool begin(AudioInfo info) = 0;
+    virtual void end() = 0;
+    using Print::write;
+  };
+
+  class AudioDecoder : public Print
+  {
+  public:
+    virtual void setOutput(Print &out) { out_ = &out; }
+    virtual bool begin() { return true; }
+    virtual void end() {}
+    virtual AudioInfo audioInfo() { return info_; }
+    using Print::write;
+
+  protected:
+    Print *out_ = nullptr;
+    AudioInfo info_;
+  };
+
+  /**
+   * @brief WAV 编码器：首次写入时输出 44 字节头，end() 时若输出为文件则回填长度
+   */
+  class WAVEncoder : public AudioEncoder
+  {
+  public:
+    void setOutput(Print &out) override { out_ = &out; }
+    bool begin(AudioInfo info) override;
+    void end() override;
+    size_t write(const uint8_t *data, size_t len) override;
+
+  private:
+    void writeHeader(uint32_t data_len);
+
+    Print *out_ = nullptr;
+    AudioInfo info_;
+    bool header_written_ = false;
+    uint32_t data_len_ = 0;
+  };
+
+  /**
+   * @brief WAV 解码器：增量解析 RIFF 头，data 块内的 PCM 原样输出
+   *
+   * 支持 PCM(1) 与 WAVE_FORMAT_EXTENSIBLE(0xFFFE)；头部异常时进入错误状态并丢弃后续数据。
+   */
+  class WAVDecoder : public AudioDecoder
+  {
+  public:
+    static constexpr size_t MAX_HEADER_SIZE = 4096;
+
+    bool begin() override;
+    void end() override;
+    size_t write(const uint8_t *data, size_t len) override;
+
+    bool isHeaderValid() const { return state_ == State::Data; }
+    bool hasError() const { return state_ == State::Error; }
+    uint32_t dataLength() const { return data_len_; }
+
+  private:
+    enum class State
+    {
+      Header,
+      Data,
+      Error
+    };
+
+    bool parseHeader();
+
+    State state_ = State::Header;
+    std::vector<uint8_t> header_;
+    uint32_t data_len_ = 0;
+    uint32_t data_left_ = 0;
+  };
+
+  //===========================================================
+  // I2S 编解码流
+  //===========================================================
+  struct I2SCodecConfig : public AudioInfo
+  {
+    RxTxMode rx_tx_mode = TX_MODE;
+    I2SFormat i2s_format = I2S_STD_FORMAT;
+    int buffer_count = 6;
+    int buffer_size = 512;
+  };
+
+  class I2SCodecStream : public AudioStream
+  {
+  public:
+    explicit I2SCodecStream(AudioBoard *board);
+    explicit I2SCodecStream(AudioBoard &board) : I2SCodecStream(&board) {}
+    ~I2SCodecStream() override;
+
+    I2SCodecConfig defaultConfig(RxTxMode mode = TX_MODE)
+    {
+      I2SCodecConfig cfg;
+      cfg.rx_tx_mode = mode;
+      return cfg;
+    }
+    bool begin() override { return begin(cfg_); }
+    bool begin(I2SCodecConfig cfg);
+    void end() override;
+    /** @brief 切换格式（与 AudioTools 相同：播放器按文件格式设置输出，之后的读写按新格式计时） */
+    void setAudioInfo(AudioInfo newInfo) override;
+    bool setVolume(float vol);
+    float volume() const { return volume_; }
+
+    using Print::write;
+    size_t write(const uint8_t *data, size_t len) override;
+    size_t readBytes(uint8_t *data, size_t len) override;
+    int available() override { return cfg_.rx_tx_mode & RX_MODE ? cfg_.buffer_size : 0; }
+    int availableForWrite() override { return cfg_.buffer_size; }
+
+    // 主机扩展：不推进虚拟时间的读写，由调用方自行计时（i2s_direct.cpp 的 DMA 环模型）
+    size_t readUnpaced(uint8_t *data, size_t len);
+    size_t writeUnpaced(const uint8_t *data, size_t len);
+
+  private:
+    void pace(size_t bytes);
+    void fillRx(uint8_t *data, size_t len);
+    void buildTone();
+
+    AudioBoard *board_;
+    I2SCodecConfig cfg_;
+    float volume_ = 1.0f;
+    bool active_ = false;
+    FILE *rx_file_ = nullptr;
+    FILE *tx_file_ = nullptr;
+    bool tx_wav_ = false;
+    uint32_t tx_bytes_ = 0;
+    std::vector<uint8_t> tone_; // 合成正弦波的一个完整周期
+    size_t tone_pos_ = 0;
+    double pace_rem_us_ = 0;
+  };
+
+  //===========================================================
+  // 音源 & 播放器
+  //===========================================================
+  class AudioSource
+  {
+  public:
+    virtual ~AudioSource() = default;
+    virtual void begin() = 0;
+    virtual Stream *nextStream(int offset = 1) = 0;
+    virtual Stream *selectStream(int index) = 0;
+    virtual Stream *selectStream(const char *path) = 0;
+  };
+
+  /**
+   * @brief 基于 fs::FS 的目录音源：按文件名排序枚举 startFilePath 下后缀为 ext 的文件
+   */
+  class AudioSourceFS : public AudioSource
+  {
+  public:
+    AudioSourceFS(fs::FS &fs, const char *startFilePath, const char *ext)
+        : fs_(&fs), start_path_(startFilePath), ext_(ext) {}
+    void begin() override;
+    Stream *nextStream(int offset = 1) override;
+    Stream *selectStream(int index) override;
+    Stream *selectStream(const char *path) override;
+
+  protected:
+    fs::FS *fs_;
+    std::string start_path_;
+    std::string ext_;
+    std::vector<std::string> files_;
+    int index_ = -1;
+    File file_;
+  };
+
+  class AudioSourceSD : public AudioSourceFS
+  {
+  public:
+    AudioSourceSD(const char *startFilePath = "/", const char *ext = ".mp3", int chipSelect = -1,
+                  SPIClass &spiInstance = SPI, bool setupIndex = true)
+        : AudioSourceFS(SD, startFilePath, ext), cs_(chipSelect), spi_(&spiInstance) { (void)setupIndex; }
+
+  private:
+    int cs_;
+    SPIClass *spi_;
+  };
+
+  class AudioSourceSPIFFS : public AudioSourceFS
+  {
+  public:
+    AudioSourceSPIFFS(const char *startFilePath = "/", const char *ext = ".mp3")
+        : AudioSourceFS(SPIFFS, startFilePath, ext) {}
+  };
+
+  /**
+   * @brief 播放器：音源 → 解码器 → 软件音量 → 输出
+   */
+  class AudioPlayer : public Print
+  {
+  public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 1024;
+
+    AudioPlayer(AudioSource &source, AudioStream &output, AudioDecoder &decoder);
+
+    bool begin(int index = 0, bool isActive = true);
+    void end();
+    bool setPath(const char *path);
+    void play() { active_ = true; }
+    void stop() { active_ = false; }
+    bool isActive() const { return active_; }
+    bool setVolume(float volume);
+    float volume() const { return volume_; }
+
+    /** @brief 拷贝一个缓冲区（解码并输出），返回读取的字节数；文件结束返回 0 */
+    size_t copy() { return copy(DEFAULT_BUFFER_SIZE); }
+    size_t copy(size_t bytes);
+    size_t copyAll();
+
+    /** @brief 解码器输出入口：施加软件音量后写入输出流 */
+    using Print::write;
+    size_t write(const uint8_t *data, size_t len) override;
+
+  private:
+    AudioSource *source_;
+    AudioStream *output_;
+    AudioDecoder *decoder_;
+    Stream *input_ = nullptr;
+    bool active_ = false;
+    float volume_ = 1.0f;
+    std::vector<uint8_t> buffer_;
+    std::vector<uint8_t> scaled_;
+    AudioInfo output_info_{0, 0, 0}; // 已通知输出的格式（新文件开始时清零）
+  };
+}
+
+namespace host
+{
+  /** @brief 结束所有 I2S 流（关闭 TX 文件并回填 WAV 头），主机程序退出前调用 */
+  void finishAudio();
+}
+
+using namespace audio_tools;
@@ -0,0 +1,7 @@
+/**
+ * @file CodecWAV.h
+ * @brief 主机模拟：所有类都在 AudioTools.h 中实现
+ */
+#pragma once
+
+#include "AudioTools.h"
@@ -0,0 +1,112 @@
+/**
+ * @file FS.h
+ * @brief 主机模拟：fs::FS / fs::File，映射到主机目录
+ */
+#pragma once
+
+#include "Arduino.h"
+
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs
+{
+  enum SeekMode
+  {
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+  };
+
+  /**
+   * @brief 文件后端接口；默认实现直接读写主机文件，
+   *        故障注入等模拟可以替换为自定义实现
+   */
+  class FileImpl
+  {
+  public:
+    virtual ~FileImpl() = default;
+    virtual size_t write(const uint8_t *buf, size_t size) = 0;
+    virtual size_t read(uint8_t *buf, size_t size) = 0;
+    virtual bool seek(uint32_t pos, SeekMode mode) = 0;
+    virtual size_t position() const = 0;
+    virtual size_t size() const = 0;
+    virtual void flush() {}
+    virtual void close() = 0;
+    virtual const char *path() const = 0;
+    virtual bool isDirectory() const { return false; }
+    virtual std::shared_ptr<FileImpl> openNextFile(const char *mode) { (void)mode; return nullptr; }
+  };
+
+  using FileImplPtr = std::shared_ptr<FileImpl>;
+
+  class File : public Stream
+  {
+  public:
+    File(FileImplPtr impl = FileImplPtr()) : impl_(impl) {}
+
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buf, size_t size) override { return impl_ ? impl_->write(buf, size) : 0; }
+    int available() override { return impl_ ? (int)(impl_->size() - impl_->position()) : 0; }
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t *buf, size_t size) { return impl_ ? impl_->read(buf, size) : 0; }
+    size_t readBytes(uint8_t *buffer, size_t length) override { return read(buffer, length); }
+    void flush() override
+    {
+      if (impl_)
+        impl_->flush();
+    }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet) { return impl_ && impl_->seek(pos, mode); }
+    size_t position() const { return impl_ ? impl_->position() : 0; }
+    size_t size() const { return impl_ ? impl_->size() : 0; }
+    void close()
+    {
+      if (impl_)
+        impl_->close();
+      impl_.reset();
+    }
+    operator bool() const { return (bool)impl_; }
+    const char *path() const { return impl_ ? impl_->path() : ""; }
+    const char *name() const;
+    bool isDirectory() const { return impl_ && impl_->isDirectory(); }
+    File openNextFile(const char *mode = FILE_READ) { return impl_ ? File(impl_->openNextFile(mode)) : File(); }
+    FileImplPtr impl() const { return impl_; }
+
+  private:
+    FileImplPtr impl_;
+  };
+
+  /**
+   * @brief 文件系统：把 Arduino 路径映射到主机根目录下
+   */
+  class FS
+  {
+  public:
+    /** @brief 文件打开钩子，可返回自定义 FileImpl（如故障注入），返回空则使用默认实现 */
+    using OpenHook = std::function<FileImplPtr(FileImplPtr file, const char *path, const char *mode)>;
+
+    explicit FS(std::string *root) : root_(root) {}
+
+    File open(const char *path, const char *mode = FILE_READ, bool create = false);
+    File open(const std::string &path, const char *mode = FILE_READ) { return open(path.c_str(), mode); }
+    bool exists(const char *path);
+    bool remove(const char *path);
+    bool mkdir(const char *path);
+
+    /** @brief 主机模拟专用：设置文件打开钩子 */
+    void setOpenHook(OpenHook hook) { open_hook_ = hook; }
+    std::string hostPath(const char *path) const;
+
+  protected:
+    std::string *root_;
+    OpenHook open_hook_;
+  };
+}
+
+using fs::File;
+using fs::FS;
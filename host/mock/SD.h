@@ -0,0 +1,35 @@
+/**
+ * @file SD.h
+ * @brief 主机模拟：SD 卡（映射到 host::Env::sd_root 目录）
+ */
+#pragma once
+
+#include "FS.h"
+#include "SPI.h"
+
+typedef enum
+{
+  CARD_NONE,
+  CARD_MMC,
+  CARD_SD,
+  CARD_SDHC,
+  CARD_UNKNOWN
+} sdcard_type_t;
+
+namespace fs
+{
+  class SDFS : public FS
+  {
+  public:
+    SDFS() : FS(&host::env().sd_root) {}
+    bool begin(uint8_t ssPin, SPIClass &spi, uint32_t frequency = 4000000, const char *mountpoint = "/sd",
+               uint8_t max_files = 5, bool format_if_empty = false);
+    void end() { mounted_ = false; }
+    sdcard_type_t cardType() const { return mounted_ ? CARD_SDHC : CARD_NONE; }
+
+  private:
+    bool mounted_ = false;
+  };
+}
+
+extern fs::SDFS SD;
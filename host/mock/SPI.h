@@ -0,0 +1,27 @@
+/**
+ * @file SPI.h
+ * @brief 主机模拟：SPIClass（仅记录引脚，无实际传输）
+ */
+#pragma once
+
+#include "Arduino.h"
+
+class SPIClass
+{
+public:
+  explicit SPIClass(uint8_t spi_bus = 0) : bus_(spi_bus) {}
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1)
+  {
+    sck_ = sck;
+    miso_ = miso;
+    mosi_ = mosi;
+    ss_ = ss;
+  }
+  void end() {}
+
+private:
+  uint8_t bus_;
+  int8_t sck_ = -1, miso_ = -1, mosi_ = -1, ss_ = -1;
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,21 @@
+/**
+ * @file SPIFFS.h
+ * @brief 主机模拟：SPIFFS（映射到 host::Env::spiffs_root 目录）
+ */
+#pragma once
+
+#include "FS.h"
+
+namespace fs
+{
+  class SPIFFSFS : public FS
+  {
+  public:
+    SPIFFSFS() : FS(&host::env().spiffs_root) {}
+    bool begin(bool formatOnFail = false, const char *basePath = "/spiffs", uint8_t maxOpenFiles = 10,
+               const char *partitionLabel = nullptr);
+    void end() {}
+  };
+}
+
+extern fs::SPIFFSFS SPIFFS;
@@ -0,0 +1,90 @@
+/**
+ * @file Wire.h
+ * @brief 主机模拟：TwoWire（I2C），带寄存器型从设备模型与事务计数
+ *
+ * 每个事务按 (地址 + 数据字节) * 9 bit / 时钟频率 推进虚拟时间，
+ * 便于比较不同 I2C 速度与批量写入策略的开销。
+ */
+#pragma once
+
+#include "Arduino.h"
+
+#include <map>
+#include <vector>
+
+namespace host
+{
+  /**
+   * @brief 简单的 8 位地址寄存器型 I2C 从设备（支持地址自增）
+   */
+  struct I2CRegisterDevice
+  {
+    uint8_t regs[256] = {0};
+    uint8_t pointer = 0;
+    uint64_t ready_at_us = 0; // 上电：虚拟时间到达之前不应答
+  };
+
+  /** @brief I2C 总线统计 */
+  struct I2CStats
+  {
+    uint32_t transactions = 0; // 起始条件次数（写事务 + 读事务）
+    uint32_t bytes = 0;        // 传输字节数（含地址字节）
+    uint32_t nacks = 0;        // 无应答次数
+  };
+}
+
+class TwoWire : public Stream
+{
+public:
+  explicit TwoWire(uint8_t bus_num) : bus_(bus_num) {}
+
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 100000)
+  {
+    sda_ = sda;
+    scl_ = scl;
+    if (frequency)
+      freq_ = frequency;
+    return true;
+  }
+  bool end() { return true; }
+  bool setClock(uint32_t frequency)
+  {
+    freq_ = frequency;
+    return true;
+  }
+  uint32_t getClock() const { return freq_; }
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t requestFrom(uint8_t address, size_t size, bool sendStop = true);
+
+  using Print::write;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t size) override;
+  int available() override;
+  int read() override;
+  int peek() override;
+
+  //===========================================================
+  // 主机模拟专用
+  //===========================================================
+  /** @brief 在指定地址挂载寄存器型从设备 */
+  host::I2CRegisterDevice &attach(uint8_t address) { return devices_[address]; }
+  host::I2CRegisterDevice *device(uint8_t address);
+  host::I2CStats &stats() { return stats_; }
+
+private:
+  void chargeTime(size_t bytes);
+
+  uint8_t bus_;
+  int sda_ = -1, scl_ = -1;
+  uint32_t freq_ = 100000;
+  uint8_t tx_addr_ = 0;
+  std::vector<uint8_t> tx_;
+  std::vector<uint8_t> rx_;
+  size_t rx_pos_ = 0;
+  std::map<uint8_t, host::I2CRegisterDevice> devices_;
+  host::I2CStats stats_;
+};
+
+extern TwoWire Wire;
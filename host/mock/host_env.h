@@ -0,0 +1,68 @@
+/**
+ * @file host_env.h
+ * @brief 主机（Linux）模拟环境：虚拟时钟与运行参数
+ *
+ * 原生构建（env:native）下没有 ESP32 / ES8311 / SD 卡，
+ * 所有硬件层都由 host/mock 下的模拟实现替代：
+ *  - 时间：虚拟时钟，delay() / I2S 读写只推进虚拟时间，不真正睡眠，结果可复现
+ *  - SD / SPIFFS：映射到主机目录
+ *  - I2S RX：从主机 PCM 文件或合成正弦波读取
+ *  - I2S TX：写入主机 PCM 文件
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace host
+{
+  //===========================================================
+  // 虚拟时钟
+  //===========================================================
+  /** @brief 当前虚拟时间（微秒） */
+  uint64_t nowMicros();
+
+  /** @brief 推进虚拟时间，并依次调用时间钩子 */
+  void advanceMicros(uint64_t us);
+
+  /** @brief 时间推进钩子（参数：推进后的当前时间） */
+  using TimeHook = std::function<void(uint64_t now_us)>;
+
+  /** @brief 设置时间推进钩子，传入空函数即清除 */
+  void setTimeHook(TimeHook hook);
+
+  //===========================================================
+  // 运行参数
+  //===========================================================
+  struct Env
+  {
+    std::string sd_root = "host_sd";         // SD 卡根目录映射
+    std::string spiffs_root = "host_spiffs"; // SPIFFS 根目录映射
+    std::string i2s_rx_path;                 // I2S RX 输入（原始 PCM），为空时使用合成正弦波
+    std::string i2s_tx_path = "i2s_tx.pcm";  // I2S TX 输出（原始 PCM，.wav 后缀时带头），为空时丢弃
+    bool pace_i2s = true;                    // true: I2S 读写按采样率推进虚拟时间；false: 不计时（基准测试）
+    uint32_t rx_tone_hz = 1000;              // 合成正弦波频率
+    std::string serial_input;                // 预置的串口输入
+    int loops = 4;                           // loop() 调用次数
+
+    // SD 卡故障注入（见 sd_faults.h）
+    bool sd_faults = false;                  // 是否启用
+    uint32_t sd_fault_seed = 1;              // 随机种子
+    double sd_stall_probability = 0.002;     // 每次写入发生停顿的概率
+    double sd_short_write_probability = 0.0; // 每次写入只完成一部分的概率
+
+    // 上电时序（虚拟时间）
+    uint32_t sd_mount_us = 150000;   // SD.begin() 耗时（卡复位与初始化）
+    uint32_t codec_ready_us = 30000; // 上电后 ES8311 开始应答 I2C 的时间
+
+    uint32_t adc_mv = 1950; // ADC 引脚电压（analogReadMilliVolts），默认约为 3.9 V 电池经 1:2 分压
+  };
+
+  /** @brief 全局运行参数 */
+  Env &env();
+
+  /** @brief 解析命令行参数（--sd --spiffs --rx --tx --no-pace --tone --serial --loops
+   *         --sd-faults SEED --sd-stall-prob P --sd-short-prob P --adc-mv MV） */
+  bool parseArgs(int argc, char **argv);
+}
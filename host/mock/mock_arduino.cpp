@@ -0,0 +1,265 @@
+/**
+ * @file mock_arduino.cpp
+ * @brief 主机模拟：虚拟时钟、运行参数、GPIO、串口、I2C
+ */
+#include "Arduino.h"
+#include "SPI.h"
+#include "Wire.h"
+
+#include <map>
+
+//===========================================================
+// 虚拟时钟 & 运行参数
+//===========================================================
+namespace host
+{
+  static uint64_t s_now_us = 0;
+  static TimeHook s_time_hook;
+
+  uint64_t nowMicros() { return s_now_us; }
+
+  void advanceMicros(uint64_t us)
+  {
+    s_now_us += us;
+    if (s_time_hook)
+      s_time_hook(s_now_us);
+  }
+
+  void setTimeHook(TimeHook hook) { s_time_hook = hook; }
+
+  Env &env()
+  {
+    static Env e;
+    return e;
+  }
+
+  bool parseArgs(int argc, char **argv)
+  {
+    Env &e = env();
+    for (int i = 1; i < argc; i++)
+    {
+      std::string arg = argv[i];
+      bool has_value = i + 1 < argc;
+      if (arg == "--no-pace")
+        e.pace_i2s = false;
+      else if (arg == "--sd" && has_value)
+        e.sd_root = argv[++i];
+      else if (arg == "--spiffs" && has_value)
+        e.spiffs_root = argv[++i];
+      else if (arg == "--rx" && has_value)
+        e.i2s_rx_path = argv[++i];
+      else if (arg == "--tx" && has_value)
+        e.i2s_tx_path = argv[++i];
+      else if (arg == "--tone" && has_value)
+        e.rx_tone_hz = (uint32_t)atoi(argv[++i]);
+      else if (arg == "--serial" && has_value)
+        e.serial_input += argv[++i];
+      else if (arg == "--loops" && has_value)
+        e.loops = atoi(argv[++i]);
+      else if (arg == "--sd-faults" && has_value)
+      {
+        e.sd_faults = true;
+        e.sd_fault_seed = (uint32_t)atoi(argv[++i]);
+      }
+      else if (arg == "--sd-stall-prob" && has_value)
+        e.sd_stall_probability = atof(argv[++i]);
+      else if (arg == "--sd-short-prob" && has_value)
+        e.sd_short_write_probability = atof(argv[++i]);
+      else if (arg == "--adc-mv" && has_value)
+        e.adc_mv = (uint32_t)atoi(argv[++i]);
+      else
+      {
+        fprintf(stderr, "unknown argument: %s\n", arg.c_str());
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+//===========================================================
+// GPIO
+//===========================================================
+static std::map<uint8_t, uint8_t> s_pins;
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin, (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t val) { s_pins[pin] = val; }
+int digitalRead(uint8_t pin) { return s_pins.count(pin) ? s_pins[pin] : LOW; }
+
+//===========================================================
+// ADC（所有引脚返回同一电压）
+//===========================================================
+uint32_t analogReadMilliVolts(uint8_t pin)
+{
+  (void)pin;
+  return host::env().adc_mv;
+}
+
+//===========================================================
+// 时间
+//===========================================================
+unsigned long millis() { return (unsigned long)(host::nowMicros() / 1000); }
+unsigned long micros() { return (unsigned long)host::nowMicros(); }
+void delay(uint32_t ms) { host::advanceMicros((uint64_t)ms * 1000); }
+void delayMicroseconds(uint32_t us) { host::advanceMicros(us); }
+void vTaskDelay(TickType_t ticks) { host::advanceMicros((uint64_t)ticks * portTICK_PERIOD_MS * 1000); }
+uint32_t getCpuFrequencyMhz() { return HOST_CPU_MHZ; }
+
+//===========================================================
+// Print / Stream / Serial
+//===========================================================
+size_t Print::printf(const char *fmt, ...)
+{
+  char buf[256];
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (len < 0)
+    return 0;
+  if ((size_t)len < sizeof(buf))
+    return write((const uint8_t *)buf, (size_t)len);
+
+  std::string big((size_t)len + 1, '\0');
+  va_start(args, fmt);
+  vsnprintf(&big[0], big.size(), fmt, args);
+  va_end(args);
+  return write((const uint8_t *)big.data(), (size_t)len);
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+  size_t count = 0;
+  while (count < length)
+  {
+    int c = read();
+    if (c < 0)
+      break;
+    buffer[count++] = (uint8_t)c;
+  }
+  return count;
+}
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  return fwrite(buffer, 1, size, stdout);
+}
+
+int HardwareSerial::available()
+{
+  if (rx_pos_ == 0 && rx_.empty() && !host::env().serial_input.empty())
+  {
+    rx_ = host::env().serial_input;
+    host::env().serial_input.clear();
+  }
+  return (int)(rx_.size() - rx_pos_);
+}
+
+int HardwareSerial::read()
+{
+  if (available() <= 0)
+    return -1;
+  int c = (uint8_t)rx_[rx_pos_++];
+  if (rx_pos_ == rx_.size())
+  {
+    rx_.clear();
+    rx_pos_ = 0;
+  }
+  return c;
+}
+
+int HardwareSerial::peek()
+{
+  return available() > 0 ? (uint8_t)rx_[rx_pos_] : -1;
+}
+
+//===========================================================
+// SPI
+//===========================================================
+SPIClass SPI(0);
+
+//===========================================================
+// I2C
+//===========================================================
+TwoWire Wire(0);
+
+host::I2CRegisterDevice *TwoWire::device(uint8_t address)
+{
+  auto it = devices_.find(address);
+  return it == devices_.end() ? nullptr : &it->second;
+}
+
+void TwoWire::chargeTime(size_t bytes)
+{
+  // 起始 + 地址 + 数据 + 停止，每字节 9 个时钟（含 ACK）
+  uint64_t bits = (uint64_t)(bytes + 1) * 9 + 2;
+  host::advanceMicros((bits * 1000000ULL + freq_ - 1) / freq_);
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  tx_addr_ = address;
+  tx_.clear();
+}
+
+size_t TwoWire::write(uint8_t c)
+{
+  tx_.push_back(c);
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size)
+{
+  tx_.insert(tx_.end(), data, data + size);
+  return size;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+  (void)sendStop;
+  stats_.transactions++;
+  stats_.bytes += (uint32_t)tx_.size() + 1;
+  chargeTime(tx_.size());
+
+  host::I2CRegisterDevice *dev = device(tx_addr_);
+  if (!dev || host::nowMicros() < dev->ready_at_us)
+  {
+    stats_.nacks++;
+    return 2; // 地址无应答
+  }
+  if (!tx_.empty())
+  {
+    dev->pointer = tx_[0];
+    // 寄存器地址自增写入
+    for (size_t i = 1; i < tx_.size(); i++)
+      dev->regs[dev->pointer++] = tx_[i];
+  }
+  tx_.clear();
+  return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t size, bool sendStop)
+{
+  (void)sendStop;
+  stats_.transactions++;
+  stats_.bytes += (uint32_t)size + 1;
+  chargeTime(size);
+
+  rx_.clear();
+  rx_pos_ = 0;
+  host::I2CRegisterDevice *dev = device(address);
+  if (!dev || host::nowMicros() < dev->ready_at_us)
+  {
+    stats_.nacks++;
+    return 0;
+  }
+  for (size_t i = 0; i < size; i++)
+    rx_.push_back(dev->regs[dev->pointer++]);
+  return size;
+}
+
+int TwoWire::available() { return (int)(rx_.size() - rx_pos_); }
+int TwoWire::read() { return rx_pos_ < rx_.size() ? rx_[rx_pos_++] : -1; }
+int TwoWire::peek() { return rx_pos_ < rx_.size() ? rx_[rx_pos_] : -1; }
@@ -0,0 +1,673 @@
+/**
+ * @file mock_audio.cpp
+ * @brief 主机模拟：ES8311 驱动、I2S 编解码流、WAV 编解码器、音源与播放器
+ */
+#include "AudioTools.h"
+
+#include <vector>
+
+//===========================================================
+// 小端读写工具
+//===========================================================
+namespace
+{
+  inline uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+  inline uint32_t rd32(const uint8_t *p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+  inline void wr16(uint8_t *p, uint16_t v)
+  {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+  }
+  inline void wr32(uint8_t *p, uint32_t v)
+  {
+    for (int i = 0; i < 4; i++)
+      p[i] = (uint8_t)(v >> (8 * i));
+  }
+
+  /** @brief 每个采样的存储字节数（24bit 按 AudioTools 习惯存为 4 字节） */
+  inline int storageBytes(int bits) { return bits == 16 ? 2 : bits == 8 ? 1 : 4; }
+
+  /** @brief 生成 44 字节 PCM WAV 头 */
+  void makeWavHeader(uint8_t *h, const audio_tools::AudioInfo &info, uint32_t data_len)
+  {
+    uint16_t block_align = (uint16_t)(info.channels * storageBytes(info.bits_per_sample));
+    memcpy(h, "RIFF", 4);
+    wr32(h + 4, data_len + 36);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    wr32(h + 16, 16);
+    wr16(h + 20, 1); // PCM
+    wr16(h + 22, (uint16_t)info.channels);
+    wr32(h + 24, (uint32_t)info.sample_rate);
+    wr32(h + 28, (uint32_t)info.sample_rate * block_align);
+    wr16(h + 32, block_align);
+    wr16(h + 34, (uint16_t)info.bits_per_sample);
+    memcpy(h + 36, "data", 4);
+    wr32(h + 40, data_len);
+  }
+}
+
+//===========================================================
+// arduino-audio-driver 模拟
+//===========================================================
+namespace audio_driver
+{
+  AudioDriverES8311Class AudioDriverES8311;
+  AudioDriverLoggerClass AudioDriverLogger;
+
+  bool DriverPins::addI2C(PinFunction function, int scl, int sda, int port, uint32_t frequency, TwoWire &wire,
+                          bool active)
+  {
+    (void)function, (void)port, (void)active;
+    scl_ = scl;
+    sda_ = sda;
+    i2c_freq_ = frequency;
+    wire_ = &wire;
+    return true;
+  }
+
+  bool DriverPins::addI2S(PinFunction function, int mclk, int bck, int ws, int data_out, int data_in, int port)
+  {
+    (void)function, (void)port;
+    mclk_ = mclk;
+    bck_ = bck;
+    ws_ = ws;
+    dout_ = data_out;
+    din_ = data_in;
+    return true;
+  }
+
+  bool DriverPins::begin()
+  {
+    if (!wire_)
+      return false;
+    wire_->begin(sda_, scl_, i2c_freq_);
+    host::attachEs8311(*wire_);
+    return true;
+  }
+
+  bool AudioDriverES8311Class::writeReg(uint8_t reg, uint8_t val)
+  {
+    wire_->beginTransmission(I2C_ADDR);
+    wire_->write(reg);
+    wire_->write(val);
+    return wire_->endTransmission() == 0;
+  }
+
+  bool AudioDriverES8311Class::readReg(uint8_t reg, uint8_t &val)
+  {
+    wire_->beginTransmission(I2C_ADDR);
+    wire_->write(reg);
+    if (wire_->endTransmission(false) != 0)
+      return false;
+    if (wire_->requestFrom(I2C_ADDR, (size_t)1) != 1)
+      return false;
+    val = (uint8_t)wire_->read();
+    return true;
+  }
+
+  bool AudioDriverES8311Class::updateReg(uint8_t reg, uint8_t mask, uint8_t val)
+  {
+    uint8_t cur = 0;
+    if (!readReg(reg, cur))
+      return false;
+    return writeReg(reg, (uint8_t)((cur & ~mask) | (val & mask)));
+  }
+
+  bool AudioDriverES8311Class::begin(DriverPins &pins)
+  {
+    wire_ = pins.i2cWire();
+    if (!wire_)
+      return false;
+
+    uint8_t id1 = 0, id2 = 0;
+    if (!readReg(0xFD, id1) || !readReg(0xFE, id2) || id1 != 0x83 || id2 != 0x11)
+      return false;
+
+    // 与原驱动相同的初始化顺序：逐寄存器单独写入
+    static const uint8_t init_seq[][2] = {
+        {0x45, 0x00}, {0x01, 0x30}, {0x02, 0x10}, {0x16, 0x24}, {0x03, 0x10}, {0x04, 0x10},
+        {0x05, 0x00}, {0x0B, 0x00}, {0x0C, 0x00}, {0x10, 0x1F}, {0x11, 0x7F}, {0x00, 0x80},
+        {0x01, 0x3F}, {0x06, 0x03}, {0x07, 0x00}, {0x08, 0xFF}, {0x13, 0x10}, {0x1B, 0x0A},
+        {0x1C, 0x6A}, {0x09, 0x0C}, {0x0A, 0x0C}, {0x17, 0xBF}, {0x0E, 0x02}, {0x12, 0x00},
+        {0x14, 0x1A}, {0x0D, 0x01}, {0x15, 0x40}, {0x37, 0x08}, {0x32, 0xBF},
+    };
+    for (auto &rv : init_seq)
+    {
+      if (!writeReg(rv[0], rv[1]))
+        return false;
+    }
+    return true;
+  }
+
+  bool AudioDriverES8311Class::setVolume(int volume)
+  {
+    if (!wire_)
+      return false;
+    volume = std::max(0, std::min(100, volume));
+    // 0..100 → 0x00..0xFF（0.5 dB 步进）
+    return writeReg(0x32, (uint8_t)(volume * 255 / 100));
+  }
+
+  bool AudioDriverES8311Class::setMute(bool mute)
+  {
+    if (!wire_)
+      return false;
+    return updateReg(0x31, 0x60, mute ? 0x60 : 0x00);
+  }
+
+  bool AudioBoard::begin() { return driver_->begin(*pins_); }
+}
+
+namespace host
+{
+  I2CRegisterDevice &attachEs8311(TwoWire &wire)
+  {
+    I2CRegisterDevice &dev = wire.attach(audio_driver::AudioDriverES8311Class::I2C_ADDR);
+    dev.regs[0xFD] = 0x83; // CHIP ID1
+    dev.regs[0xFE] = 0x11; // CHIP ID2
+    dev.regs[0xFF] = 0x00; // CHIP VER
+    dev.ready_at_us = host::env().codec_ready_us;
+    return dev;
+  }
+}
+
+namespace audio_tools
+{
+  //===========================================================
+  // WAV 编码器
+  //===========================================================
+  bool WAVEncoder::begin(AudioInfo info)
+  {
+    info_ = info;
+    header_written_ = false;
+    data_len_ = 0;
+    return true;
+  }
+
+  void WAVEncoder::writeHeader(uint32_t data_len)
+  {
+    uint8_t h[44];
+    makeWavHeader(h, info_, data_len);
+    out_->write(h, sizeof(h));
+  }
+
+  size_t WAVEncoder::write(const uint8_t *data, size_t len)
+  {
+    if (!out_)
+      return 0;
+    if (!header_written_)
+    {
+      writeHeader(0xFFFFFFFF - 36); // 长度未知，end() 时回填
+      header_written_ = true;
+    }
+    size_t written = out_->write(data, len);
+    data_len_ += (uint32_t)written;
+    return written;
+  }
+
+  void WAVEncoder::end()
+  {
+    if (!out_ || !header_written_)
+      return;
+    // 输出为文件时回填 RIFF / data 长度
+    File *file = dynamic_cast<File *>(out_);
+    if (file && file->seek(0))
+    {
+      writeHeader(data_len_);
+      file->seek(0, fs::SeekEnd);
+    }
+    header_written_ = false;
+  }
+
+  //===========================================================
+  // WAV 解码器
+  //===========================================================
+  bool WAVDecoder::begin()
+  {
+    state_ = State::Header;
+    header_.clear();
+    data_len_ = data_left_ = 0;
+    return true;
+  }
+
+  void WAVDecoder::end()
+  {
+    state_ = State::Header;
+    header_.clear();
+  }
+
+  bool WAVDecoder::parseHeader()
+  {
+    const uint8_t *h = header_.data();
+    size_t n = header_.size();
+    if (n < 12)
+      return false;
+    if (memcmp(h, "RIFF", 4) != 0 || memcmp(h + 8, "WAVE", 4) != 0)
+    {
+      state_ = State::Error;
+      return false;
+    }
+
+    bool has_fmt = false;
+    size_t pos = 12;
+    while (pos + 8 <= n)
+    {
+      uint32_t chunk_len = rd32(h + pos + 4);
+      if (memcmp(h + pos, "data", 4) == 0)
+      {
+        if (!has_fmt)
+        {
+          state_ = State::Error;
+          return false;
+        }
+        data_len_ = chunk_len;
+        // 0 / 未回填长度按流式数据处理：一直读到文件结束
+        data_left_ = (chunk_len == 0 || chunk_len >= 0xFFFFFFFF - 36) ? 0xFFFFFFFF : chunk_len;
+        state_ = State::Data;
+        header_.erase(header_.begin(), header_.begin() + (long)(pos + 8));
+        return true;
+      }
+
+      uint64_t next = (uint64_t)pos + 8 + chunk_len + (chunk_len & 1);
+      if (next > MAX_HEADER_SIZE)
+      {
+        state_ = State::Error;
+        return false;
+      }
+      if (next > n)
+        return false; // 等待更多数据
+
+      if (memcmp(h + pos, "fmt ", 4) == 0)
+      {
+        if (chunk_len < 16)
+        {
+          state_ = State::Error;
+          return false;
+        }
+        uint16_t format = rd16(h + pos + 8);
+        AudioInfo fmt((int)rd32(h + pos + 12), rd16(h + pos + 10), rd16(h + pos + 22));
+        bool valid_bits = fmt.bits_per_sample == 8 || fmt.bits_per_sample == 16 || fmt.bits_per_sample == 24 ||
+                          fmt.bits_per_sample == 32;
+        if ((format != 1 && format != 0xFFFE) || fmt.channels < 1 || fmt.channels > 8 || !valid_bits ||
+            fmt.sample_rate < 1 || fmt.sample_rate > 384000)
+        {
+          state_ = State::Error;
+          return false;
+        }
+        info_ = fmt;
+        has_fmt = true;
+      }
+      pos = (size_t)next;
+    }
+    return false;
+  }
+
+  size_t WAVDecoder::write(const uint8_t *data, size_t len)
+  {
+    size_t consumed = len;
+    if (state_ == State::Header)
+    {
+      size_t take = std::min(len, MAX_HEADER_SIZE + 8 - header_.size());
+      header_.insert(header_.end(), data, data + take);
+      data += take;
+      len -= take;
+      if (!parseHeader())
+      {
+        if (state_ == State::Header && header_.size() >= MAX_HEADER_SIZE + 8)
+          state_ = State::Error;
+        return consumed;
+      }
+      // 头部之后已缓存的 PCM
+      std::vector<uint8_t> pcm;
+      pcm.swap(header_);
+      size_t n = std::min((size_t)data_left_, pcm.size());
+      if (out_ && n)
+        out_->write(pcm.data(), n);
+      if (data_left_ != 0xFFFFFFFF)
+        data_left_ -= (uint32_t)n;
+    }
+    if (state_ == State::Data && len)
+    {
+      size_t n = std::min((size_t)data_left_, len);
+      if (out_ && n)
+        out_->write(data, n);
+      if (data_left_ != 0xFFFFFFFF)
+        data_left_ -= (uint32_t)n;
+    }
+    return consumed;
+  }
+
+  //===========================================================
+  // I2S 编解码流
+  //===========================================================
+  // 用于 host::finishAudio()；不析构，全局对象（如 I2SDirectStream 的成员）可在任意顺序构造 / 析构
+  static std::vector<I2SCodecStream *> &i2sStreams()
+  {
+    static std::vector<I2SCodecStream *> *streams = new std::vector<I2SCodecStream *>();
+    return *streams;
+  }
+
+  I2SCodecStream::I2SCodecStream(AudioBoard *board) : board_(board) { i2sStreams().push_back(this); }
+
+  I2SCodecStream::~I2SCodecStream()
+  {
+    end();
+    std::vector<I2SCodecStream *> &streams = i2sStreams();
+    streams.erase(std::find(streams.begin(), streams.end(), this));
+  }
+
+  bool I2SCodecStream::begin(I2SCodecConfig cfg)
+  {
+    end();
+    cfg_ = cfg;
+    info_ = cfg;
+    pace_rem_us_ = 0;
+    host::Env &e = host::env();
+    if ((cfg_.rx_tx_mode & RX_MODE) && !e.i2s_rx_path.empty())
+      rx_file_ = fopen(e.i2s_rx_path.c_str(), "rb");
+    if ((cfg_.rx_tx_mode & TX_MODE) && !e.i2s_tx_path.empty())
+    {
+      tx_file_ = fopen(e.i2s_tx_path.c_str(), "wb");
+      // 后缀为 .wav 时输出带头的 WAV，便于与参考文件比较
+      const std::string &p = e.i2s_tx_path;
+      tx_wav_ = tx_file_ && p.size() > 4 && p.compare(p.size() - 4, 4, ".wav") == 0;
+      tx_bytes_ = 0;
+      if (tx_wav_)
+      {
+        uint8_t h[44];
+        makeWavHeader(h, info_, 0);
+        fwrite(h, 1, sizeof(h), tx_file_);
+      }
+    }
+    if ((cfg_.rx_tx_mode & RX_MODE) && !rx_file_)
+      buildTone();
+    active_ = true;
+    return true;
+  }
+
+  void I2SCodecStream::end()
+  {
+    if (rx_file_)
+      fclose(rx_file_);
+    if (tx_file_ && tx_wav_)
+    {
+      uint8_t h[44];
+      makeWavHeader(h, info_, tx_bytes_);
+      fseek(tx_file_, 0, SEEK_SET);
+      fwrite(h, 1, sizeof(h), tx_file_);
+    }
+    if (tx_file_)
+      fclose(tx_file_);
+    rx_file_ = tx_file_ = nullptr;
+    active_ = false;
+  }
+
+  void I2SCodecStream::setAudioInfo(AudioInfo newInfo)
+  {
+    if (newInfo == info_)
+      return;
+    info_ = newInfo;
+    cfg_.copyFrom(newInfo);
+    pace_rem_us_ = 0;
+    if (active_ && (cfg_.rx_tx_mode & RX_MODE) && !rx_file_)
+      buildTone();
+  }
+
+  bool I2SCodecStream::setVolume(float vol)
+  {
+    volume_ = vol;
+    return board_ && board_->setVolume((int)(vol * 100.0f));
+  }
+
+  void I2SCodecStream::pace(size_t bytes)
+  {
+    if (!host::env().pace_i2s)
+      return;
+    size_t frame_bytes = (size_t)(cfg_.channels * storageBytes(cfg_.bits_per_sample));
+    pace_rem_us_ += (double)bytes / (double)frame_bytes * 1e6 / cfg_.sample_rate;
+    uint64_t whole = (uint64_t)pace_rem_us_;
+    pace_rem_us_ -= (double)whole;
+    if (whole)
+      host::advanceMicros(whole);
+  }
+
+  void I2SCodecStream::fillRx(uint8_t *data, size_t len)
+  {
+    if (rx_file_)
+    {
+      size_t done = 0;
+      while (done < len)
+      {
+        size_t n = fread(data + done, 1, len - done, rx_file_);
+        if (n == 0)
+        {
+          // 输入结束后循环播放
+          rewind(rx_file_);
+          if (fread(data + done, 1, 1, rx_file_) != 1)
+          {
+            memset(data + done, 0, len - done);
+            return;
+          }
+          n = 1;
+        }
+        done += n;
+      }
+      return;
+    }
+
+    // 合成正弦波：循环拷贝 begin() 时生成的整周期表
+    size_t done = 0;
+    while (done < len && !tone_.empty())
+    {
+      size_t n = std::min(len - done, tone_.size() - tone_pos_);
+      memcpy(data + done, tone_.data() + tone_pos_, n);
+      done += n;
+      tone_pos_ = (tone_pos_ + n) % tone_.size();
+    }
+  }
+
+  void I2SCodecStream::buildTone()
+  {
+    // 半幅度正弦波，所有通道相同；周期 = 采样率 / gcd(采样率, 频率) 帧
+    int bytes = storageBytes(cfg_.bits_per_sample);
+    size_t frame_bytes = (size_t)(bytes * cfg_.channels);
+    uint32_t rate = (uint32_t)cfg_.sample_rate;
+    uint32_t tone = host::env().rx_tone_hz;
+    uint32_t a = rate, b = tone;
+    while (b)
+    {
+      uint32_t t = a % b;
+      a = b;
+      b = t;
+    }
+    size_t frames = tone ? rate / a : 1;
+    double w = 2.0 * M_PI * tone / rate;
+
+    tone_.assign(frames * frame_bytes, 0);
+    tone_pos_ = 0;
+    for (size_t f = 0; f < frames; f++)
+    {
+      double s = 0.5 * sin(w * (double)f);
+      for (int ch = 0; ch < cfg_.channels; ch++)
+      {
+        uint8_t *p = &tone_[f * frame_bytes + (size_t)(ch * bytes)];
+        if (bytes == 2)
+          wr16(p, (uint16_t)(int16_t)lrint(s * 32767.0));
+        else if (cfg_.bits_per_sample == 24)
+          wr32(p, (uint32_t)(int32_t)lrint(s * 8388607.0));
+        else
+          wr32(p, (uint32_t)(int32_t)lrint(s * 2147483647.0));
+      }
+    }
+  }
+
+  size_t I2SCodecStream::readUnpaced(uint8_t *data, size_t len)
+  {
+    if (!active_ || !(cfg_.rx_tx_mode & RX_MODE))
+      return 0;
+    fillRx(data, len);
+    return len;
+  }
+
+  size_t I2SCodecStream::writeUnpaced(const uint8_t *data, size_t len)
+  {
+    if (!active_ || !(cfg_.rx_tx_mode & TX_MODE))
+      return 0;
+    if (tx_file_)
+      tx_bytes_ += (uint32_t)fwrite(data, 1, len, tx_file_);
+    return len;
+  }
+
+  size_t I2SCodecStream::readBytes(uint8_t *data, size_t len)
+  {
+    size_t n = readUnpaced(data, len);
+    pace(n);
+    return n;
+  }
+
+  size_t I2SCodecStream::write(const uint8_t *data, size_t len)
+  {
+    size_t n = writeUnpaced(data, len);
+    pace(n);
+    return n;
+  }
+
+  //===========================================================
+  // 文件系统音源
+  //===========================================================
+  void AudioSourceFS::begin()
+  {
+    files_.clear();
+    index_ = -1;
+    File dir = fs_->open(start_path_.c_str());
+    if (!dir || !dir.isDirectory())
+      return;
+    for (File f = dir.openNextFile(); f; f = dir.openNextFile())
+    {
+      std::string path = f.path();
+      if (!f.isDirectory() && path.size() >= ext_.size() &&
+          path.compare(path.size() - ext_.size(), ext_.size(), ext_) == 0)
+        files_.push_back(path);
+    }
+  }
+
+  Stream *AudioSourceFS::nextStream(int offset)
+  {
+    return selectStream(index_ + offset);
+  }
+
+  Stream *AudioSourceFS::selectStream(int index)
+  {
+    if (index < 0 || index >= (int)files_.size())
+      return nullptr;
+    index_ = index;
+    return selectStream(files_[(size_t)index].c_str());
+  }
+
+  Stream *AudioSourceFS::selectStream(const char *path)
+  {
+    file_.close();
+    file_ = fs_->open(path);
+    return file_ ? &file_ : nullptr;
+  }
+
+  //===========================================================
+  // 播放器
+  //===========================================================
+  AudioPlayer::AudioPlayer(AudioSource &source, AudioStream &output, AudioDecoder &decoder)
+      : source_(&source), output_(&output), decoder_(&decoder), buffer_(DEFAULT_BUFFER_SIZE) {}
+
+  bool AudioPlayer::begin(int index, bool isActive)
+  {
+    source_->begin();
+    decoder_->setOutput(*this);
+    decoder_->begin();
+    input_ = source_->selectStream(index);
+    active_ = isActive && input_ != nullptr;
+    return input_ != nullptr;
+  }
+
+  void AudioPlayer::end()
+  {
+    active_ = false;
+    decoder_->end();
+  }
+
+  bool AudioPlayer::setPath(const char *path)
+  {
+    decoder_->setOutput(*this);
+    decoder_->end();
+    decoder_->begin();
+    output_info_ = AudioInfo(0, 0, 0);
+    input_ = source_->selectStream(path);
+    active_ = input_ != nullptr;
+    return input_ != nullptr;
+  }
+
+  bool AudioPlayer::setVolume(float volume)
+  {
+    volume_ = std::max(0.0f, std::min(1.0f, volume));
+    return true;
+  }
+
+  size_t AudioPlayer::copy(size_t bytes)
+  {
+    if (!active_ || !input_)
+      return 0;
+    if (buffer_.size() < bytes)
+      buffer_.resize(bytes);
+    size_t n = input_->readBytes(buffer_.data(), bytes);
+    if (n == 0)
+    {
+      active_ = false;
+      return 0;
+    }
+    decoder_->write(buffer_.data(), n);
+    return n;
+  }
+
+  size_t AudioPlayer::copyAll()
+  {
+    size_t total = 0;
+    while (size_t n = copy())
+      total += n;
+    return total;
+  }
+
+  size_t AudioPlayer::write(const uint8_t *data, size_t len)
+  {
+    // 与 AudioTools 相同：解码器得到文件格式后通知输出链（BlockTxStream → ... → I2S）
+    AudioInfo info = decoder_->audioInfo();
+    if (info != output_info_)
+    {
+      output_->setAudioInfo(info);
+      output_info_ = info;
+    }
+    if (volume_ >= 1.0f)
+      return output_->write(data, len);
+
+    // 软件音量：按解码器输出格式逐采样缩放
+    int bits = decoder_->audioInfo().bits_per_sample;
+    scaled_.assign(data, data + len);
+    if (bits == 16)
+    {
+      for (size_t i = 0; i + 2 <= len; i += 2)
+        wr16(&scaled_[i], (uint16_t)(int16_t)lrintf((float)(int16_t)rd16(&scaled_[i]) * volume_));
+    }
+    else if (bits == 24 || bits == 32)
+    {
+      for (size_t i = 0; i + 4 <= len; i += 4)
+        wr32(&scaled_[i], (uint32_t)(int32_t)llrint((double)(int32_t)rd32(&scaled_[i]) * volume_));
+    }
+    return output_->write(scaled_.data(), len);
+  }
+}
+
+namespace host
+{
+  void finishAudio()
+  {
+    for (auto *stream : audio_tools::i2sStreams())
+      stream->end();
+  }
+}
@@ -0,0 +1,207 @@
+/**
+ * @file mock_fs.cpp
+ * @brief 主机模拟：SD / SPIFFS 文件系统，读写映射到主机目录
+ */
+#include "FS.h"
+#include "SD.h"
+#include "SPIFFS.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace stdfs = std::filesystem;
+
+namespace
+{
+  /**
+   * @brief 主机文件
+   */
+  class HostFileImpl : public fs::FileImpl
+  {
+  public:
+    HostFileImpl(FILE *fp, const std::string &path) : fp_(fp), path_(path) {}
+    ~HostFileImpl() override { close(); }
+
+    size_t write(const uint8_t *buf, size_t size) override { return fp_ ? fwrite(buf, 1, size, fp_) : 0; }
+    size_t read(uint8_t *buf, size_t size) override { return fp_ ? fread(buf, 1, size, fp_) : 0; }
+    bool seek(uint32_t pos, fs::SeekMode mode) override
+    {
+      static const int whence[] = {SEEK_SET, SEEK_CUR, SEEK_END};
+      return fp_ && fseek(fp_, (long)pos, whence[mode]) == 0;
+    }
+    size_t position() const override { return fp_ ? (size_t)ftell(fp_) : 0; }
+    size_t size() const override
+    {
+      if (!fp_)
+        return 0;
+      long cur = ftell(fp_);
+      fseek(fp_, 0, SEEK_END);
+      long end = ftell(fp_);
+      fseek(fp_, cur, SEEK_SET);
+      return (size_t)end;
+    }
+    void flush() override
+    {
+      if (fp_)
+        fflush(fp_);
+    }
+    void close() override
+    {
+      if (fp_)
+        fclose(fp_);
+      fp_ = nullptr;
+    }
+    const char *path() const override { return path_.c_str(); }
+
+  private:
+    FILE *fp_;
+    std::string path_;
+  };
+
+  /**
+   * @brief 主机目录（按文件名排序遍历）
+   */
+  class HostDirImpl : public fs::FileImpl
+  {
+  public:
+    HostDirImpl(fs::FS *owner, const std::string &host_dir, const std::string &path)
+        : owner_(owner), path_(path)
+    {
+      std::error_code ec;
+      for (auto &entry : stdfs::directory_iterator(host_dir, ec))
+        entries_.push_back(entry.path().filename().string());
+      std::sort(entries_.begin(), entries_.end());
+    }
+
+    size_t write(const uint8_t *, size_t) override { return 0; }
+    size_t read(uint8_t *, size_t) override { return 0; }
+    bool seek(uint32_t, fs::SeekMode) override { return false; }
+    size_t position() const override { return 0; }
+    size_t size() const override { return 0; }
+    void close() override {}
+    const char *path() const override { return path_.c_str(); }
+    bool isDirectory() const override { return true; }
+
+    fs::FileImplPtr openNextFile(const char *mode) override
+    {
+      while (next_ < entries_.size())
+      {
+        std::string child = path_ == "/" ? "/" + entries_[next_++] : path_ + "/" + entries_[next_++];
+        File f = owner_->open(child.c_str(), mode);
+        if (f)
+          return f.impl();
+      }
+      return nullptr;
+    }
+
+  private:
+    fs::FS *owner_;
+    std::string path_;
+    std::vector<std::string> entries_;
+    size_t next_ = 0;
+  };
+}
+
+namespace fs
+{
+  int File::read()
+  {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+  }
+
+  int File::peek()
+  {
+    if (!impl_)
+      return -1;
+    size_t pos = impl_->position();
+    int c = read();
+    impl_->seek((uint32_t)pos, SeekSet);
+    return c;
+  }
+
+  const char *File::name() const
+  {
+    const char *p = path();
+    const char *slash = strrchr(p, '/');
+    return slash ? slash + 1 : p;
+  }
+
+  std::string FS::hostPath(const char *path) const
+  {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/')
+      p = "/" + p;
+    return *root_ + p;
+  }
+
+  File FS::open(const char *path, const char *mode, bool create)
+  {
+    (void)create;
+    std::string host_path = hostPath(path);
+    FileImplPtr impl;
+
+    std::error_code ec;
+    if (stdfs::is_directory(host_path, ec))
+    {
+      impl = std::make_shared<HostDirImpl>(this, host_path, path);
+    }
+    else
+    {
+      // Arduino 的 "w" / "a" 对应主机的二进制模式
+      std::string host_mode = std::string(mode) + "b";
+      if (host_mode == "wb")
+        host_mode = "w+b";
+      FILE *fp = fopen(host_path.c_str(), host_mode.c_str());
+      if (!fp)
+        return File();
+      impl = std::make_shared<HostFileImpl>(fp, path);
+    }
+
+    if (open_hook_)
+    {
+      FileImplPtr hooked = open_hook_(impl, path, mode);
+      if (hooked)
+        impl = hooked;
+    }
+    return File(impl);
+  }
+
+  bool FS::exists(const char *path)
+  {
+    std::error_code ec;
+    return stdfs::exists(hostPath(path), ec);
+  }
+
+  bool FS::remove(const char *path)
+  {
+    std::error_code ec;
+    return stdfs::remove(hostPath(path), ec);
+  }
+
+  bool FS::mkdir(const char *path)
+  {
+    std::error_code ec;
+    return stdfs::create_directories(hostPath(path), ec) || stdfs::is_directory(hostPath(path), ec);
+  }
+
+  bool SDFS::begin(uint8_t ssPin, SPIClass &spi, uint32_t frequency, const char *mountpoint, uint8_t max_files,
+                   bool format_if_empty)
+  {
+    (void)ssPin, (void)spi, (void)frequency, (void)mountpoint, (void)max_files, (void)format_if_empty;
+    host::advanceMicros(host::env().sd_mount_us);
+    std::error_code ec;
+    mounted_ = stdfs::is_directory(*root_, ec);
+    return mounted_;
+  }
+
+  bool SPIFFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel)
+  {
+    (void)formatOnFail, (void)basePath, (void)maxOpenFiles, (void)partitionLabel;
+    std::error_code ec;
+    return stdfs::is_directory(*root_, ec);
+  }
+}
+
+fs::SDFS SD;
+fs::SPIFFSFS SPIFFS;
@@ -0,0 +1,104 @@
+/**
+ * @file sd_faults.cpp
+ * @brief 主机模拟：SD 卡故障注入实现
+ */
+#include "sd_faults.h"
+
+#include <random>
+
+namespace
+{
+  struct FaultState
+  {
+    host::SdFaultConfig cfg;
+    std::mt19937 rng;
+  };
+
+  FaultState s_state;
+  host::SdFaultStats s_stats;
+
+  uint32_t lognormal(double median_us, double sigma)
+  {
+    std::lognormal_distribution<double> d(std::log(median_us), sigma);
+    return (uint32_t)d(s_state.rng);
+  }
+
+  bool chance(double p)
+  {
+    return p > 0 && std::uniform_real_distribution<double>(0.0, 1.0)(s_state.rng) < p;
+  }
+
+  /**
+   * @brief 包装默认文件实现，在读写前后推进虚拟时钟
+   */
+  class FaultyFileImpl : public fs::FileImpl
+  {
+  public:
+    explicit FaultyFileImpl(fs::FileImplPtr inner) : inner_(inner) {}
+
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+      const host::SdFaultConfig &cfg = s_state.cfg;
+      uint32_t us = lognormal(cfg.write_median_us, cfg.write_sigma) + (uint32_t)(cfg.us_per_kb * size / 1024);
+      if (chance(cfg.stall_probability))
+      {
+        us += std::uniform_int_distribution<uint32_t>(cfg.stall_min_us, cfg.stall_max_us)(s_state.rng);
+        s_stats.stalls++;
+      }
+      if (size > 1 && chance(cfg.short_write_probability))
+      {
+        size = std::uniform_int_distribution<size_t>(1, size - 1)(s_state.rng);
+        s_stats.short_writes++;
+      }
+      s_stats.writes++;
+      s_stats.busy_us += us;
+      s_stats.write_latency.push_back(us);
+      host::advanceMicros(us);
+      return inner_->write(buf, size);
+    }
+
+    size_t read(uint8_t *buf, size_t size) override
+    {
+      const host::SdFaultConfig &cfg = s_state.cfg;
+      uint32_t us = lognormal(cfg.read_median_us, cfg.read_sigma) + (uint32_t)(cfg.us_per_kb * size / 1024);
+      if (chance(cfg.read_stall_probability))
+      {
+        us += std::uniform_int_distribution<uint32_t>(cfg.stall_min_us, cfg.stall_max_us)(s_state.rng);
+        s_stats.stalls++;
+      }
+      s_stats.reads++;
+      s_stats.busy_us += us;
+      s_stats.read_latency.push_back(us);
+      host::advanceMicros(us);
+      return inner_->read(buf, size);
+    }
+
+    bool seek(uint32_t pos, fs::SeekMode mode) override { return inner_->seek(pos, mode); }
+    size_t position() const override { return inner_->position(); }
+    size_t size() const override { return inner_->size(); }
+    void flush() override { inner_->flush(); }
+    void close() override { inner_->close(); }
+    const char *path() const override { return inner_->path(); }
+    bool isDirectory() const override { return inner_->isDirectory(); }
+    fs::FileImplPtr openNextFile(const char *mode) override { return inner_->openNextFile(mode); }
+
+  private:
+    fs::FileImplPtr inner_;
+  };
+}
+
+namespace host
+{
+  void enableSdFaults(fs::FS &fs, const SdFaultConfig &cfg)
+  {
+    s_state.cfg = cfg;
+    s_state.rng.seed(cfg.seed);
+    s_stats = SdFaultStats();
+    fs.setOpenHook([](fs::FileImplPtr file, const char *, const char *) -> fs::FileImplPtr
+                   { return file->isDirectory() ? nullptr : std::make_shared<FaultyFileImpl>(file); });
+  }
+
+  void disableSdFaults(fs::FS &fs) { fs.setOpenHook(nullptr); }
+
+  SdFaultStats &sdFaultStats() { return s_stats; }
+}
@@ -0,0 +1,57 @@
+/**
+ * @file sd_faults.h
+ * @brief 主机模拟：SD 卡延迟 / 停顿 / 部分写入故障注入
+ *
+ * 真实 SD 卡在内部垃圾回收时会随机停顿 100 ms 以上。启用后，
+ * 对该文件系统打开的每个文件的读写都会按配置的分布推进虚拟时钟，
+ * 并可能只完成部分写入（调用方需要处理返回值）。
+ */
+#pragma once
+
+#include "FS.h"
+
+#include <vector>
+
+namespace host
+{
+  struct SdFaultConfig
+  {
+    uint32_t seed = 1; // 随机种子（相同种子结果可复现）
+
+    // 正常访问延迟：对数正态分布（中位数 + 形状参数）
+    double write_median_us = 600;
+    double write_sigma = 0.6;
+    double read_median_us = 250;
+    double read_sigma = 0.4;
+    double us_per_kb = 40; // 与长度相关的传输时间
+
+    // 垃圾回收停顿：每次写入 / 读取的发生概率与均匀分布的时长
+    double stall_probability = 0.002;
+    double read_stall_probability = 0.0005;
+    uint32_t stall_min_us = 100000;
+    uint32_t stall_max_us = 250000;
+
+    // 部分写入：发生概率，写入长度在 [1, len) 内均匀分布
+    double short_write_probability = 0.0;
+  };
+
+  struct SdFaultStats
+  {
+    uint32_t writes = 0;
+    uint32_t reads = 0;
+    uint32_t stalls = 0;
+    uint32_t short_writes = 0;
+    uint64_t busy_us = 0;                 // 累计读写耗时
+    std::vector<uint32_t> write_latency;  // 每次写入耗时（微秒）
+    std::vector<uint32_t> read_latency;   // 每次读取耗时（微秒）
+  };
+
+  /** @brief 对文件系统启用故障注入（之后打开的文件生效） */
+  void enableSdFaults(fs::FS &fs, const SdFaultConfig &cfg);
+
+  /** @brief 关闭故障注入 */
+  void disableSdFaults(fs::FS &fs);
+
+  /** @brief 当前统计（enableSdFaults 时清零） */
+  SdFaultStats &sdFaultStats();
+}
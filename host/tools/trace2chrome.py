@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+trace2chrome.py - 把串口 "trace" 命令的输出转换为 Chrome trace / Perfetto JSON
+
+输入可以是完整的串口日志，脚本只解析 "# trace begin" 与 "# trace end" 之间的行
+（有多段时取最后一段）。时间戳为 32 位微秒（两个核心共用的 esp_timer）：
+按记录顺序以有符号差值展开回绕（核心之间 / 中断插入造成的少量乱序不会变成一次回绕），
+之后每个核心（中断单独一行）一个 tid，各自按时间排序后配对 B / E。
+输出文件可直接拖入 chrome://tracing 或 https://ui.perfetto.dev 查看。
+
+用法：
+  python3 host/tools/trace2chrome.py serial.log -o trace.json
+
+退出码：0 成功，2 输入中没有跟踪数据
+"""
+import argparse
+import json
+import re
+import sys
+
+
+def parse(lines):
+    """返回 (dropped, names, records)，records 为 (us, id, phase, arg, core, isr)"""
+    section = None
+    last = None
+    for line in lines:
+        line = line.strip()
+        if line.startswith("# trace begin"):
+            section = [line]
+        elif section is not None:
+            section.append(line)
+            if line.startswith("# trace end"):
+                last = section
+                section = None
+    if last is None:
+        return None
+
+    header = dict(re.findall(r"(\w+)=(\d+)", last[0]))
+    names = {}
+    records = []
+    for line in last[1:]:
+        parts = line.split()
+        if line.startswith("# event") and len(parts) == 4:
+            names[int(parts[2])] = parts[3]
+        elif parts and parts[0] == "T" and len(parts) == 7:
+            records.append((int(parts[1]), int(parts[2]), parts[3], int(parts[4]), int(parts[5]), int(parts[6])))
+    return int(header.get("dropped", 0)), names, records
+
+
+def unwrap(records):
+    """按记录顺序把 32 位微秒展开为单调时间轴：相邻两条的差值按有符号 32 位解释"""
+    t = 0
+    prev = None
+    out = []
+    for us, ev, phase, arg, core, isr in records:
+        if prev is not None:
+            d = (us - prev) & 0xFFFFFFFF
+            t += d - (1 << 32) if d >= (1 << 31) else d
+        prev = us
+        out.append((t, ev, phase, arg, core, isr))
+    base = min(r[0] for r in out) if out else 0
+    return [(r[0] - base,) + r[1:] for r in out]
+
+
+def tid_of(core, isr):
+    return core * 2 + 1 + isr
+
+
+def convert(names, records, pid=1):
+    events = []
+    threads = {}
+    for r in unwrap(records):
+        threads.setdefault(tid_of(r[4], r[5]), []).append(r)
+
+    for tid in sorted(threads):
+        core, isr = (tid - 1) // 2, (tid - 1) % 2
+        events.append({"name": "thread_name", "ph": "M", "pid": pid, "tid": tid,
+                       "args": {"name": "core %d%s" % (core, " isr" if isr else "")}})
+        depth = {}
+        t_end = 0
+        for ts, ev, phase, arg, _, _ in sorted(threads[tid], key=lambda r: r[0]):
+            t_end = ts
+            name = names.get(ev, "event_%d" % ev)
+            if phase == "B":
+                depth[ev] = depth.get(ev, 0) + 1
+            elif phase == "E":
+                # 环形缓冲区开头可能只有结束事件
+                if depth.get(ev, 0) == 0:
+                    continue
+                depth[ev] -= 1
+
+            e = {"name": name, "ph": "i" if phase == "I" else phase, "ts": ts, "pid": pid, "tid": tid,
+                 "args": {"bytes": arg}}
+            if phase == "I":
+                e["s"] = "t"
+            events.append(e)
+
+        # 末尾未结束的事件补一个结束
+        for ev, n in depth.items():
+            for _ in range(n):
+                events.append({"name": names.get(ev, "event_%d" % ev), "ph": "E", "ts": t_end, "pid": pid,
+                               "tid": tid})
+    return events
+
+
+def main():
+    ap = argparse.ArgumentParser(description="convert serial trace dump to Chrome trace JSON")
+    ap.add_argument("input", help="serial log containing a trace dump ('-' for stdin)")
+    ap.add_argument("-o", "--output", default="trace.json")
+    args = ap.parse_args()
+
+    src = sys.stdin if args.input == "-" else open(args.input, encoding="utf-8", errors="replace")
+    with src:
+        parsed = parse(src)
+    if parsed is None:
+        print("no trace dump found", file=sys.stderr)
+        return 2
+
+    dropped, names, records = parsed
+    events = convert(names, records)
+    with open(args.output, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ns", "otherData": {"dropped": dropped}}, f)
+    times = [e["ts"] for e in events if "ts" in e]
+    span = max(times) - min(times) if times else 0
+    print("%d records (%d dropped) -> %d events, %.3f ms -> %s" % (len(records), dropped, len(events), span / 1000,
+                                                                    args.output))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
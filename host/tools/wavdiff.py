@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+wavdiff.py - 比较两个 PCM WAV 文件（参考文件 vs 实际输出）
+
+默认要求逐位一致；--tolerance N 允许每个采样最多相差 N LSB，
+--min-snr DB 要求信噪比不低于 DB（用于定点 / SIMD 改写后的近似结果）。
+
+用法：
+  python3 host/tools/wavdiff.py golden.wav actual.wav [--tolerance N] [--min-snr DB]
+
+退出码：0 一致 / 在容差内，1 不一致，2 参数或格式错误
+"""
+import argparse
+import math
+import struct
+import sys
+import wave
+
+
+def read_pcm(path):
+    with wave.open(path, "rb") as w:
+        params = (w.getnchannels(), w.getsampwidth(), w.getframerate())
+        raw = w.readframes(w.getnframes())
+    width = params[1]
+    if width == 1:
+        samples = [b - 128 for b in raw]
+    elif width == 2:
+        samples = list(struct.unpack("<%dh" % (len(raw) // 2), raw))
+    elif width == 3:
+        samples = [int.from_bytes(raw[i:i + 3], "little", signed=True) for i in range(0, len(raw) - 2, 3)]
+    elif width == 4:
+        samples = list(struct.unpack("<%di" % (len(raw) // 4), raw))
+    else:
+        raise ValueError("unsupported sample width %d" % width)
+    return params, samples
+
+
+def main():
+    ap = argparse.ArgumentParser(description="compare two PCM WAV files")
+    ap.add_argument("golden")
+    ap.add_argument("actual")
+    ap.add_argument("--tolerance", type=int, default=0, help="max abs difference per sample (LSB)")
+    ap.add_argument("--min-snr", type=float, default=None, help="minimum SNR in dB")
+    args = ap.parse_args()
+
+    try:
+        gp, g = read_pcm(args.golden)
+        ap_, a = read_pcm(args.actual)
+    except (wave.Error, ValueError, OSError) as e:
+        print("error: %s" % e)
+        return 2
+
+    if gp != ap_:
+        print("format mismatch: golden %s, actual %s (channels, width, rate)" % (gp, ap_))
+        return 1
+    if len(g) != len(a):
+        print("length mismatch: golden %d samples, actual %d samples" % (len(g), len(a)))
+        return 1
+
+    max_err = 0
+    first_err = -1
+    sig = noise = 0.0
+    for i, (x, y) in enumerate(zip(g, a)):
+        d = abs(x - y)
+        if d > max_err:
+            max_err = d
+        if d > args.tolerance and first_err < 0:
+            first_err = i
+        sig += float(x) * x
+        noise += float(d) * d
+    snr = float("inf") if noise == 0 else 10.0 * math.log10(max(sig, 1.0) / noise)
+
+    print("samples %d, max error %d LSB, SNR %s dB" % (len(g), max_err, "inf" if math.isinf(snr) else "%.2f" % snr))
+    if first_err >= 0:
+        print("first sample over tolerance: %d (frame %d)" % (first_err, first_err // gp[0]))
+        return 1
+    if args.min_snr is not None and snr < args.min_snr:
+        print("SNR below %.2f dB" % args.min_snr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
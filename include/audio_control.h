@@ -0,0 +1,95 @@
+/**
+ * @file audio_control.h
+ * @brief 录音 / 播放的命令队列与状态机（control，在 loop() 中运行，不阻塞）
+ *
+ * 命令（串口或其他任务）放入队列，audioControlStep() 每次 loop() 执行一步：
+ *   Idle ──record──▶ Recording ──完成 / stop──▶ Idle（写 WAV 头、关闭文件）
+ *   Idle ──play────▶ Playing   ──完成 / stop──▶ Idle
+ * 录音 / 播放由 audio 与 storage 任务完成（audio_tasks.h），状态切换只做打开文件与设置参数；
+ * 忙时 record / play 在队列中等待，stop 立即生效并丢弃在它之前排队的命令，stats 按顺序输出。
+ */
+#pragma once
+
+#include "AudioTools.h"
+#include "FS.h"
+#include "block_fanout.h"
+
+// 命令队列深度（2 的幂）
+#ifndef AUDIO_COMMAND_QUEUE_DEPTH
+#define AUDIO_COMMAND_QUEUE_DEPTH 8
+#endif
+
+#define AUDIO_COMMAND_PATH_LENGTH 48
+
+// loop() 空闲等待上限（串口命令的最大响应延迟；录音 / 播放完成时立即唤醒）
+#ifndef AUDIO_CONTROL_POLL_MS
+#define AUDIO_CONTROL_POLL_MS 10
+#endif
+
+enum class AudioCommandType : uint8_t
+{
+  Record, // 录音 seconds 秒到 AudioControlConfig::record_path
+  Play,   // 播放 path
+  Stop,   // 停止当前录音 / 播放，丢弃之前排队的命令
+  Stats   // 输出状态与流水线统计
+};
+
+struct AudioCommand
+{
+  AudioCommandType type;
+  uint16_t seconds;
+  uint16_t epoch; // stop 计数（audioCommandPost 填写），早于最近一次 stop 的命令被丢弃（回绕安全比较）
+  char path[AUDIO_COMMAND_PATH_LENGTH];
+};
+
+enum class AudioControlState : uint8_t
+{
+  Idle,
+  Recording,
+  Playing
+};
+
+/**
+ * @brief 状态机使用的对象（由 setup() 提供，生命周期为整个程序）
+ */
+struct AudioControlConfig
+{
+  fs::FS *record_fs;       // 录音文件所在的文件系统
+  fs::FS *play_fs;         // 播放器音源所在的文件系统（播放前检查 WAV 头）
+  const char *record_path; // 录音文件路径
+  AudioEncoder *encoder;   // WAV 编码器
+  AudioInfo info;          // 录音格式
+  AudioStream *i2s;        // I2S 流：播放会把它切换到文件的格式，录音开始前恢复 info
+  uint16_t record_seconds; // record 不带参数时的录音秒数
+  AudioPlayer *player;
+  LevelMeterSink *level; // 录音电平表（完成时输出峰值 / RMS）
+  Print *out;            // 状态输出（串口）
+};
+
+void audioControlBegin(const AudioControlConfig &config);
+
+/**
+ * @brief 解析命令行：record [秒]、play [路径]（默认录音文件）、stop、stats
+ * @return false: 不是状态机命令
+ */
+bool audioCommandParse(const char *line, AudioCommand &cmd);
+
+/**
+ * @brief 放入命令队列（可在任何任务中调用）；stop 不排队，下一步立即执行
+ * @return false: 队列已满
+ */
+bool audioCommandPost(const AudioCommand &cmd);
+
+bool audioCommandPostRecord(uint16_t seconds);
+bool audioCommandPostPlay(const char *path);
+
+/**
+ * @brief 执行一步：检查录音 / 播放是否完成，执行可以开始的命令（在 loop() 中调用）
+ */
+void audioControlStep();
+
+/** @brief 空闲且没有排队的命令 */
+bool audioControlIdle();
+
+AudioControlState audioControlState();
+const char *audioControlStateName(AudioControlState state);
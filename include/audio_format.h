@@ -0,0 +1,53 @@
+/**
+ * @file audio_format.h
+ * @brief 编译期音频格式：采样率 / 通道数 / 字长只写一次，帧大小、块帧数、采样数与采样类型由它推导
+ *
+ *   using RecordFormat = AudioFormat<16000, 1, 32>;
+ *   AudioInfo info = RecordFormat::info();
+ *   RecordFormat::bytes(5)   // 5 秒的字节数
+ *
+ * 不合法的组合（字长、通道数、块大小不是整帧）在编译时报错。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "AudioTools.h"
+#include "block_pool.h"
+
+template <uint32_t Rate, uint16_t Channels, uint8_t Bits>
+struct AudioFormat
+{
+  static_assert(Rate >= 8000 && Rate <= 96000, "采样率超出 ES8311 支持的范围");
+  static_assert(Channels == 1 || Channels == 2, "只支持单声道 / 立体声");
+  static_assert(Bits == 16 || Bits == 32, "字长只支持 16 / 32 位（24 位数据按 32 位左对齐传输）");
+
+  static constexpr uint32_t sample_rate = Rate;
+  static constexpr uint16_t channels = Channels;
+  static constexpr uint8_t bits_per_sample = Bits;
+  static constexpr size_t bytes_per_sample = Bits / 8;
+  static constexpr size_t frame_bytes = bytes_per_sample * Channels;
+
+  /** @brief 采样类型（int16_t / int32_t） */
+  using sample_t = std::conditional_t<Bits == 16, int16_t, int32_t>;
+  static_assert(sizeof(sample_t) == bytes_per_sample, "采样类型与字长不一致");
+
+  /** @brief 一个 DMA 块（AUDIO_DMA_BLOCK_SIZE 字节）的帧数与时长 */
+  static constexpr size_t block_frames = AUDIO_DMA_BLOCK_SIZE / frame_bytes;
+  static constexpr uint32_t block_us = (uint32_t)((uint64_t)block_frames * 1000000ULL / Rate);
+  static_assert(AUDIO_DMA_BLOCK_SIZE % frame_bytes == 0, "AUDIO_DMA_BLOCK_SIZE 必须是整数帧");
+
+  /** @brief seconds 秒的帧数 / 采样数（所有通道）/ 字节数 */
+  static constexpr size_t frames(uint32_t seconds) { return (size_t)seconds * Rate; }
+  static constexpr size_t samples(uint32_t seconds) { return frames(seconds) * Channels; }
+  static constexpr size_t bytes(uint32_t seconds) { return frames(seconds) * frame_bytes; }
+
+  static AudioInfo info() { return AudioInfo(Rate, Channels, Bits); }
+};
+
+// 录音格式：SPH0645 LM4H，单声道，16kHz，32bit PCM（采样字节数、块帧数、audio 任务的处理内核都由它推导）
+using RecordFormat = AudioFormat<16000, 1, 32>;
@@ -0,0 +1,212 @@
+/**
+ * @file audio_stats.h
+ * @brief 音频流水线统计：各阶段计数、SD 写入延迟分布、高水位
+ *
+ * 热路径只做 relaxed 原子加 / 取最大值，不加锁、不格式化；
+ * 串口命令 "stats" 时才由 audioStatsToJson() 生成 JSON。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+#include "AudioTools.h"
+#include "audio_trace.h"
+#include "deferred_log.h"
+
+//===========================================================
+// 延迟直方图（对数分桶，每个 2 的幂再分 4 个子桶，精度约 ±12%）
+//===========================================================
+#define LATENCY_HIST_SUB_BUCKETS 4
+#define LATENCY_HIST_BUCKETS (32 * LATENCY_HIST_SUB_BUCKETS)
+
+struct LatencyHistogram
+{
+  std::atomic<uint32_t> buckets[LATENCY_HIST_BUCKETS];
+  std::atomic<uint32_t> count;
+  std::atomic<uint32_t> max_us;
+
+  /** @brief 记录一次延迟（微秒） */
+  void record(uint32_t us);
+
+  /** @brief 估算分位值（0..100），返回所在桶的上界 */
+  uint32_t percentile(float p) const;
+
+  void reset();
+};
+
+//===========================================================
+// 统计项
+//===========================================================
+struct AudioStats
+{
+  // I2S
+  std::atomic<uint32_t> i2s_rx_bytes;  // I2S 读取字节数
+  std::atomic<uint32_t> i2s_tx_bytes;  // I2S 写入字节数
+  std::atomic<uint32_t> short_reads;   // 读取不足一个缓冲区的次数
+  std::atomic<uint32_t> overruns;      // 两次读取间隔超过 DMA 缓冲时长（RX 数据可能被覆盖）
+  std::atomic<uint32_t> underruns;     // 两次写入间隔超过 DMA 缓冲时长（TX 可能输出空数据）
+  std::atomic<uint32_t> rx_gap_max_us; // 高水位：两次读取的最大间隔（= RX DMA 缓冲最高占用，按时间计）
+  std::atomic<uint32_t> tx_block_max;  // 高水位：单次 I2S 写入的最大字节数
+  std::atomic<uint32_t> rx_dropped_blocks; // 丢弃的录音块：块池耗尽，或分发时消费者拒收（录音队列满）
+  LatencyHistogram rx_jitter;              // 读取间隔与数据时长之差（抖动）分布
+
+  // 编码器
+  std::atomic<uint32_t> encoder_bytes; // 送入编码器的 PCM 字节数
+
+  // SD 卡
+  std::atomic<uint32_t> sd_writes;       // 写入次数
+  std::atomic<uint32_t> sd_write_bytes;  // 写入字节数
+  std::atomic<uint32_t> sd_short_writes; // 写入不完整次数
+  LatencyHistogram sd_write_latency;     // 写入耗时分布
+
+  // 内部：上一次 I2S 读取 / 写入完成的时间与 DMA 缓冲时长
+  std::atomic<uint32_t> last_read_us;
+  std::atomic<uint32_t> last_write_us;
+  std::atomic<uint32_t> dma_budget_us;
+  std::atomic<uint32_t> byte_rate; // I2S 每秒字节数
+};
+
+extern AudioStats g_audio_stats;
+
+//===========================================================
+// 热路径更新（relaxed 原子操作）
+//===========================================================
+static inline void statAdd(std::atomic<uint32_t> &counter, uint32_t value)
+{
+  counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+static inline void statMax(std::atomic<uint32_t> &mark, uint32_t value)
+{
+  uint32_t cur = mark.load(std::memory_order_relaxed);
+  while (value > cur && !mark.compare_exchange_weak(cur, value, std::memory_order_relaxed))
+  {
+  }
+}
+
+/**
+ * @brief 记录一次 I2S 读取：字节数、是否读取不足、与上次读取的间隔
+ */
+static inline void statI2SRead(size_t requested, size_t got)
+{
+  AudioStats &s = g_audio_stats;
+  statAdd(s.i2s_rx_bytes, (uint32_t)got);
+  if (got < requested)
+    statAdd(s.short_reads, 1);
+
+  uint32_t now = micros();
+  uint32_t last = s.last_read_us.exchange(now, std::memory_order_relaxed);
+  if (last)
+  {
+    uint32_t gap = now - last;
+    statMax(s.rx_gap_max_us, gap);
+    uint32_t rate = s.byte_rate.load(std::memory_order_relaxed);
+    if (rate)
+    {
+      uint32_t expect = (uint32_t)((uint64_t)got * 1000000ULL / rate);
+      s.rx_jitter.record(gap > expect ? gap - expect : expect - gap);
+    }
+    uint32_t budget = s.dma_budget_us.load(std::memory_order_relaxed);
+    if (budget && gap > budget)
+    {
+      statAdd(s.overruns, 1);
+      DLOG("i2s rx overrun: gap %u us > %u us", gap, budget);
+    }
+  }
+}
+
+/**
+ * @brief 记录一次 I2S 写入：字节数、单次最大写入、与上次写入的间隔
+ */
+static inline void statI2SWrite(size_t written)
+{
+  AudioStats &s = g_audio_stats;
+  statAdd(s.i2s_tx_bytes, (uint32_t)written);
+  statMax(s.tx_block_max, (uint32_t)written);
+
+  uint32_t now = micros();
+  uint32_t last = s.last_write_us.exchange(now, std::memory_order_relaxed);
+  uint32_t budget = s.dma_budget_us.load(std::memory_order_relaxed);
+  if (last && budget && now - last > budget)
+  {
+    statAdd(s.underruns, 1);
+    DLOG("i2s tx underrun: gap %u us > %u us", now - last, budget);
+  }
+}
+
+/**
+ * @brief 设置 DMA 缓冲时长（buffer_count * buffer_size 对应的音频时长），用于判断溢出 / 欠载；
+ *        同时记录字节速率，用于计算读取抖动
+ */
+void audioStatsSetDmaBudget(const AudioInfo &info, int buffer_count, int buffer_size);
+
+/** @brief 新一段录音 / 播放开始：清除间隔基准，避免把段间空闲算作溢出或欠载 */
+static inline void statI2SRestart()
+{
+  g_audio_stats.last_read_us.store(0, std::memory_order_relaxed);
+  g_audio_stats.last_write_us.store(0, std::memory_order_relaxed);
+}
+
+/** @brief 清零全部统计 */
+void audioStatsReset();
+
+/**
+ * @brief 生成 JSON 文本
+ * @return 写入的字符数（不含结尾 0）
+ */
+size_t audioStatsToJson(char *buf, size_t len);
+
+//===========================================================
+// 统计包装
+//===========================================================
+/**
+ * @brief 文件输出包装：统计 SD 写入次数、字节数、延迟与不完整写入
+ */
+class StatsFileSink : public Print
+{
+public:
+  explicit StatsFileSink(Print &out) : out_(&out) {}
+
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *data, size_t len) override;
+  void flush() override { out_->flush(); }
+
+private:
+  Print *out_;
+};
+
+/**
+ * @brief 输出流包装：统计 I2S 写入字节数、单次最大写入与欠载
+ *
+ * 放在 AudioPlayer 与 I2SCodecStream 之间，其余调用全部转发。
+ */
+class StatsOutputStream : public AudioStream
+{
+public:
+  explicit StatsOutputStream(AudioStream &out) : out_(&out) {}
+
+  bool begin() override { return out_->begin(); }
+  void end() override { out_->end(); }
+  void setAudioInfo(AudioInfo newInfo) override { out_->setAudioInfo(newInfo); }
+  AudioInfo audioInfo() override { return out_->audioInfo(); }
+  int availableForWrite() override { return out_->availableForWrite(); }
+  int available() override { return out_->available(); }
+  size_t readBytes(uint8_t *data, size_t len) override { return out_->readBytes(data, len); }
+
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *data, size_t len) override
+  {
+    TRACE_BEGIN(I2sWrite, len);
+    size_t n = out_->write(data, len);
+    TRACE_END(I2sWrite, n);
+    statI2SWrite(n);
+    return n;
+  }
+
+private:
+  AudioStream *out_;
+};
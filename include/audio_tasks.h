@@ -0,0 +1,131 @@
+/**
+ * @file audio_tasks.h
+ * @brief 录音 / 播放在 audio 与 storage 两个任务之间的分工（任务配置见 task_plan.h）
+ *
+ * 录音：audio   I2S 读取 → 块 → 分发（电平表等在 audio 中完成，storage 队列）
+ *       storage 从队列取块 → WAV 编码器 → SD
+ * 播放：storage SD → WAV 解码 → BlockTxStream（打包成块 → TX 队列）
+ *       audio   从 TX 队列取块 → I2S 写入
+ *
+ * SD 写入停顿只会让队列变长，不会推迟 I2S 读取；control（loop）只负责切换状态，
+ * 用 audioBusy() 查询完成（audio_control.h 的状态机），不等待。
+ */
+#pragma once
+
+#include "AudioTools.h"
+#include "block_fanout.h"
+#include "task_plan.h"
+
+// 录音块队列深度（audio → storage），需小于 DMA 块池的块数。
+// 按 sd_stall 基准（100–250 ms 停顿，p=0.002，600 秒）：录音 p99.9 需要 31 块，最坏 56 块（连续停顿），取 64（512 ms）
+#ifndef AUDIO_RX_QUEUE_DEPTH
+#define AUDIO_RX_QUEUE_DEPTH 64
+#endif
+
+// 播放块队列深度（storage → audio）
+#ifndef AUDIO_TX_QUEUE_DEPTH
+#define AUDIO_TX_QUEUE_DEPTH 4
+#endif
+
+static_assert(AUDIO_RX_QUEUE_DEPTH + AUDIO_TX_QUEUE_DEPTH < AUDIO_DMA_BLOCK_COUNT, "队列深度超过 DMA 块池");
+
+/**
+ * @brief 播放器输出：把解码后的数据打包成块放入 TX 队列，由 audio 任务写入 I2S
+ *
+ * 音频格式相关的调用（setAudioInfo / audioInfo）直接转发给 I2S 输出。
+ */
+class BlockTxStream : public AudioStream
+{
+public:
+  explicit BlockTxStream(AudioStream &i2s) : i2s_(&i2s) {}
+
+  void setAudioInfo(AudioInfo newInfo) override { i2s_->setAudioInfo(newInfo); }
+  AudioInfo audioInfo() override { return i2s_->audioInfo(); }
+
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *data, size_t len) override;
+
+  /** @brief 把未满的块送入队列 */
+  void flush() override;
+
+private:
+  void push(AudioBlock *block);
+
+  AudioStream *i2s_;
+  AudioBlock *current_ = nullptr;
+};
+
+/**
+ * @brief 启动 audio 与 storage 任务
+ *
+ * @param i2s_in    I2S 输入（录音）
+ * @param i2s_out   I2S 输出（播放，通常为统计包装）
+ * @param player    播放器（输出为 tx）
+ * @param rx_fanout 录音块分发器（storage 队列由这里添加）
+ * @param tx        播放器的输出流
+ */
+bool audioTasksBegin(Stream &i2s_in, Print &i2s_out, AudioPlayer &player, BlockFanout &rx_fanout, BlockTxStream &tx);
+
+/**
+ * @brief 开始录音（在 control 中调用，立即返回）
+ *
+ * encoder 在 audioBusy() 变为 false 之前必须有效。
+ * @return false: 正在录音 / 播放
+ */
+bool audioRecordStart(Print &encoder, size_t total_samples);
+
+/**
+ * @brief 开始播放播放器当前的文件（已 setPath / play），立即返回
+ * @return false: 正在录音 / 播放
+ */
+bool audioPlayStart();
+
+/** @brief 录音 / 播放进行中（包括写出队列中剩余的块） */
+bool audioBusy();
+
+/**
+ * @brief 停止录音 / 播放：已读取 / 已解码的块照常写出，之后 audioBusy() 变为 false
+ */
+void audioStop();
+
+/** @brief 最近一次录音已交给编码器的采样数 */
+size_t audioRecordedSamples();
+
+/** @brief 最近一次录音丢弃的块数（块池耗尽或录音队列满；这些块没有写入文件） */
+uint32_t audioRecordDroppedBlocks();
+
+/**
+ * @brief 录音，直到全部数据交给编码器才返回
+ *
+ * @return 录制的采样数
+ */
+size_t audioRecord(Print &encoder, size_t total_samples);
+
+/**
+ * @brief 播放播放器当前的文件（已 setPath / play），直到全部数据写入 I2S 才返回
+ */
+void audioPlay();
+
+//===========================================================
+// 增益与滤波：优先交给 ES8311 硬件（不占 CPU），不可用时退回软件处理
+// （在 control 中、录音 / 播放之间调用）
+//===========================================================
+/**
+ * @brief 录音增益：ES8311 ADC 数字音量；否则在 audio 任务中软件处理（InputDsp）
+ * @return true: 由硬件处理
+ */
+bool audioSetInputGainDb(float db);
+
+/**
+ * @brief 录音直流去除：ES8311 ADC 高通；否则软件高通（InputDsp）
+ * @return true: 由硬件处理
+ */
+bool audioSetInputHpf(bool enable);
+
+/**
+ * @brief 播放音量 0..1：ES8311 DAC 数字音量（与驱动 setVolume 的刻度相同）；
+ *        否则播放器软件音量，按同一寄存器刻度的 dB 换算为线性倍数（最高 0 dB）
+ * @return true: 由硬件处理
+ */
+bool audioSetOutputVolume(float volume);
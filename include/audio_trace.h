@@ -0,0 +1,169 @@
+/**
+ * @file audio_trace.h
+ * @brief 轻量级跟踪点：微秒时间戳 + 核心号 + 事件 ID，写入静态环形缓冲区
+ *
+ * 每个跟踪点只做：读时间与核心号、原子递增写指针、写 8 字节，不加锁、不格式化。
+ * 时间取 esp_timer（两个核心共用、不随动态调频变化），不用各核独立、频率可变的 CCOUNT：
+ * AUDIO_PM=1 时 CCOUNT 的频率在 80 / 240 MHz 之间切换，导出时无法换算。代价是 1 µs 分辨率
+ * （短于 1 µs 的区间显示为 0）与每个跟踪点一次 esp_timer_get_time() 调用；
+ * 串口命令 "trace cost" 在当前频率下测量跟踪点与时间戳各自的耗时。
+ * 读时间与取得槽位之间可能被另一核心或中断插入，导出的条目不保证按时间排序，由转换脚本按核心排序。
+ * 串口命令 "trace" 导出文本，host/tools/trace2chrome.py 转换为 Chrome trace / Perfetto JSON。
+ *
+ * 编译时以 -D AUDIO_TRACE=0 关闭，跟踪宏展开为空。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#endif
+
+#ifndef AUDIO_TRACE
+#define AUDIO_TRACE 1
+#endif
+
+// 环形缓冲区条目数（2 的幂），每条 8 字节
+#ifndef AUDIO_TRACE_ENTRIES
+#define AUDIO_TRACE_ENTRIES 1024
+#endif
+
+static_assert((AUDIO_TRACE_ENTRIES & (AUDIO_TRACE_ENTRIES - 1)) == 0, "AUDIO_TRACE_ENTRIES 必须是 2 的幂");
+
+/**
+ * @brief 跟踪事件
+ */
+enum class TraceEvent : uint8_t
+{
+  None,
+  I2sRead,      // I2S readBytes
+  EncoderWrite, // encoder.write
+  FileWrite,    // File::write（SD 写入）
+  PlayerCopy,   // player->copy
+  I2sWrite,     // I2S write（播放器输出）
+  DmaRx,        // I2S RX DMA 回调
+  DmaTx,        // I2S TX DMA 回调
+  Count
+};
+
+/**
+ * @brief 事件阶段
+ */
+enum class TracePhase : uint8_t
+{
+  Begin,
+  End,
+  Instant
+};
+
+// TraceEntry::ctx 的位：阶段、核心号、是否在中断中记录
+#define TRACE_CTX_PHASE_MASK 0x03
+#define TRACE_CTX_CORE_SHIFT 4
+#define TRACE_CTX_ISR 0x80
+
+struct TraceEntry
+{
+  uint32_t us;  // 记录时间（微秒，32 位回绕约 71 分钟，由转换脚本展开）
+  uint16_t arg; // 事件参数（通常为字节数，超出时截断为 0xFFFF）
+  uint8_t event;
+  uint8_t ctx; // 低 2 位：TracePhase；位 4..5：核心号；位 7：中断中记录
+};
+
+struct TraceRing
+{
+  TraceEntry entries[AUDIO_TRACE_ENTRIES];
+  std::atomic<uint32_t> head; // 累计写入条数
+  std::atomic<bool> enabled;
+};
+
+extern TraceRing g_trace;
+
+/**
+ * @brief 跟踪时间戳（微秒）：ESP32 为 esp_timer（可在中断中调用），主机为虚拟时钟
+ */
+static inline uint32_t traceMicros()
+{
+#if defined(HOST_BUILD)
+  return (uint32_t)host::nowMicros();
+#elif defined(ESP_PLATFORM)
+  return (uint32_t)esp_timer_get_time();
+#else
+  return micros();
+#endif
+}
+
+/**
+ * @brief 当前核心号与是否在中断中（TraceEntry::ctx 的高位）
+ */
+static inline uint8_t traceContext()
+{
+#if defined(ESP_PLATFORM)
+  return (uint8_t)((xPortGetCoreID() << TRACE_CTX_CORE_SHIFT) | (xPortInIsrContext() ? TRACE_CTX_ISR : 0));
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief 写入一条跟踪记录到指定的环形缓冲区（可在 ISR 中调用）
+ */
+static inline void traceRecordTo(TraceRing &ring, TraceEvent event, TracePhase phase, size_t arg)
+{
+  if (!ring.enabled.load(std::memory_order_relaxed))
+    return;
+  uint8_t ctx = (uint8_t)(traceContext() | (uint8_t)phase);
+  uint32_t us = traceMicros();
+  uint32_t i = ring.head.fetch_add(1, std::memory_order_relaxed) & (AUDIO_TRACE_ENTRIES - 1);
+  TraceEntry &e = ring.entries[i];
+  e.us = us;
+  e.arg = arg > 0xFFFF ? 0xFFFF : (uint16_t)arg;
+  e.event = (uint8_t)event;
+  e.ctx = ctx;
+}
+
+/**
+ * @brief 写入一条跟踪记录（可在 ISR 中调用）
+ */
+static inline void traceRecord(TraceEvent event, TracePhase phase, size_t arg)
+{
+  traceRecordTo(g_trace, event, phase, arg);
+}
+
+#if AUDIO_TRACE
+#define TRACE_BEGIN(ev, arg) traceRecord(TraceEvent::ev, TracePhase::Begin, (arg))
+#define TRACE_END(ev, arg) traceRecord(TraceEvent::ev, TracePhase::End, (arg))
+#define TRACE_INSTANT(ev, arg) traceRecord(TraceEvent::ev, TracePhase::Instant, (arg))
+#else
+#define TRACE_BEGIN(ev, arg) ((void)0)
+#define TRACE_END(ev, arg) ((void)0)
+#define TRACE_INSTANT(ev, arg) ((void)0)
+#endif
+
+/** @brief 事件名称（导出与转换脚本使用） */
+const char *traceEventName(TraceEvent event);
+
+/** @brief 清空环形缓冲区 */
+void traceClear();
+
+/**
+ * @brief 测量跟踪点的开销（当前 CPU 频率下，写入临时缓冲区，不影响 g_trace）
+ *
+ * 输出 JSON：{"point_ns":..,"timestamp_ns":..,"cpu_mhz":..}
+ * point_ns 为一次 traceRecord 的平均耗时（含时间戳），timestamp_ns 为其中 traceMicros 的部分。
+ * @return 写入的字符数（不含结尾 0）
+ */
+size_t traceCostToJson(char *buf, size_t len);
+
+/**
+ * @brief 按写入顺序导出环形缓冲区（导出期间暂停记录）
+ *
+ * 格式（逐行）：
+ *   # trace begin timebase=us entries=N dropped=M
+ *   # event <id> <name>
+ *   T <us> <id> <B|E|I> <arg> <core> <isr>
+ *   # trace end
+ */
+void traceDump(Print &out);
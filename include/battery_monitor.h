@@ -0,0 +1,132 @@
+/**
+ * @file battery_monitor.h
+ * @brief 电池电压监视：ADC 连续（DMA）采样 + IIR 平均，电量区间变化时才更新 LED
+ *
+ * 代替旧程序（新建 文本文档.txt）中 Synchronizing_Tasks 的 while(true) analogRead 忙循环：
+ *  - Arduino-ESP32 3.x：analogContinuous 以 BATTERY_ADC_SAMPLE_HZ 采样，每 BATTERY_ADC_FRAME 次转换
+ *    产生一次中断（约 10 次 / 秒），batteryMonitorPoll() 只在有新帧时读取帧平均值
+ *  - 2.x 与主机构建：每 BATTERY_POLL_MS 调用一次 analogReadMilliVolts
+ * platformio.ini 的 platform = espressif32（官方平台）目前提供 Arduino-ESP32 2.x，
+ * 所以设备构建实际使用轮询；连续模式只在换用 3.x 平台后启用。
+ * 不占用任务：batteryMonitorPoll() 在 loop() 中调用，没有新数据时立即返回。
+ *
+ * 电量 0..255：校准后的电池电压在 BATTERY_EMPTY_MV..BATTERY_FULL_MV 之间线性映射。
+ * 刻度与旧程序不同：旧程序把 analogRead 的原始计数（下限 2500，上限 BATTERY_CAPACITY_MAX）
+ * 映射到 0..255，不经过校准也不计分压，因此区间阈值不能直接沿用旧程序的数值。
+ * 区间 Ok / Half / Low 带滞回，LED 只在区间变化时写入（低电平点亮，与旧程序相同）。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+// ADC 引脚与分压（电池电压 = 引脚电压 × BATTERY_DIVIDER）
+#ifndef BATTERY_ADC_PIN
+#define BATTERY_ADC_PIN 1
+#endif
+#ifndef BATTERY_DIVIDER
+#define BATTERY_DIVIDER 2
+#endif
+
+// 电量刻度（电池电压，mV）
+#define BATTERY_EMPTY_MV 3300
+#define BATTERY_FULL_MV 4200
+
+// 区间阈值（电量 0..255）与回升所需的滞回
+#define BATTERY_HALF_LEVEL 128
+#define BATTERY_WARNING_LEVEL 40
+#define BATTERY_HYSTERESIS 8
+
+// IIR 平均：y += (x - y) / 2^SHIFT（每帧一次，约 10 帧 / 秒时时间常数约 0.8 s）
+#define BATTERY_IIR_SHIFT 3
+
+// 连续采样：采样率（ESP32-S3 最低约 611 Hz）与每帧转换次数
+#define BATTERY_ADC_SAMPLE_HZ 1000
+#define BATTERY_ADC_FRAME 100
+
+// 单次读取的周期（没有连续模式时）
+#define BATTERY_POLL_MS 100
+
+// 电量 LED（-1：不使用）：Half 时点亮 HALF，Low 时两个都点亮。
+// 对应旧程序的 VBAT_LED3（HALF）与 VBAT_LED2（LOW），但旧程序没有给出引脚号，默认不驱动；
+// 需要 LED 时用 -D BATTERY_LED_HALF_PIN=.. -D BATTERY_LED_LOW_PIN=.. 指定
+#ifndef BATTERY_LED_HALF_PIN
+#define BATTERY_LED_HALF_PIN -1
+#endif
+#ifndef BATTERY_LED_LOW_PIN
+#define BATTERY_LED_LOW_PIN -1
+#endif
+
+#if !defined(HOST_BUILD) && defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+#define BATTERY_ADC_CONTINUOUS 1
+#else
+#define BATTERY_ADC_CONTINUOUS 0
+#endif
+
+/**
+ * @brief 整数 IIR 平均（Q8 定点），第一个样本直接作为初值
+ */
+class BatteryFilter
+{
+public:
+  void reset() { primed_ = false; }
+
+  /** @brief 加入一个样本（mV），返回平均值（mV） */
+  uint32_t update(uint32_t mv)
+  {
+    int32_t x = (int32_t)(mv << 8);
+    if (!primed_)
+    {
+      acc_ = x;
+      primed_ = true;
+    }
+    else
+    {
+      acc_ += (x - acc_) / (1 << BATTERY_IIR_SHIFT);
+    }
+    return millivolts();
+  }
+
+  uint32_t millivolts() const { return (uint32_t)((acc_ + 128) >> 8); }
+  bool primed() const { return primed_; }
+
+private:
+  int32_t acc_ = 0;
+  bool primed_ = false;
+};
+
+enum class BatteryZone : uint8_t
+{
+  Ok,
+  Half,
+  Low
+};
+
+/** @brief 电池电压（mV）→ 电量 0..255（超出刻度时截断） */
+uint8_t batteryLevel(uint32_t battery_mv);
+
+/**
+ * @brief 电量 → 区间：下降立即生效，回升需要超过阈值 BATTERY_HYSTERESIS
+ */
+BatteryZone batteryZone(uint8_t level, BatteryZone previous);
+
+const char *batteryZoneName(BatteryZone zone);
+
+struct BatteryStatus
+{
+  uint32_t millivolts; // 平均后的电池电压
+  uint8_t level;       // 0..255
+  BatteryZone zone;
+  uint32_t samples;     // 已处理的帧 / 单次读取数
+  uint32_t led_updates; // LED 写入次数（只在区间变化时）
+};
+
+/** @brief 配置 LED 引脚并启动 ADC（连续模式或单次读取） */
+bool batteryMonitorBegin();
+
+/** @brief 处理新数据（在 loop() 中调用；没有新数据时立即返回） */
+void batteryMonitorPoll();
+
+BatteryStatus batteryStatus();
+
+/** @brief 状态输出为 JSON（一行） */
+size_t batteryStatusToJson(char *buf, size_t len);
@@ -0,0 +1,146 @@
+/**
+ * @file block_fanout.h
+ * @brief 音频块分发：一个 RX 块同时交给多个消费者（录音、电平表、VAD、网络推流 ...）
+ *
+ * 块在分发后只读；分发器为每个消费者增加一次引用，消费者用完后 releaseAudioBlock()，
+ * 最后一个释放者把块归还到块池。所有消费者读取同一块内存，不复制。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+#include "block_pool.h"
+#include "ring_buffer.h"
+
+// 一个分发器最多的消费者数
+#define BLOCK_FANOUT_MAX_SINKS 8
+
+/**
+ * @brief 块消费者
+ */
+class BlockSink
+{
+public:
+  virtual ~BlockSink() = default;
+
+  /**
+   * @brief 接收一个块（获得一次引用，处理完后必须 releaseAudioBlock()）
+   * @return false: 拒收（例如队列已满），引用由分发器释放
+   */
+  virtual bool push(AudioBlock *block) = 0;
+};
+
+/**
+ * @brief 分发器
+ */
+class BlockFanout
+{
+public:
+  /** @brief 添加消费者（setup 中调用） */
+  bool add(BlockSink &sink)
+  {
+    if (count_ >= BLOCK_FANOUT_MAX_SINKS)
+      return false;
+    sinks_[count_++] = &sink;
+    return true;
+  }
+
+  /**
+   * @brief 分发一个块（接管调用方的引用）
+   * @return 接收该块的消费者数
+   */
+  size_t dispatch(AudioBlock *block)
+  {
+    size_t accepted = 0;
+    retainAudioBlock(block, count_);
+    for (size_t i = 0; i < count_; i++)
+    {
+      if (sinks_[i]->push(block))
+      {
+        accepted++;
+      }
+      else
+      {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        releaseAudioBlock(block);
+      }
+    }
+    releaseAudioBlock(block);
+    return accepted;
+  }
+
+  size_t sinkCount() const { return count_; }
+  uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  BlockSink *sinks_[BLOCK_FANOUT_MAX_SINKS] = {};
+  size_t count_ = 0;
+  std::atomic<uint32_t> dropped_{0};
+};
+
+/**
+ * @brief 队列消费者：块进入单生产者 / 单消费者队列（SpscRing），由消费者任务取出处理
+ *
+ * @tparam N 队列深度（2 的幂）
+ */
+template <size_t N>
+class BlockQueueSink : public BlockSink
+{
+public:
+  bool push(AudioBlock *block) override { return ring_.push(block); }
+
+  /** @brief 取出一个块（消费者处理后 releaseAudioBlock()），队列为空时返回 nullptr */
+  AudioBlock *pop()
+  {
+    AudioBlock *block = nullptr;
+    ring_.pop(block);
+    return block;
+  }
+
+  size_t size() const { return ring_.size(); }
+
+private:
+  SpscRing<AudioBlock *, N> ring_;
+};
+
+/**
+ * @brief 编码器消费者：在分发线程中直接写入编码器（录音）
+ */
+class EncoderSink : public BlockSink
+{
+public:
+  EncoderSink() = default;
+  explicit EncoderSink(Print &encoder) : encoder_(&encoder) {}
+
+  void setEncoder(Print &encoder) { encoder_ = &encoder; }
+
+  bool push(AudioBlock *block) override;
+
+private:
+  Print *encoder_ = nullptr;
+};
+
+/**
+ * @brief 电平表：统计 16 / 32 位 PCM 的峰值与均方值（在分发线程中直接计算）
+ */
+class LevelMeterSink : public BlockSink
+{
+public:
+  explicit LevelMeterSink(uint8_t bytes_per_sample = 4) : bytes_per_sample_(bytes_per_sample) {}
+
+  bool push(AudioBlock *block) override;
+
+  /** @brief 自上次 reset 以来的峰值（dBFS） */
+  float peakDbfs() const;
+  /** @brief 自上次 reset 以来的 RMS（dBFS） */
+  float rmsDbfs() const;
+  void reset();
+
+private:
+  uint8_t bytes_per_sample_;
+  uint32_t peak_ = 0; // 按 32 位满幅计
+  uint64_t sum_squares_ = 0; // 16 位精度
+  uint64_t samples_ = 0;
+};
@@ -0,0 +1,185 @@
+/**
+ * @file block_pool.h
+ * @brief 固定大小音频块池：O(1) 无锁获取 / 释放，可在任务与 ISR 中使用
+ *
+ * 两级：
+ *  - DMA 级：静态存储（.bss 位于内部 DRAM，可直接用于 I2S DMA），小块，数量固定
+ *  - PSRAM 级：启动时从 PSRAM 一次性分配，大块（录音的 SD 写入批次），没有 PSRAM 时不可用
+ *
+ * 空闲链表为带版本号的 Treiber 栈（32 位：高 16 位版本号，低 16 位块索引），
+ * 只用一次 CAS，不关中断、不加锁；池耗尽时返回 nullptr 并计数。
+ * 各阶段之间传递 AudioBlock 指针，不复制数据；块带引用计数，
+ * 多个消费者共享同一块时由最后一个释放者归还（见 block_fanout.h）。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+
+//===========================================================
+// 池配置
+//===========================================================
+#ifndef AUDIO_DMA_BLOCK_SIZE
+#define AUDIO_DMA_BLOCK_SIZE 512 // 每次 I2S 读取的字节数
+#endif
+#ifndef AUDIO_DMA_BLOCK_COUNT
+#define AUDIO_DMA_BLOCK_COUNT 72 // 录音队列 64 + 播放队列 4 + 读取 / 写出中的块
+#endif
+#ifndef AUDIO_PSRAM_BLOCK_SIZE
+#define AUDIO_PSRAM_BLOCK_SIZE 16384
+#endif
+#ifndef AUDIO_PSRAM_BLOCK_COUNT
+#define AUDIO_PSRAM_BLOCK_COUNT 2 // storage 一次只填一个写入批次
+#endif
+
+class BlockPool;
+
+/**
+ * @brief 音频块描述符（指向池内固定内存）
+ */
+struct AudioBlock
+{
+  uint8_t *data;                   // 块内存（4 字节对齐）
+  uint32_t capacity;               // 块大小（字节）
+  uint32_t length;                 // 有效数据长度（由生产者设置）
+  BlockPool *pool;                 // 所属池
+  uint16_t index;                  // 在池中的索引
+  std::atomic<uint16_t> refs;      // 引用计数（获取时为 1）
+  std::atomic<uint16_t> next_free; // 空闲链表（只在空闲时有意义）
+};
+
+/**
+ * @brief 固定大小块池
+ */
+class BlockPool
+{
+public:
+  static constexpr uint16_t NONE = 0xFFFF;
+
+  /**
+   * @brief 初始化（只调用一次，不分配内存）
+   *
+   * @param memory     count * block_size 字节，4 字节对齐
+   * @param blocks     count 个描述符
+   * @param count      块数（< 0xFFFF）
+   * @param block_size 块大小（字节）
+   */
+  void init(uint8_t *memory, AudioBlock *blocks, uint16_t count, uint32_t block_size);
+
+  /** @brief 获取一个空闲块，耗尽时返回 nullptr（计入 exhausted） */
+  AudioBlock *acquire()
+  {
+    uint32_t head = head_.load(std::memory_order_acquire);
+    for (;;)
+    {
+      uint16_t idx = (uint16_t)head;
+      if (idx == NONE)
+      {
+        exhausted_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+      uint16_t next = blocks_[idx].next_free.load(std::memory_order_relaxed);
+      uint32_t tagged = ((head & 0xFFFF0000u) + 0x10000u) | next;
+      if (head_.compare_exchange_weak(head, tagged, std::memory_order_acquire, std::memory_order_acquire))
+      {
+        uint32_t used = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint32_t peak = peak_in_use_.load(std::memory_order_relaxed);
+        while (used > peak && !peak_in_use_.compare_exchange_weak(peak, used, std::memory_order_relaxed))
+        {
+        }
+        acquired_.fetch_add(1, std::memory_order_relaxed);
+        AudioBlock *b = &blocks_[idx];
+        b->length = 0;
+        b->refs.store(1, std::memory_order_relaxed);
+        return b;
+      }
+    }
+  }
+
+  /** @brief 归还块（必须来自本池，引用计数已归零；一般使用 releaseAudioBlock()） */
+  void release(AudioBlock *block)
+  {
+    uint16_t idx = block->index;
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      block->next_free.store((uint16_t)head, std::memory_order_relaxed);
+      uint32_t tagged = ((head & 0xFFFF0000u) + 0x10000u) | idx;
+      if (head_.compare_exchange_weak(head, tagged, std::memory_order_release, std::memory_order_relaxed))
+        break;
+    }
+    in_use_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool ready() const { return blocks_ != nullptr; }
+  uint32_t blockSize() const { return block_size_; }
+  uint16_t count() const { return count_; }
+  uint32_t inUse() const { return in_use_.load(std::memory_order_relaxed); }
+  uint32_t peakInUse() const { return peak_in_use_.load(std::memory_order_relaxed); }
+  uint32_t acquired() const { return acquired_.load(std::memory_order_relaxed); }
+  uint32_t exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+private:
+  AudioBlock *blocks_ = nullptr;
+  uint32_t block_size_ = 0;
+  uint16_t count_ = 0;
+  std::atomic<uint32_t> head_{NONE};
+  std::atomic<uint32_t> in_use_{0};
+  std::atomic<uint32_t> peak_in_use_{0};
+  std::atomic<uint32_t> acquired_{0};
+  std::atomic<uint32_t> exhausted_{0};
+};
+
+/**
+ * @brief 静态存储的块池（内存与描述符在 .bss，构造时初始化）
+ */
+template <uint32_t BlockSize, uint16_t Count>
+class StaticBlockPool : public BlockPool
+{
+  static_assert(BlockSize % 4 == 0, "块大小必须是 4 的倍数");
+  static_assert(Count > 0 && Count < BlockPool::NONE, "块数超出范围");
+
+public:
+  StaticBlockPool() { init(memory_, blocks_, Count, BlockSize); }
+
+private:
+  alignas(4) uint8_t memory_[BlockSize * Count];
+  AudioBlock blocks_[Count];
+};
+
+//===========================================================
+// 全局块池
+//===========================================================
+extern StaticBlockPool<AUDIO_DMA_BLOCK_SIZE, AUDIO_DMA_BLOCK_COUNT> g_dma_blocks;
+extern BlockPool g_psram_blocks;
+
+/**
+ * @brief 从 PSRAM 分配大块池（setup 中调用一次）
+ * @return false: 没有 PSRAM 或空间不足，PSRAM 级不可用
+ */
+bool psramBlockPoolBegin(uint32_t block_size = AUDIO_PSRAM_BLOCK_SIZE, uint16_t count = AUDIO_PSRAM_BLOCK_COUNT);
+
+/**
+ * @brief 按大小选择池获取块：不超过 DMA 块大小时用 DMA 级，否则用 PSRAM 级
+ */
+AudioBlock *acquireAudioBlock(size_t bytes);
+
+/** @brief 增加引用（每个额外的持有者一次） */
+static inline void retainAudioBlock(AudioBlock *block, uint16_t count = 1)
+{
+  block->refs.fetch_add(count, std::memory_order_relaxed);
+}
+
+/** @brief 释放一个引用，最后一个引用释放时归还到所属池 */
+static inline void releaseAudioBlock(AudioBlock *block)
+{
+  if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    block->pool->release(block);
+}
+
+/**
+ * @brief 块池统计 JSON
+ * {"dma":{"size":..,"count":..,"in_use":..,"peak":..,"acquired":..,"exhausted":..},"psram":{...}}
+ */
+size_t blockPoolsToJson(char *buf, size_t len);
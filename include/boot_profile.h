@@ -0,0 +1,136 @@
+/**
+ * @file boot_profile.h
+ * @brief 启动分析：记录 setup() 中各初始化阶段的开始时间、耗时与所在核心，启动完成后输出一览
+ *
+ * 时间为 micros()（自复位起，含 bootloader 之后、setup() 之前的时间）。
+ * 阶段可以嵌套或在不同核心上并行，各自记录开始 / 结束。
+ *
+ * 同时提供就绪检查，代替固定的 delay()：轮询条件成立（或超时）即继续；
+ * 以及并行初始化：互不依赖的初始化步骤（SD / ES8311 + I2S，总线不同）在两个核心上同时运行。
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "task_plan.h"
+
+// 最多记录的阶段数
+#define BOOT_PROFILE_MAX_PHASES 16
+
+// 1: bootRunParallel() 在其他核心上创建临时任务并行运行；0: 按顺序运行（主机构建固定为 0）
+#if defined(HOST_BUILD)
+#undef BOOT_PARALLEL
+#define BOOT_PARALLEL 0
+#endif
+#ifndef BOOT_PARALLEL
+#define BOOT_PARALLEL 1
+#endif
+
+// 并行初始化临时任务的栈大小（字节）
+#ifndef BOOT_WORKER_STACK
+#define BOOT_WORKER_STACK 4096
+#endif
+
+// 一组并行步骤的最大数量
+#define BOOT_PARALLEL_MAX_JOBS 4
+
+//===========================================================
+// 阶段计时
+//===========================================================
+/**
+ * @brief 开始一个阶段
+ * @return 阶段编号（超过 BOOT_PROFILE_MAX_PHASES 时为 -1，不记录）
+ */
+int bootPhaseBegin(const char *name);
+
+/** @brief 结束阶段；ok=false 时在一览中标记失败 */
+void bootPhaseEnd(int phase, bool ok = true);
+
+/**
+ * @brief 作用域阶段：构造时开始，析构时结束
+ */
+class BootPhase
+{
+public:
+  explicit BootPhase(const char *name) : phase_(bootPhaseBegin(name)) {}
+  ~BootPhase() { bootPhaseEnd(phase_, ok_); }
+
+  /** @brief 标记本阶段失败 */
+  void fail() { ok_ = false; }
+
+private:
+  int phase_;
+  bool ok_ = true;
+};
+
+/** @brief 记录启动完成（可以开始录音 / 播放）的时间 */
+void bootReady();
+
+/** @brief 启动完成时间（微秒，自复位起；未调用 bootReady() 时为 0） */
+uint32_t bootReadyMicros();
+
+/**
+ * @brief 输出各阶段一览
+ *
+ * [boot] phase            start ms    time ms  core
+ * [boot] sd mount            0.812    150.120     1
+ * ...
+ * [boot] ready at 215.402 ms (setup entered at 0.811 ms)
+ * [boot] parallel: 2 steps, sum 160.100 ms, longest 150.000 ms, elapsed 150.200 ms
+ */
+void bootReport(Print &out);
+
+//===========================================================
+// 并行初始化
+//===========================================================
+/**
+ * @brief 一个初始化步骤
+ */
+struct BootJob
+{
+  const char *name;
+  bool (*fn)();     // 返回 false 表示失败
+  TaskId where;     // 在哪个任务的核心上运行（TaskId::Control：在调用者中运行）
+  bool ok = false;  // 结果
+  uint32_t time_us = 0; // 耗时
+};
+
+/**
+ * @brief 并行运行一组互不依赖的步骤，全部完成后返回
+ *
+ * where 不是 Control 的步骤在 TASK_PLAN 中该任务的核心上以临时任务运行（运行完即删除），
+ * 其余在调用者中运行；每个步骤记为一个启动阶段。BOOT_PARALLEL=0 时按顺序运行。
+ *
+ * @return 全部步骤成功
+ */
+bool bootRunParallel(BootJob *jobs, size_t count);
+
+//===========================================================
+// 就绪检查
+//===========================================================
+/**
+ * @brief 轮询 ready() 直到返回 true 或超时（每次之间 delay(poll_ms)）
+ *
+ * @return ready() 是否成立
+ */
+template <class Ready>
+bool bootWaitUntil(uint32_t timeout_ms, Ready &&ready, uint32_t poll_ms = 1)
+{
+  uint32_t start = millis();
+  for (;;)
+  {
+    if (ready())
+      return true;
+    if (millis() - start >= timeout_ms)
+      return false;
+    delay(poll_ms);
+  }
+}
+
+/**
+ * @brief ES8311 是否已上电并应答：读取芯片 ID 寄存器 0xFD / 0xFE（应为 0x83 / 0x11）
+ *
+ * wire 需已 begin()（DriverPins::begin() 中完成）。
+ */
+bool es8311ChipReady(TwoWire &wire, uint8_t addr);
@@ -0,0 +1,139 @@
+/**
+ * @file deferred_log.h
+ * @brief 延迟日志：热路径只记录格式串指针与原始参数，由低优先级任务格式化输出
+ *
+ * DLOG("sd short write %u/%u", n, len);
+ *
+ * - 格式串必须是字符串字面量（只保存指针）
+ * - 最多 4 个参数：整数、float/double、指针、静态字符串（%s 只保存指针）
+ * - 条目放在 MpscRing（ring_buffer.h）中，满时丢弃并计数，不阻塞
+ *
+ * 记录一条约几十个周期：读 esp_timer 微秒、一次 CAS、写入槽位。
+ * 时间戳在记录时取自启动起的 64 位微秒（两个核心共用、不随动态调频变化、不回绕），
+ * 输出时原样显示，不依赖第一条日志或相邻条目的顺序。
+ * 格式化在 log 任务中进行（见 task_plan.h）。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#if defined(ESP_PLATFORM)
+#include "esp_timer.h"
+#endif
+
+#include "ring_buffer.h"
+
+// 环形缓冲区条目数（2 的幂）
+#ifndef DEFERRED_LOG_ENTRIES
+#define DEFERRED_LOG_ENTRIES 64
+#endif
+
+// 单条日志最多参数个数
+#define DEFERRED_LOG_MAX_ARGS 4
+
+struct DeferredLogEntry
+{
+  uint64_t us; // 记录时自启动起的微秒数（deferredLogMicros）
+  const char *fmt;
+  uintptr_t args[DEFERRED_LOG_MAX_ARGS];
+  uint8_t nargs;
+  uint8_t float_mask; // 第 i 位为 1：args[i] 保存的是 float 的位模式
+};
+
+struct DeferredLogRing
+{
+  MpscRing<DeferredLogEntry, DEFERRED_LOG_ENTRIES> entries;
+  std::atomic<uint32_t> dropped{0}; // 缓冲区满丢弃的条数
+};
+
+extern DeferredLogRing g_dlog;
+
+/**
+ * @brief 自启动起的微秒数：ESP32 为 esp_timer（可在中断中调用），主机为虚拟时钟
+ */
+static inline uint64_t deferredLogMicros()
+{
+#if defined(HOST_BUILD)
+  return host::nowMicros();
+#elif defined(ESP_PLATFORM)
+  return (uint64_t)esp_timer_get_time();
+#else
+  return micros();
+#endif
+}
+
+namespace dlog_detail
+{
+  /**
+   * @brief 把参数转换为 uintptr_t；float 保存位模式并在 float_mask 中置位
+   */
+  template <class T>
+  inline uintptr_t pack(T v, uint8_t index, uint8_t &float_mask)
+  {
+    (void)index;
+    (void)float_mask;
+    if constexpr (std::is_floating_point<T>::value)
+    {
+      float f = (float)v;
+      uint32_t bits;
+      memcpy(&bits, &f, sizeof(bits));
+      float_mask |= (uint8_t)(1u << index);
+      return bits;
+    }
+    else if constexpr (std::is_pointer<T>::value)
+    {
+      return (uintptr_t)v;
+    }
+    else
+    {
+      static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "DLOG 只支持整数、浮点与指针参数");
+      static_assert(sizeof(T) <= sizeof(uintptr_t), "DLOG 参数超过指针宽度");
+      if constexpr (std::is_signed<T>::value)
+        return (uintptr_t)(intptr_t)v;
+      else
+        return (uintptr_t)v;
+    }
+  }
+}
+
+/**
+ * @brief 记录一条日志（可在任意任务中调用，不分配内存、不格式化）
+ * @return false: 缓冲区已满，已丢弃
+ */
+template <class... Args>
+inline bool deferredLog(const char *fmt, Args... args)
+{
+  static_assert(sizeof...(Args) <= DEFERRED_LOG_MAX_ARGS, "DLOG 最多 4 个参数");
+
+  DeferredLogEntry e;
+  e.us = deferredLogMicros();
+  e.fmt = fmt;
+  e.nargs = (uint8_t)sizeof...(Args);
+  uint8_t mask = 0, i = 0;
+  ((e.args[i] = dlog_detail::pack(args, i, mask), i++), ...);
+  (void)i;
+  e.float_mask = mask;
+  if (!g_dlog.entries.push(e))
+  {
+    g_dlog.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+#define DLOG(fmt, ...) deferredLog("" fmt "", ##__VA_ARGS__)
+
+/**
+ * @brief 取出并格式化全部待输出日志（单消费者）
+ * @return 输出的条数
+ */
+size_t deferredLogFlush(Print &out);
+
+/**
+ * @brief 启动日志任务（TASK_PLAN 中的 log），周期调用 deferredLogFlush()
+ */
+bool deferredLogStart(Print &out);
@@ -0,0 +1,59 @@
+/**
+ * @file es8311_controls.h
+ * @brief ES8311 硬件处理模块的类型化接口：DAC / ADC 数字音量、ADC 高通滤波、ALC
+ *
+ * 全部通过寄存器缓存（es8311_regs.h）修改，只写入变化的寄存器；
+ * 这些处理在编解码器内完成，不占用 CPU。g_es8311 未就绪时返回 false，由调用者退回软件处理。
+ *
+ * 寄存器（见 ES8311 数据手册）：
+ *   0x32 DAC_VOLUME  0x00 = -95.5 dB ... 0xBF = 0 dB ... 0xFF = +32 dB，0.5 dB 步进
+ *   0x17 ADC_VOLUME  同上
+ *   0x1B ADC_HPFS1   [4:0] 第一级高通系数
+ *   0x1C ADC_HPF     [6] EQ 旁路，[5] 动态高通使能，[4:0] 第二级高通系数
+ *   0x18 ALC         [7] ALC 使能，[3:0] 窗口大小
+ *   0x19 ALC_LEVEL   [7:4] 最大电平，[3:0] 最小电平
+ */
+#pragma once
+
+#include "es8311_regs.h"
+
+// 数字音量寄存器的 0 dB 值与范围
+#define ES8311_VOLUME_0DB 0xBF
+#define ES8311_VOLUME_MIN_DB -95.5f
+#define ES8311_VOLUME_MAX_DB 32.0f
+
+/**
+ * @brief ALC（自动电平控制）配置，电平为数据手册中的 4 位代码（越大目标电平越高）
+ */
+struct Es8311Alc
+{
+  bool enable = false;
+  uint8_t window = 0x0A;    // 窗口大小 [3:0]
+  uint8_t max_level = 0x0B; // 最大电平 [3:0]
+  uint8_t min_level = 0x06; // 最小电平 [3:0]
+};
+
+/** @brief dB → 数字音量寄存器值（0.5 dB 步进，超出范围时截断） */
+uint8_t es8311VolumeReg(float db);
+
+/** @brief 数字音量寄存器值 → dB */
+float es8311VolumeDb(uint8_t reg);
+
+/** @brief DAC 数字音量（播放增益） */
+bool es8311SetDacVolumeDb(float db);
+
+/** @brief ADC 数字音量（录音增益） */
+bool es8311SetAdcVolumeDb(float db);
+
+/**
+ * @brief ADC 高通滤波（去除直流偏移）
+ *
+ * @param s1 / s2 两级系数 [4:0]（驱动初始化值 0x0A / 0x0A）
+ */
+bool es8311SetAdcHpf(bool enable, uint8_t s1 = 0x0A, uint8_t s2 = 0x0A);
+
+/** @brief ADC 高通滤波当前是否启用（读影子） */
+bool es8311AdcHpfEnabled();
+
+/** @brief ALC 配置（两个寄存器在一次 flush 中写入） */
+bool es8311SetAlc(const Es8311Alc &alc);
@@ -0,0 +1,132 @@
+/**
+ * @file es8311_regs.h
+ * @brief ES8311 寄存器影子缓存：读-改-写在本地完成，只把改动的寄存器批量写入芯片
+ *
+ * - begin() 时一次性读回全部寄存器作为影子，并把 I2C 切换到快速模式（ES8311_I2C_CLOCK_HZ）
+ * - get() / set() / update() 只操作影子并标记脏位，不产生 I2C 事务
+ * - flush() 把连续的脏寄存器合并为一次突发写（寄存器地址自增），每段只需一个事务
+ *
+ * 原驱动每次调整都是 “读 1 个事务 + 写 1 个事务、100 kHz”，约 0.6 ms；
+ * 经缓存后单个寄存器只需一个 400 kHz 写事务（约 70 us），多寄存器切换按连续段计。
+ *
+ * 只应在一个任务（control）中使用，不加锁。
+ * 例外是 invalidate()：AudioBoard（I2SCodecStream::setAudioInfo）或精简驱动（es8311_set_clock）
+ * 在缓存之外改写寄存器后，由改写的任务调用；control 下一次使用影子之前 sync() 重新读回。
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include <atomic>
+
+#include "es8311.h"
+
+// ES8311 I2C 地址（CE 接地）
+#ifndef ES8311_I2C_ADDR
+#define ES8311_I2C_ADDR 0x18
+#endif
+
+// 缓存启用后的 I2C 时钟：ES8311 支持 400 kHz 快速模式；1 MHz 需要板上上拉电阻与芯片余量，需实测
+#ifndef ES8311_I2C_CLOCK_HZ
+#define ES8311_I2C_CLOCK_HZ 400000
+#endif
+
+// 1: 读写使用寄存器地址自增的突发传输；0: 每个寄存器一个事务
+#ifndef ES8311_BURST
+#define ES8311_BURST 1
+#endif
+
+// 一次突发传输的最大寄存器数（Arduino Wire 缓冲区为 128 字节）
+#define ES8311_BURST_MAX 32
+
+// 缓存的寄存器范围：0x00..0x45 与芯片 ID / 版本 0xFA..0xFF
+#define ES8311_REG_LAST 0x45
+#define ES8311_REG_ID_FIRST 0xFA
+
+class Es8311Registers
+{
+public:
+  /**
+   * @brief 读回全部寄存器作为影子，并切换 I2C 时钟
+   *
+   * 在 ES8311 驱动初始化（AudioBoard::begin）之后调用。
+   *
+   * @param clock_hz 0：保持当前时钟
+   */
+  bool begin(TwoWire &wire, uint8_t addr = ES8311_I2C_ADDR, uint32_t clock_hz = ES8311_I2C_CLOCK_HZ);
+
+  /** @brief 重新从芯片读回影子（丢弃未写入的改动） */
+  bool refresh();
+
+  /** @brief 标记影子过期（芯片寄存器在缓存之外被改写；可在任何任务中调用） */
+  void invalidate() { stale_.store(true, std::memory_order_release); }
+
+  /** @brief 影子过期时重新读回（control 中、使用影子之前调用）；读回失败时保持过期 */
+  bool sync();
+
+  bool ready() const { return wire_ != nullptr; }
+
+  /** @brief 影子中的值（不访问 I2C） */
+  uint8_t get(uint8_t reg) const { return regs_[reg]; }
+
+  /** @brief 修改影子，值变化时标记为脏 */
+  void set(uint8_t reg, uint8_t val);
+
+  /** @brief 只修改 mask 中的位 */
+  void update(uint8_t reg, uint8_t mask, uint8_t val) { set(reg, (uint8_t)((regs_[reg] & ~mask) | (val & mask))); }
+
+  /**
+   * @brief 写入所有脏寄存器（连续的脏寄存器合并为一次突发写）
+   * @return 全部写入成功（失败的寄存器保持为脏）
+   */
+  bool flush();
+
+  /** @brief set() + flush() */
+  bool write(uint8_t reg, uint8_t val)
+  {
+    set(reg, val);
+    return flush();
+  }
+
+  /** @brief 批量修改后一次写入：pairs 为 {寄存器, 值} */
+  bool writeBatch(const uint8_t (*pairs)[2], size_t count);
+
+  /** @brief 待写入的寄存器数 */
+  size_t dirtyCount() const;
+
+  // 统计：本缓存产生的 I2C 事务数、传输字节数（含地址字节）、写入的寄存器数
+  uint32_t transactions() const { return transactions_; }
+  uint32_t bytes() const { return bytes_; }
+  uint32_t registersWritten() const { return registers_written_; }
+
+  /**
+   * @brief 生成 JSON：{"clock":..,"transactions":..,"bytes":..,"writes":..,"dirty":..}
+   * @return 写入的字符数（不含结尾 0）
+   */
+  size_t toJson(char *buf, size_t len) const;
+
+private:
+  bool isDirty(uint8_t reg) const { return dirty_[reg >> 5] & (1u << (reg & 31)); }
+  void clearDirty(uint8_t reg) { dirty_[reg >> 5] &= ~(1u << (reg & 31)); }
+
+  bool burstRead(uint8_t first, size_t count);
+  bool burstWrite(uint8_t first, size_t count);
+
+  TwoWire *wire_ = nullptr;
+  uint8_t addr_ = ES8311_I2C_ADDR;
+  uint32_t clock_hz_ = 0;
+  uint8_t regs_[256] = {};
+  uint32_t dirty_[8] = {};
+  uint32_t transactions_ = 0;
+  uint32_t bytes_ = 0;
+  uint32_t registers_written_ = 0;
+  std::atomic<bool> stale_{false};
+};
+
+extern Es8311Registers g_es8311;
+
+/**
+ * @brief 精简驱动（es8311.c）使用 Arduino TwoWire 的总线（ctx 指向 wire，需在 wire 的生命周期内使用）
+ */
+es8311_bus_t es8311WireBus(TwoWire &wire, uint8_t addr = ES8311_I2C_ADDR);
@@ -0,0 +1,224 @@
+/**
+ * @file fused_pipeline.h
+ * @brief 编译期组合的逐块处理流水线：各级在同一个循环中内联，没有逐级的虚函数调用与中间缓冲
+ *
+ *   Pipeline<I2SRx, DcBlock, Gain, Pack24, PrintSink> rec(I2SRx(i2s), DcBlock(), Gain(6.0f), Pack24(), PrintSink(file));
+ *   rec.run(total_samples);
+ *
+ * 第一个类型为输入，最后两个为打包与输出，中间任意个处理级；每块：
+ *   输入读取一块 int32 采样 → 一个循环内对每个采样依次调用各处理级、打包（原地写回同一缓冲区）→ 输出写入一次
+ * 与 AudioTools 的运行时链（每级一个 Stream / Print，逐级虚函数调用并各自遍历一遍缓冲区）相比，
+ * 数据只遍历一次，唯一的虚函数调用是读取 I2S 与最终的 Print::write（编码器 / 文件）。
+ *
+ * 各级的接口（不需要继承）：
+ *   输入     size_t read(int32_t *dst, size_t samples)           返回读到的采样数，0 表示结束
+ *   处理级   int32_t process(int32_t v)                          32 位 PCM（左对齐）
+ *   打包     static constexpr size_t kBytes; static uint8_t *put(uint8_t *out, int32_t v)
+ *   输出     size_t write(const uint8_t *data, size_t len)
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "input_dsp.h"
+
+#define FUSED_ALWAYS_INLINE inline __attribute__((always_inline))
+
+// 每块的采样数：默认与 DMA 块相同（512 字节 / 4）
+#ifndef FUSED_BLOCK_SAMPLES
+#define FUSED_BLOCK_SAMPLES 128
+#endif
+
+//===========================================================
+// 输入
+//===========================================================
+/**
+ * @brief 从 Stream（I2S）读取 32 位单声道采样
+ */
+class I2SRx
+{
+public:
+  I2SRx() = default;
+  explicit I2SRx(Stream &in) : in_(&in) {}
+
+  FUSED_ALWAYS_INLINE size_t read(int32_t *dst, size_t samples)
+  {
+    return in_->readBytes((uint8_t *)dst, samples * sizeof(int32_t)) / sizeof(int32_t);
+  }
+
+private:
+  Stream *in_ = nullptr;
+};
+
+//===========================================================
+// 处理级
+//===========================================================
+/**
+ * @brief 直流去除高通（InputDsp 的 inputDspHpf 内核，输出饱和到 32 位）
+ */
+class DcBlock
+{
+public:
+  void reset()
+  {
+    x1_ = 0;
+    y1_ = 0;
+  }
+
+  FUSED_ALWAYS_INLINE int32_t process(int32_t v) { return inputDspSaturate<int32_t>(inputDspHpf(v, x1_, y1_)); }
+
+private:
+  int64_t x1_ = 0;
+  int64_t y1_ = 0;
+};
+
+/**
+ * @brief 增益（InputDsp 的 Q16 增益与 inputDspGain 内核，饱和；最大 +42 dB）
+ */
+class Gain
+{
+public:
+  Gain() = default;
+  explicit Gain(float db) { setDb(db); }
+
+  void setDb(float db) { q16_ = inputDspGainQ16(db); }
+
+  FUSED_ALWAYS_INLINE int32_t process(int32_t v) { return inputDspSaturate<int32_t>(inputDspGain(v, q16_)); }
+
+private:
+  int32_t q16_ = 1 << 16;
+};
+
+//===========================================================
+// 打包（32 位 → 输出字长，小端）
+//===========================================================
+struct Pack16
+{
+  static constexpr size_t kBytes = 2;
+  static FUSED_ALWAYS_INLINE uint8_t *put(uint8_t *out, int32_t v)
+  {
+    out[0] = (uint8_t)(v >> 16);
+    out[1] = (uint8_t)(v >> 24);
+    return out + 2;
+  }
+};
+
+struct Pack24
+{
+  static constexpr size_t kBytes = 3;
+  static FUSED_ALWAYS_INLINE uint8_t *put(uint8_t *out, int32_t v)
+  {
+    out[0] = (uint8_t)(v >> 8);
+    out[1] = (uint8_t)(v >> 16);
+    out[2] = (uint8_t)(v >> 24);
+    return out + 3;
+  }
+};
+
+struct Pack32
+{
+  static constexpr size_t kBytes = 4;
+  static FUSED_ALWAYS_INLINE uint8_t *put(uint8_t *out, int32_t v)
+  {
+    memcpy(out, &v, 4);
+    return out + 4;
+  }
+};
+
+//===========================================================
+// 输出
+//===========================================================
+/**
+ * @brief 写入 Print（编码器 / 文件）
+ */
+class PrintSink
+{
+public:
+  PrintSink() = default;
+  explicit PrintSink(Print &out) : out_(&out) {}
+
+  FUSED_ALWAYS_INLINE size_t write(const uint8_t *data, size_t len) { return out_->write(data, len); }
+
+private:
+  Print *out_ = nullptr;
+};
+
+//===========================================================
+// 流水线
+//===========================================================
+template <class Source, class... Rest>
+class Pipeline
+{
+  static constexpr size_t kParts = sizeof...(Rest);
+  static_assert(kParts >= 2, "Pipeline 至少需要打包与输出两级");
+
+  using Parts = std::tuple<Rest...>;
+  using Pack = std::tuple_element_t<kParts - 2, Parts>;
+  using Stages = std::make_index_sequence<kParts - 2>;
+
+  // 打包原地写回：第 i 个采样写入 [i * kBytes, (i + 1) * kBytes)，不会覆盖尚未读取的采样 i + 1
+  static_assert(Pack::kBytes <= sizeof(int32_t), "打包后的字长不能超过 32 位");
+
+public:
+  Pipeline() = default;
+  explicit Pipeline(Source source, Rest... rest) : source_(std::move(source)), parts_(std::move(rest)...) {}
+
+  Source &source() { return source_; }
+
+  /** @brief 第 I 级（0 为第一个处理级，kParts - 1 为输出） */
+  template <size_t I>
+  std::tuple_element_t<I, Parts> &stage()
+  {
+    return std::get<I>(parts_);
+  }
+
+  /**
+   * @brief 处理一块
+   * @return 处理的采样数（0：输入结束）
+   */
+  size_t step()
+  {
+    size_t n = source_.read(buf_, FUSED_BLOCK_SAMPLES);
+    uint8_t *out = (uint8_t *)buf_;
+    uint8_t *o = out;
+    for (size_t i = 0; i < n; i++)
+      o = Pack::put(o, apply(buf_[i], Stages{}));
+    if (o != out)
+      std::get<kParts - 1>(parts_).write(out, (size_t)(o - out));
+    return n;
+  }
+
+  /**
+   * @brief 处理至少 samples 个采样（按块，最后一块可能超出）
+   * @return 处理的采样数
+   */
+  size_t run(size_t samples)
+  {
+    size_t done = 0;
+    while (done < samples)
+    {
+      size_t n = step();
+      if (!n)
+        break;
+      done += n;
+    }
+    return done;
+  }
+
+private:
+  template <size_t... I>
+  FUSED_ALWAYS_INLINE int32_t apply(int32_t v, std::index_sequence<I...>)
+  {
+    ((v = std::get<I>(parts_).process(v)), ...);
+    return v;
+  }
+
+  Source source_;
+  Parts parts_;
+  int32_t buf_[FUSED_BLOCK_SAMPLES];
+};
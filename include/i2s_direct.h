@@ -0,0 +1,179 @@
+/**
+ * @file i2s_direct.h
+ * @brief 直接驱动 ESP-IDF i2s_std 通道的 I2S 流（不经过 AudioTools 的 I2SStream / I2SCodecStream）
+ *
+ * - 自己配置 DMA 描述符数与每个描述符的帧数，延迟 = 描述符数 × 帧数 / 采样率
+ * - 注册 on_recv / on_sent / 队列溢出回调：计数并写入跟踪点 DmaRx / DmaTx（ISR 中）
+ * - readBytes() / write() 直接调用 i2s_channel_read / i2s_channel_write，一次复制，没有中间缓冲
+ * - 对外仍是 AudioStream，audio 任务、StatsOutputStream 不需要修改
+ *
+ * ES8311 由精简驱动（es8311.c）配置，不经过 AudioBoard。
+ * 主机构建使用虚拟时钟上的 DMA 环模型（数据来自模拟 I2S），溢出 / 欠载的判定与设备相同。
+ */
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include "AudioTools.h"
+
+#ifndef HOST_BUILD
+#include "esp_idf_version.h"
+#endif
+
+// 1: 录音 / 播放使用本文件的 i2s_std 后端；0: 使用 AudioTools 的 I2SCodecStream
+#ifndef AUDIO_I2S_DIRECT
+#define AUDIO_I2S_DIRECT 0
+#endif
+
+// i2s_std 通道 API 需要 ESP-IDF 5（Arduino-ESP32 3.x）
+#if !defined(HOST_BUILD) && defined(ESP_IDF_VERSION_MAJOR) && ESP_IDF_VERSION_MAJOR >= 5
+#define I2S_DIRECT_IDF 1
+#else
+#define I2S_DIRECT_IDF 0
+#endif
+
+#if AUDIO_I2S_DIRECT && !I2S_DIRECT_IDF && !defined(HOST_BUILD)
+#error "AUDIO_I2S_DIRECT 需要 ESP-IDF 5（Arduino-ESP32 3.x）的 i2s_std 驱动"
+#endif
+
+// DMA 描述符数与每个描述符的帧数：默认一个描述符 = 一个音频块（128 帧 × 4 字节 = 512），共 32 ms
+#ifndef I2S_DIRECT_DMA_DESC
+#define I2S_DIRECT_DMA_DESC 4
+#endif
+#ifndef I2S_DIRECT_DMA_FRAMES
+#define I2S_DIRECT_DMA_FRAMES 128
+#endif
+
+// 两次读取 / 写入的间隔超过该值时视为录音 / 播放之间的空闲：DMA 照常运行，
+// RX 队列一直满、TX 队列一直空，这段时间的溢出 / 饥饿不计入统计
+#ifndef I2S_DIRECT_IDLE_MS
+#define I2S_DIRECT_IDLE_MS 100
+#endif
+
+#if I2S_DIRECT_IDF
+#include "driver/i2s_std.h"
+#else
+#include "AudioTools/AudioLibs/I2SCodecStream.h"
+#endif
+
+struct I2SDirectConfig
+{
+  AudioInfo info{16000, 1, 32};
+  int mclk = -1; // -1：不输出 MCLK
+  int bclk = -1;
+  int ws = -1;
+  int dout = -1; // 发往编解码器（播放）
+  int din = -1;  // 来自编解码器（录音）
+  bool rx = true;
+  bool tx = true;
+  uint32_t dma_desc_num = I2S_DIRECT_DMA_DESC;
+  uint32_t dma_frame_num = I2S_DIRECT_DMA_FRAMES;
+  // 格式变化（setAudioInfo）时在通道停止期间调用，用于同步编解码器的字长 / 时钟
+  void (*on_format)(const AudioInfo &info) = nullptr;
+};
+
+/**
+ * @brief 统计（描述符计数在 ISR 中累加）
+ */
+struct I2SDirectStats
+{
+  std::atomic<uint32_t> rx_desc{0}; // on_recv：完成的 RX 描述符
+  std::atomic<uint32_t> tx_desc{0}; // on_sent：发送完的 TX 描述符
+  uint32_t rx_overflow = 0;         // on_recv_q_ovf：录音中读取太慢，最旧的描述符被覆盖
+  uint32_t tx_starved = 0;          // on_send_q_ovf：播放中写入太慢，DMA 发送了静音（auto_clear）
+  uint32_t reads = 0;               // readBytes 调用数（audio 任务）
+  uint32_t writes = 0;              // write 调用数
+  uint32_t read_max_us = 0;         // 单次 readBytes 最长耗时（含等待 DMA）
+  uint32_t write_max_us = 0;        // 单次 write 最长耗时（含等待空闲描述符）
+};
+
+class I2SDirectStream : public AudioStream
+{
+public:
+  ~I2SDirectStream() { end(); }
+
+  /** @brief 创建并启动通道（已启动时先停止） */
+  bool begin(const I2SDirectConfig &cfg);
+  bool begin() override { return begin(cfg_); }
+  void end() override;
+
+  using Print::write;
+  size_t readBytes(uint8_t *data, size_t len) override;
+  size_t write(const uint8_t *data, size_t len) override;
+
+  int available() override;
+  int availableForWrite() override;
+
+  AudioInfo audioInfo() override { return cfg_.info; }
+
+  /** @brief 修改采样率 / 字长 / 通道数：重新创建通道 */
+  void setAudioInfo(AudioInfo info) override;
+
+  const I2SDirectConfig &config() const { return cfg_; }
+  const I2SDirectStats &stats() const { return stats_; }
+
+  /** @brief 一个 DMA 描述符的字节数 */
+  size_t descriptorBytes() const { return (size_t)cfg_.dma_frame_num * frameBytes(); }
+
+  /** @brief 一个方向的 DMA 缓冲时长（微秒） */
+  uint32_t latencyUs() const
+  {
+    return (uint32_t)((uint64_t)cfg_.dma_desc_num * cfg_.dma_frame_num * 1000000ULL / cfg_.info.sample_rate);
+  }
+
+  /** @brief 清零统计 */
+  void resetStats();
+
+  /**
+   * @brief 生成 JSON：{"desc":..,"frames":..,"latency_us":..,"rx_desc":..,"rx_overflow":..,...}
+   * @return 写入的字符数（不含结尾 0）
+   */
+  size_t toJson(char *buf, size_t len) const;
+
+private:
+  size_t frameBytes() const
+  {
+    return (size_t)cfg_.info.channels * (cfg_.info.bits_per_sample == 16 ? 2 : 4);
+  }
+
+  /**
+   * @brief 把回调累计的溢出 / 饥饿计入统计（与上次读取 / 写入的间隔超过 I2S_DIRECT_IDLE_MS 时不计）
+   */
+  static void settle(const std::atomic<uint32_t> &raw, uint32_t &seen, uint32_t &stat, uint32_t gap_us);
+  void markIdle();
+
+  void noteCall(uint32_t &calls, uint32_t &max_us, uint32_t t0);
+
+  I2SDirectConfig cfg_;
+  I2SDirectStats stats_;
+  std::atomic<uint32_t> rx_ovf_raw_{0}; // 回调次数（含空闲期间）
+  std::atomic<uint32_t> tx_ovf_raw_{0};
+  uint32_t rx_ovf_seen_ = 0;
+  uint32_t tx_ovf_seen_ = 0;
+  uint32_t last_read_us_ = 0;
+  uint32_t last_write_us_ = 0;
+  bool active_ = false;
+
+#if I2S_DIRECT_IDF
+  static bool IRAM_ATTR onRecv(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx);
+  static bool IRAM_ATTR onRecvOverflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx);
+  static bool IRAM_ATTR onSent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx);
+  static bool IRAM_ATTR onSendOverflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx);
+
+  i2s_chan_handle_t rx_ = nullptr;
+  i2s_chan_handle_t tx_ = nullptr;
+#else
+  // 主机：DMA 环模型（虚拟时钟），数据来自模拟 I2S
+  void advanceRx(bool blocked);
+  void advanceTx();
+  uint64_t elapsedBytes() const;
+  void waitForBytes(uint64_t bytes);
+
+  I2SCodecStream data_{nullptr};
+  uint64_t start_us_ = 0;
+  uint64_t rx_read_ = 0;    // 已读取的字节（含溢出丢弃的）
+  uint64_t tx_written_ = 0; // 写入位置（欠载后跳到 DMA 当前位置）
+  uint64_t tx_desc_seen_ = 0;
+  uint64_t rx_desc_seen_ = 0;
+#endif
+};
@@ -0,0 +1,126 @@
+/**
+ * @file input_dsp.h
+ * @brief 录音软件处理：增益与直流去除高通（编解码器硬件处理不可用时的退路）
+ *
+ * 只使用整数运算，在 audio 任务中对刚读取的块原地处理（分发之前）。
+ * 采样类型是模板参数（录音路径使用 RecordFormat::sample_t），字长在编译期确定；
+ * 高通 × 增益 三种组合各实例化一个循环，逐块选择一次，逐采样不再判断；
+ * 增益为 0 dB 且高通关闭时 active() 为 false，不产生任何开销。
+ *
+ * 设置在 control 中调用，process() 在 audio 任务中运行：增益与高通开关为原子变量，
+ * 每块开始时读取一次；64 位的滤波器状态在 Xtensa 上不能原子写入，reset() 只置请求标志，
+ * 由 audio 任务在下一块开始时清除。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <limits>
+#include <type_traits>
+
+#include "block_pool.h"
+
+// 直流去除的极点：y = x - x1 + y1 * (1 - 2^-SHIFT)，16 kHz 时截止约 2.5 Hz
+#define INPUT_DSP_HPF_SHIFT 10
+
+#define INPUT_DSP_ALWAYS_INLINE inline __attribute__((always_inline))
+
+/** @brief dB → Q16 增益（最大 +42 dB，保证 64 位乘法不溢出） */
+int32_t inputDspGainQ16(float db);
+
+//===========================================================
+// 逐采样内核（InputDsp 与 fused_pipeline.h 的 DcBlock / Gain 共用）
+//===========================================================
+/** @brief 直流去除高通的一个采样（x1 / y1 为滤波器状态，不饱和） */
+static INPUT_DSP_ALWAYS_INLINE int64_t inputDspHpf(int64_t x, int64_t &x1, int64_t &y1)
+{
+  int64_t y = x - x1 + y1 - (y1 >> INPUT_DSP_HPF_SHIFT);
+  x1 = x;
+  y1 = y;
+  return y;
+}
+
+/** @brief Q16 增益（不饱和） */
+static INPUT_DSP_ALWAYS_INLINE int64_t inputDspGain(int64_t v, int64_t gain_q16) { return (v * gain_q16) >> 16; }
+
+/** @brief 饱和到 T 的范围 */
+template <class T>
+static INPUT_DSP_ALWAYS_INLINE T inputDspSaturate(int64_t v)
+{
+  const int64_t lo = std::numeric_limits<T>::min();
+  const int64_t hi = std::numeric_limits<T>::max();
+  return (T)(v < lo ? lo : v > hi ? hi : v);
+}
+
+template <class T>
+class InputDsp
+{
+  static_assert(std::is_same<T, int16_t>::value || std::is_same<T, int32_t>::value, "只支持 16 / 32 位采样");
+
+public:
+  /** @brief 增益（dB，负值衰减，最大 +42 dB），下一块生效 */
+  void setGainDb(float db) { gain_q16_.store(inputDspGainQ16(db), std::memory_order_relaxed); }
+
+  /** @brief 直流去除高通（开关时清除滤波器状态），下一块生效 */
+  void setHpf(bool enable)
+  {
+    hpf_.store(enable, std::memory_order_relaxed);
+    reset();
+  }
+
+  bool active() const
+  {
+    return hpf_.load(std::memory_order_relaxed) || gain_q16_.load(std::memory_order_relaxed) != (1 << 16);
+  }
+
+  /** @brief 清除滤波器状态（新一段录音开始时）：在下一块开始时由处理线程执行 */
+  void reset() { reset_pending_.store(true, std::memory_order_release); }
+
+  /**
+   * @brief 原地处理一个块（T 类型的单声道 PCM）
+   */
+  void process(AudioBlock *block)
+  {
+    if (reset_pending_.load(std::memory_order_relaxed) && reset_pending_.exchange(false, std::memory_order_acquire))
+    {
+      x1_ = 0;
+      y1_ = 0;
+    }
+    const int32_t gain_q16 = gain_q16_.load(std::memory_order_relaxed);
+    const bool gain = gain_q16 != (1 << 16);
+    if (hpf_.load(std::memory_order_relaxed))
+      gain ? processSamples<true, true>(block, gain_q16) : processSamples<true, false>(block, gain_q16);
+    else if (gain)
+      processSamples<false, true>(block, gain_q16);
+  }
+
+private:
+  template <bool Hpf, bool Gain>
+  void processSamples(AudioBlock *block, int64_t gain)
+  {
+    T *s = (T *)block->data;
+    size_t n = block->length / sizeof(T);
+    int64_t x1 = x1_, y1 = y1_;
+    for (size_t i = 0; i < n; i++)
+    {
+      int64_t v = s[i];
+      if constexpr (Hpf)
+        v = inputDspHpf(v, x1, y1);
+      if constexpr (Gain)
+        v = inputDspGain(v, gain);
+      s[i] = inputDspSaturate<T>(v);
+    }
+    if constexpr (Hpf)
+    {
+      x1_ = x1;
+      y1_ = y1;
+    }
+  }
+
+  std::atomic<int32_t> gain_q16_{1 << 16};
+  std::atomic<bool> hpf_{false};
+  std::atomic<bool> reset_pending_{false};
+  int64_t x1_ = 0; // 滤波器状态：只在处理线程中访问
+  int64_t y1_ = 0;
+};
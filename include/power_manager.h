@@ -0,0 +1,217 @@
+/**
+ * @file power_manager.h
+ * @brief 电源管理：只在有音频工作时持有 PM 锁，其余时间降频到 PM_MIN_MHZ 或浅睡眠
+ *
+ * AUDIO_PM=1 且 sdkconfig 启用 CONFIG_PM_ENABLE 时 esp_pm 动态调频：
+ *  - 录音 / 播放期间持有 NO_LIGHT_SLEEP 锁（I2S DMA 与 ES8311 的 MCLK 不能停），两次 DMA 之间 CPU 在 PM_MIN_MHZ 等待
+ *  - 每块处理（audio：DSP + 分发；storage：WAV 编解码 + SD）按负载决定是否持有 CPU_FREQ_MAX 锁：
+ *    PmGovernor 把上一块的处理时间折算到 PM_MIN_MHZ，超过块时长的 PM_BOOST_PCT% 时升频，
+ *    连续 PM_RELAX_BLOCKS 块低于阈值的 3/4 后才取消，保证低频下处理也不会超过块时长
+ *  - 空闲（没有录音 / 播放）时本模块没有锁，FreeRTOS tickless idle 可以进入浅睡眠（PM_LIGHT_SLEEP）；
+ *    但启用的 I2S 通道由驱动持有 PM 锁，USB 串口连接期间持有 NO_LIGHT_SLEEP（浅睡眠会断开 USB），
+ *    UART 串口设为唤醒源。只有空闲且没有这些阻止条件的时间才按浅睡眠估算
+ *
+ * 注意：I2S 通道在 setup 中启动后一直运行（main.cpp 调用 pmSetI2SRunning(true)，之后不再停止），
+ * 所以目前设备从不浅睡眠，空闲时只是降到 PM_MIN_MHZ 等待；PM_LIGHT_SLEEP 与 ms.sleep 的统计
+ * 只有在以后空闲时停止 I2S 通道（并调用 pmSetI2SRunning(false)）才会起作用。
+ * 没有 esp_pm 时退回 setCpuFrequencyMhz：录音 / 播放期间 PM_MAX_MHZ，空闲时 PM_MIN_MHZ
+ * （只在 control 中切换：开始时在 pmStreamBegin，结束后 audio 回到空闲时在 pmIdleStep）。
+ *
+ * AUDIO_PM=0 时固定 PM_MAX_MHZ（platformio.ini 的 f_cpu），只统计。
+ * 没有电流传感器：串口命令 pm 按各状态的时间与 PM_UA_* 估算平均电流（est_ma，不是测量值），并与固定 240 MHz 对比，
+ * 同时输出 I2S 溢出 / 欠载计数（降频后音频截止时间是否仍满足）。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#include "AudioTools.h"
+#include "task_plan.h"
+
+// 1: 启用动态调频 / 浅睡眠；0: 固定最高频率
+#ifndef AUDIO_PM
+#define AUDIO_PM 0
+#endif
+
+// 频率范围（MHz）：最高与 platformio.ini 的 f_cpu 相同；最低 80（APB 保持 80 MHz，SPI / I2C 时钟不变）
+#ifndef PM_MAX_MHZ
+#define PM_MAX_MHZ 240
+#endif
+#ifndef PM_MIN_MHZ
+#define PM_MIN_MHZ 80
+#endif
+
+// 空闲时允许浅睡眠（需要 CONFIG_FREERTOS_USE_TICKLESS_IDLE，不支持时只调频）
+#ifndef PM_LIGHT_SLEEP
+#define PM_LIGHT_SLEEP 1
+#endif
+
+// 串口控制台：1 为 USB CDC（连接期间不能浅睡眠），0 为 UART（RX 唤醒）
+#ifndef PM_CONSOLE_USB
+#if defined(ARDUINO_USB_CDC_ON_BOOT) && ARDUINO_USB_CDC_ON_BOOT
+#define PM_CONSOLE_USB 1
+#else
+#define PM_CONSOLE_USB 0
+#endif
+#endif
+
+// 升频阈值：折算到 PM_MIN_MHZ 的处理时间占块时长的百分比
+#ifndef PM_BOOST_PCT
+#define PM_BOOST_PCT 50
+#endif
+
+// 取消升频前需要连续低于阈值 3/4 的块数（避免在两种频率间来回切换）
+#ifndef PM_RELAX_BLOCKS
+#define PM_RELAX_BLOCKS 64
+#endif
+
+// 电流估算（µA）：ESP32-S3 数据手册典型值（RF 关闭，单核运行 / WAITI 等待），不含 ES8311、功放、SD 卡
+#define PM_UA_RUN_240 50000
+#define PM_UA_IDLE_240 33000
+#define PM_UA_RUN_80 28000
+#define PM_UA_IDLE_80 22000
+#define PM_UA_LIGHT_SLEEP 240
+
+#if !defined(HOST_BUILD) && AUDIO_PM
+#include "sdkconfig.h"
+#endif
+
+#if !defined(HOST_BUILD) && AUDIO_PM && defined(CONFIG_PM_ENABLE)
+#define PM_IDF 1
+#else
+#define PM_IDF 0
+#endif
+
+/**
+ * @brief 按负载决定处理期间是否升频（每块调用一次 update）
+ */
+class PmGovernor
+{
+public:
+  /**
+   * @param work_us   这一块的处理时间
+   * @param mhz       处理时的频率
+   * @param budget_us 这一块的音频时长（截止时间）
+   * @return 下一块处理时是否需要 PM_MAX_MHZ
+   */
+  bool update(uint32_t work_us, uint32_t mhz, uint32_t budget_us)
+  {
+    uint32_t at_min = (uint32_t)((uint64_t)work_us * mhz / PM_MIN_MHZ);
+    uint64_t limit = (uint64_t)budget_us * PM_BOOST_PCT;
+    if ((uint64_t)at_min * 100 > limit)
+    {
+      if (!boost_)
+        boosts_++;
+      boost_ = true;
+      calm_ = 0;
+    }
+    else if (boost_ && (uint64_t)at_min * 400 < limit * 3)
+    {
+      if (++calm_ >= PM_RELAX_BLOCKS)
+      {
+        boost_ = false;
+        calm_ = 0;
+      }
+    }
+    else
+    {
+      calm_ = 0;
+    }
+    return boost_;
+  }
+
+  bool boost() const { return boost_; }
+  uint32_t boosts() const { return boosts_; }
+  void reset()
+  {
+    boost_ = false;
+    calm_ = 0;
+  }
+
+private:
+  bool boost_ = false;
+  uint16_t calm_ = 0;
+  uint32_t boosts_ = 0; // 升频次数
+};
+
+/**
+ * @brief 各状态的累计时间（微秒），用于估算电流
+ */
+struct PmTimes
+{
+  uint64_t total_us;    // 统计时长
+  uint64_t stream_us;   // 录音 / 播放（不能浅睡眠）
+  uint64_t work_max_us; // 在 PM_MAX_MHZ 处理
+  uint64_t work_min_us; // 在 PM_MIN_MHZ 处理
+  uint64_t sleep_us;    // 空闲中可以浅睡眠的时间（没有 I2S 通道运行、没有控制台锁）
+};
+
+enum class PmMode : uint8_t
+{
+  Off,    // 固定 PM_MAX_MHZ
+  Stream, // 没有 esp_pm：录音 / 播放期间 PM_MAX_MHZ，空闲时 PM_MIN_MHZ
+  Dfs     // esp_pm：处理按负载升频，其余时间 PM_MIN_MHZ 等待，空闲时浅睡眠
+};
+
+const char *pmModeName(PmMode mode);
+
+/**
+ * @brief 按 PmTimes 估算某种模式下的平均电流（µA）
+ *
+ * 等待时 CPU 处于 WAITI；固定频率时 PM_MIN_MHZ 下的处理时间按频率折算。
+ * Dfs 模式下只有 sleep_us 按浅睡眠电流计算，其余空闲时间在 PM_MIN_MHZ 等待。
+ */
+uint32_t pmEstimateUa(const PmTimes &t, PmMode mode);
+
+/** @brief 某频率下运行 / 等待的电流（µA，在 80 / 240 MHz 的典型值之间线性插值） */
+uint32_t pmCurrentUa(uint32_t mhz, bool running);
+
+/** @brief 配置调频与浅睡眠、创建 PM 锁（setup() 中调用一次） */
+bool pmBegin();
+
+/**
+ * @brief 录音 / 播放开始与结束（持有 / 释放 NO_LIGHT_SLEEP 锁）
+ *
+ * pmStreamBegin 在 control 中调用；pmStreamEnd 在 audio / storage 任务中调用，只释放锁，
+ * 没有 esp_pm 时的降频留给 control 的 pmIdleStep。
+ */
+void pmStreamBegin();
+void pmStreamEnd();
+
+/** @brief control 每步在 audio 空闲时调用：没有 esp_pm 时降到 PM_MIN_MHZ，并统计可以浅睡眠的时间 */
+void pmIdleStep();
+
+/** @brief I2S 通道是否在运行（启用的通道由驱动持有 PM 锁，期间不能浅睡眠；control 中调用） */
+void pmSetI2SRunning(bool running);
+
+/** @brief USB 串口是否连接（连接期间持有 NO_LIGHT_SLEEP；control 中调用，PM_CONSOLE_USB=1 时） */
+void pmConsoleActive(bool active);
+
+/**
+ * @brief 一块处理的开始与结束（audio / storage 任务中调用）
+ *
+ * pmWorkBegin 按 PmGovernor 的决定持有 CPU_FREQ_MAX 锁；pmWorkEnd 释放锁，并用这块的处理时间更新负载估计。
+ * @param budget_us 这块数据的音频时长（0：不更新负载估计）
+ */
+void pmWorkBegin(TaskId task);
+void pmWorkEnd(TaskId task, uint32_t budget_us);
+
+/** @brief 处理中等待其他任务（例如 TX 队列满）：这段时间释放锁，不计入处理时间 */
+void pmWorkPause(TaskId task);
+void pmWorkResume(TaskId task);
+
+/** @brief bytes 字节 PCM 的时长（pmWorkEnd 的截止时间）；不指定格式时按录音格式 */
+uint32_t pmBlockUs(size_t bytes);
+uint32_t pmBlockUs(size_t bytes, const AudioInfo &info);
+
+/** @brief 实际生效的模式（pmBegin 之后） */
+PmMode pmMode();
+
+/** @brief 清零统计 */
+void pmStatsReset();
+
+/**
+ * @brief 生成 JSON：{"pm":..,"mhz":[..],"boost":[..],"ms":{..,"sleep":..},"est_ma":..,"est_ma_240":..,"overruns":..,...}
+ * @return 写入的字符数（不含结尾 0）
+ */
+size_t pmToJson(char *buf, size_t len);
@@ -0,0 +1,57 @@
+/**
+ * @file record_pipeline.h
+ * @brief 录音采集流程：I2S 读取 → 按采样对齐（→ InputDsp → BlockFanout → 编码器）
+ *
+ * readBlock() 把一次 I2S 读取放进块池的块中并按采样对齐；固件的 audio 任务（audio_tasks.cpp）
+ * 与主机基准测试 record（bench_record.cpp）都逐块调用它，之后的软件处理与分发也使用相同的
+ * InputDsp / BlockFanout。Probe 策略用于在各阶段前后插入测量，
+ * 默认的 NoProbe 为空实现，编译后没有任何额外开销。
+ * 读取字节数与读取不足始终计入 g_audio_stats（relaxed 原子操作）。
+ */
+#pragma once
+
+#include "AudioTools.h"
+#include "audio_stats.h"
+#include "audio_trace.h"
+#include "block_pool.h"
+
+/**
+ * @brief 录音流程的阶段
+ */
+enum class RecordStage : uint8_t
+{
+  Read,   // I2S 读取
+  Align,  // 按采样字节数对齐
+  Encode, // 编码器写入（含文件写入）
+  Count
+};
+
+/**
+ * @brief 空测量策略
+ */
+struct NoProbe
+{
+  static inline void begin(RecordStage) {}
+  static inline void end(RecordStage) {}
+};
+
+/**
+ * @brief 读取一个块并按采样对齐（设置 block->length）
+ *
+ * @return 对齐后的字节数（0 表示数据不足一个采样）
+ */
+template <class Probe = NoProbe>
+size_t readBlock(Stream &in, AudioBlock *block, size_t bytes_per_sample)
+{
+  Probe::begin(RecordStage::Read);
+  TRACE_BEGIN(I2sRead, block->capacity);
+  size_t bytes = in.readBytes(block->data, block->capacity); // 从 I2S 读取音频数据
+  TRACE_END(I2sRead, bytes);
+  Probe::end(RecordStage::Read);
+  statI2SRead(block->capacity, bytes);
+
+  Probe::begin(RecordStage::Align);
+  block->length = (uint32_t)((bytes / bytes_per_sample) * bytes_per_sample);
+  Probe::end(RecordStage::Align);
+  return block->length;
+}
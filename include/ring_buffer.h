@@ -0,0 +1,310 @@
+/**
+ * @file ring_buffer.h
+ * @brief 无锁环形缓冲区模板：SpscRing（单生产者 / 单消费者）与 MpscRing（多生产者 / 单消费者）
+ *
+ * - 读写索引为自由运行的 32 位计数，分别放在独立的缓存行上，生产者与消费者不互相使缓存行失效；
+ *   SPSC 两端各保存一份对端索引的副本，只在副本显示满 / 空时才读取对端索引
+ * - writeSpan() / readSpan() 返回到回绕点为止的连续区域，DMA、File::write 等直接使用该指针，
+ *   处理完后 commitWrite() / commitRead()，不需要为回绕复制
+ * - 所有操作不加锁、不关中断、不调用 FreeRTOS，可在任务与 ISR 中使用；
+ *   *FromISR 版本强制内联，在 IRAM_ATTR 的 ISR 中使用时不会调用 flash 中的代码
+ *
+ * 容量 N 必须是 2 的幂。
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 缓存行大小（ESP32-S3 的数据缓存行最大 64 字节；主机也按 64 字节）
+#ifndef RING_CACHE_LINE
+#define RING_CACHE_LINE 64
+#endif
+
+#define RING_ALWAYS_INLINE inline __attribute__((always_inline))
+
+/**
+ * @brief 连续区域
+ */
+template <class T>
+struct RingSpan
+{
+  T *data;
+  size_t count;
+};
+
+//===========================================================
+// SPSC
+//===========================================================
+/**
+ * @brief 单生产者 / 单消费者环形缓冲区
+ *
+ * push / write / writeSpan / commitWrite 只能在生产者一侧调用，
+ * pop / read / readSpan / commitRead 只能在消费者一侧调用。
+ */
+template <class T, size_t N>
+class SpscRing
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "容量必须是 2 的幂");
+
+public:
+  static constexpr size_t capacity() { return N; }
+
+  /** @brief 当前元素数（另一侧并发修改时只是近似值） */
+  size_t size() const
+  {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+
+  //===========================================================
+  // 生产者
+  //===========================================================
+  bool push(const T &value) { return pushImpl(value); }
+  RING_ALWAYS_INLINE bool pushFromISR(const T &value) { return pushImpl(value); }
+
+  /** @brief 写入最多 n 个元素（跨回绕点时分两段复制），返回写入数 */
+  size_t write(const T *src, size_t n) { return writeImpl(src, n); }
+  RING_ALWAYS_INLINE size_t writeFromISR(const T *src, size_t n) { return writeImpl(src, n); }
+
+  /**
+   * @brief 取得可写的连续区域（最多 max 个，到回绕点为止）
+   *
+   * 写入后调用 commitWrite(实际写入数)；count 为 0 表示已满。
+   */
+  RingSpan<T> writeSpan(size_t max = N) { return writeSpanImpl(max); }
+  RING_ALWAYS_INLINE RingSpan<T> writeSpanFromISR(size_t max = N) { return writeSpanImpl(max); }
+
+  RING_ALWAYS_INLINE void commitWrite(size_t n)
+  {
+    head_.store(head_.load(std::memory_order_relaxed) + (uint32_t)n, std::memory_order_release);
+  }
+
+  //===========================================================
+  // 消费者
+  //===========================================================
+  bool pop(T &value) { return popImpl(value); }
+  RING_ALWAYS_INLINE bool popFromISR(T &value) { return popImpl(value); }
+
+  /** @brief 读出最多 n 个元素（跨回绕点时分两段复制），返回读出数 */
+  size_t read(T *dst, size_t n) { return readImpl(dst, n); }
+  RING_ALWAYS_INLINE size_t readFromISR(T *dst, size_t n) { return readImpl(dst, n); }
+
+  /**
+   * @brief 取得可读的连续区域（最多 max 个，到回绕点为止）
+   *
+   * 处理后调用 commitRead(实际处理数)；count 为 0 表示为空。
+   */
+  RingSpan<const T> readSpan(size_t max = N) { return readSpanImpl(max); }
+  RING_ALWAYS_INLINE RingSpan<const T> readSpanFromISR(size_t max = N) { return readSpanImpl(max); }
+
+  RING_ALWAYS_INLINE void commitRead(size_t n)
+  {
+    tail_.store(tail_.load(std::memory_order_relaxed) + (uint32_t)n, std::memory_order_release);
+  }
+
+private:
+  /** @brief 生产者：可写元素数（副本显示不足 want 时才读取 tail_） */
+  RING_ALWAYS_INLINE size_t freeFor(uint32_t head, size_t want)
+  {
+    size_t free = N - (head - tail_cache_);
+    if (free < want)
+    {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      free = N - (head - tail_cache_);
+    }
+    return free;
+  }
+
+  /** @brief 消费者：可读元素数（副本显示不足 want 时才读取 head_） */
+  RING_ALWAYS_INLINE size_t usedFor(uint32_t tail, size_t want)
+  {
+    size_t used = head_cache_ - tail;
+    if (used < want)
+    {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      used = head_cache_ - tail;
+    }
+    return used;
+  }
+
+  RING_ALWAYS_INLINE bool pushImpl(const T &value)
+  {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (!freeFor(head, 1))
+      return false;
+    slots_[head & (N - 1)] = value;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  RING_ALWAYS_INLINE bool popImpl(T &value)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (!usedFor(tail, 1))
+      return false;
+    value = slots_[tail & (N - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  RING_ALWAYS_INLINE RingSpan<T> writeSpanImpl(size_t max)
+  {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    size_t idx = head & (N - 1);
+    size_t n = std::min(std::min(max, N - idx), freeFor(head, std::min(max, N - idx)));
+    return {&slots_[idx], n};
+  }
+
+  RING_ALWAYS_INLINE RingSpan<const T> readSpanImpl(size_t max)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    size_t idx = tail & (N - 1);
+    size_t n = std::min(std::min(max, N - idx), usedFor(tail, std::min(max, N - idx)));
+    return {&slots_[idx], n};
+  }
+
+  RING_ALWAYS_INLINE size_t writeImpl(const T *src, size_t n)
+  {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    n = std::min(n, freeFor(head, n));
+    size_t idx = head & (N - 1);
+    size_t first = std::min(n, N - idx);
+    std::copy(src, src + first, &slots_[idx]);
+    std::copy(src + first, src + n, &slots_[0]);
+    head_.store(head + (uint32_t)n, std::memory_order_release);
+    return n;
+  }
+
+  RING_ALWAYS_INLINE size_t readImpl(T *dst, size_t n)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    n = std::min(n, usedFor(tail, n));
+    size_t idx = tail & (N - 1);
+    size_t first = std::min(n, N - idx);
+    std::copy(&slots_[idx], &slots_[idx] + first, dst);
+    std::copy(&slots_[0], &slots_[0] + (n - first), dst + first);
+    tail_.store(tail + (uint32_t)n, std::memory_order_release);
+    return n;
+  }
+
+  // 生产者一侧：写索引与读索引副本
+  alignas(RING_CACHE_LINE) std::atomic<uint32_t> head_{0};
+  uint32_t tail_cache_ = 0;
+
+  // 消费者一侧：读索引与写索引副本
+  alignas(RING_CACHE_LINE) std::atomic<uint32_t> tail_{0};
+  uint32_t head_cache_ = 0;
+
+  alignas(RING_CACHE_LINE) T slots_[N] = {};
+};
+
+//===========================================================
+// MPSC
+//===========================================================
+/**
+ * @brief 多生产者 / 单消费者环形缓冲区（每个槽一个序号；deferred_log.h 的日志队列使用它）
+ *
+ * 生产者用一次 CAS 占位，写入后发布序号；某个生产者在占位与发布之间被抢占时，
+ * 消费者只会看到后面的元素暂不可读，不会等待。数据与序号分开存放，
+ * readSpan() 返回的已发布元素是连续的。
+ */
+template <class T, size_t N>
+class MpscRing
+{
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "容量必须是 2 的幂");
+
+public:
+  MpscRing()
+  {
+    for (uint32_t i = 0; i < N; i++)
+      seq_[i].store(i, std::memory_order_relaxed);
+  }
+
+  static constexpr size_t capacity() { return N; }
+
+  /** @brief 当前元素数（含已占位未发布的，近似值） */
+  size_t size() const
+  {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+
+  //===========================================================
+  // 生产者（任意任务 / ISR）
+  //===========================================================
+  bool push(const T &value) { return pushImpl(value); }
+  RING_ALWAYS_INLINE bool pushFromISR(const T &value) { return pushImpl(value); }
+
+  //===========================================================
+  // 消费者
+  //===========================================================
+  bool pop(T &value) { return popImpl(value); }
+  RING_ALWAYS_INLINE bool popFromISR(T &value) { return popImpl(value); }
+
+  /** @brief 取得已发布的连续区域（最多 max 个，到回绕点或第一个未发布的槽为止） */
+  RingSpan<const T> readSpan(size_t max = N)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    size_t idx = tail & (N - 1);
+    size_t limit = std::min(max, N - idx);
+    size_t n = 0;
+    while (n < limit && seq_[idx + n].load(std::memory_order_acquire) == tail + (uint32_t)n + 1)
+      n++;
+    return {&slots_[idx], n};
+  }
+
+  /** @brief 释放 readSpan() 中已处理的 n 个槽 */
+  void commitRead(size_t n)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < n; i++)
+      seq_[(tail + i) & (N - 1)].store(tail + i + N, std::memory_order_release);
+    tail_.store(tail + (uint32_t)n, std::memory_order_release);
+  }
+
+private:
+  RING_ALWAYS_INLINE bool pushImpl(const T &value)
+  {
+    uint32_t pos = head_.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      int32_t diff = (int32_t)(seq_[pos & (N - 1)].load(std::memory_order_acquire) - pos);
+      if (diff == 0)
+      {
+        if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          break;
+      }
+      else if (diff < 0)
+      {
+        return false; // 满：该槽上一轮的元素尚未被读取
+      }
+      else
+      {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+    slots_[pos & (N - 1)] = value;
+    seq_[pos & (N - 1)].store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  RING_ALWAYS_INLINE bool popImpl(T &value)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    std::atomic<uint32_t> &seq = seq_[tail & (N - 1)];
+    if (seq.load(std::memory_order_acquire) != tail + 1)
+      return false;
+    value = slots_[tail & (N - 1)];
+    seq.store(tail + N, std::memory_order_release);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  alignas(RING_CACHE_LINE) std::atomic<uint32_t> head_{0}; // 生产者共享
+  alignas(RING_CACHE_LINE) std::atomic<uint32_t> tail_{0}; // 只由消费者修改
+  alignas(RING_CACHE_LINE) std::atomic<uint32_t> seq_[N];
+  T slots_[N] = {};
+};
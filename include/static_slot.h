@@ -0,0 +1,50 @@
+/**
+ * @file static_slot.h
+ * @brief 静态存储槽：在编译期确定大小的静态内存中构造对象（placement new）
+ *
+ * AUDIO_STATIC_ALLOC=1（默认）：对象位于 .bss，地址与布局在链接时确定，不占用堆；
+ * AUDIO_STATIC_ALLOC=0：退回 new，用于对比启动时间与堆碎片。
+ *
+ * 对象在 setup() 中按需要的顺序构造，生命周期与程序相同，不会析构。
+ */
+#pragma once
+
+#include <new>
+#include <stdint.h>
+#include <utility>
+
+#ifndef AUDIO_STATIC_ALLOC
+#define AUDIO_STATIC_ALLOC 1
+#endif
+
+#if AUDIO_STATIC_ALLOC
+
+template <class T>
+class StaticSlot
+{
+public:
+  /** @brief 在槽内构造对象（只能调用一次） */
+  template <class... Args>
+  T *emplace(Args &&...args)
+  {
+    return new (storage_) T(std::forward<Args>(args)...);
+  }
+
+private:
+  alignas(T) uint8_t storage_[sizeof(T)];
+};
+
+#else
+
+template <class T>
+class StaticSlot
+{
+public:
+  template <class... Args>
+  T *emplace(Args &&...args)
+  {
+    return new T(std::forward<Args>(args)...);
+  }
+};
+
+#endif
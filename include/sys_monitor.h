@@ -0,0 +1,75 @@
+/**
+ * @file sys_monitor.h
+ * @brief 系统监视：各核 CPU 占用、任务栈高水位、内部 / PSRAM / DMA 堆最小剩余
+ *
+ * 监视任务（见 task_plan.h）以最低优先级周期运行，每个周期调用一次 uxTaskGetSystemState()，
+ * 输出一行 JSON；音频任务上没有任何额外开销。
+ *
+ * CPU 占用依赖 FreeRTOS 运行时统计（CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS），
+ * 未启用时 "cpu" 为空数组，其余字段不受影响。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+// 周期输出间隔（毫秒），0 表示不启动监视任务（仍可用串口命令 "mon" 查询）
+#ifndef SYS_MONITOR_PERIOD_MS
+#define SYS_MONITOR_PERIOD_MS 5000
+#endif
+
+// 一次最多统计的任务数
+#define SYS_MONITOR_MAX_TASKS 24
+
+// 一行 JSON 的最大长度
+#define SYS_MONITOR_JSON_SIZE 1024
+
+/**
+ * @brief 启动监视任务（TASK_PLAN 中的 monitor，周期为 SYS_MONITOR_PERIOD_MS）
+ *
+ * @param out 输出目标（通常为 Serial）
+ * @return 任务创建成功
+ */
+bool sysMonitorStart(Print &out);
+
+/**
+ * @brief 采样一次并生成 JSON
+ *
+ * {"t":毫秒,"cpu":[核0占用%,核1占用%],
+ *  "heap":{"int":[当前,最小,最大块],"psram":[当前,最小],"dma":[当前,最小]},
+ *  "tasks":[["名称",栈高水位字节,优先级],...]}
+ *
+ * CPU 占用为与上一次采样之间的平均值（首次调用时为启动以来）。
+ * 任务列表与 CPU 占用的基准是静态的，只能由一个任务调用：监视任务运行时就是监视任务，
+ * 其他地方（串口命令）使用 sysMonitorLast()。
+ *
+ * @return 写入的字符数（不含结尾 0）
+ */
+size_t sysMonitorToJson(char *buf, size_t len);
+
+/**
+ * @brief 最近一次采样的 JSON（串口命令 "mon" 使用）
+ *
+ * 监视任务运行时复制它最近一次输出的结果（不重新采样，不改变 CPU 占用的基准）；
+ * 未运行时（SYS_MONITOR_PERIOD_MS 为 0 或主机构建）直接调用 sysMonitorToJson()。
+ *
+ * @return 写入的字符数（不含结尾 0）
+ */
+size_t sysMonitorLast(char *buf, size_t len);
+
+/**
+ * @brief 内部堆快照（主机构建全为 0）
+ */
+struct HeapSnapshot
+{
+  uint32_t free_bytes;    // 当前剩余
+  uint32_t min_free;      // 历史最小剩余
+  uint32_t largest_block; // 最大连续空闲块
+};
+
+HeapSnapshot heapSnapshot();
+
+/** @brief 碎片率（%）：1 - 最大空闲块 / 剩余总量 */
+static inline uint32_t heapFragmentation(const HeapSnapshot &h)
+{
+  return h.free_bytes ? 100 - (uint32_t)((uint64_t)h.largest_block * 100 / h.free_bytes) : 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file task_plan.h
+ * @brief 任务拓扑：各任务的核心、优先级、栈大小集中在 task_plan.cpp 的 TASK_PLAN 中配置
+ *
+ *   audio    I2S 读写 / DSP         核心 1，最高优先级
+ *   storage  SD 读写、WAV 编解码     核心 0
+ *   control  Arduino loopTask：状态切换、串口命令（核心由 Arduino 固定，只调整优先级）
+ *   log      延迟日志格式化          低优先级，不绑定核心
+ *   monitor  CPU / 栈 / 堆监视       最低优先级，不绑定核心
+ *
+ * 任务体写成 "step" 函数：每次处理一个单位的工作后返回。
+ * AUDIO_TASKS=1 时每个 step 在自己的 FreeRTOS 任务中循环运行；
+ * AUDIO_TASKS=0（主机构建固定为 0）时不创建任务，由 control 在等待时轮流调用各 step，
+ * 与原先所有工作都在 loop() 中完成的方式相同，可用于对比抖动。
+ */
+#pragma once
+
+#include <Arduino.h>
+
+#if defined(HOST_BUILD)
+#undef AUDIO_TASKS
+#define AUDIO_TASKS 0
+#endif
+
+#ifndef AUDIO_TASKS
+#define AUDIO_TASKS 1
+#endif
+
+/**
+ * @brief 任务编号（TASK_PLAN 的下标）
+ */
+enum class TaskId : uint8_t
+{
+  Audio,
+  Storage,
+  Control,
+  Logging,
+  Monitor,
+  Count
+};
+
+#define TASK_ANY_CORE -1
+
+struct TaskSpec
+{
+  const char *name;
+  uint32_t stack_bytes;
+  uint8_t priority;
+  int8_t core;        // TASK_ANY_CORE: 不绑定
+  uint32_t period_ms; // 0: 事件驱动（step 内部用 taskSleep 等待）；>0: 每周期调用一次 step
+};
+
+extern const TaskSpec TASK_PLAN[(size_t)TaskId::Count];
+
+static inline const TaskSpec &taskSpec(TaskId id) { return TASK_PLAN[(size_t)id]; }
+
+using TaskStep = void (*)();
+
+/**
+ * @brief 按 TASK_PLAN 启动任务
+ *
+ * Control 不创建新任务，只把当前任务（loopTask）的优先级设为计划值。
+ * AUDIO_TASKS=0 时只登记 step，由 taskWait() / taskWaitOn() 调用。
+ */
+bool taskStart(TaskId id, TaskStep step);
+
+/**
+ * @brief 当前任务没有工作可做时调用：等待 taskWake() 或超时（AUDIO_TASKS=0 时直接返回）
+ */
+void taskSleep(TaskId self, uint32_t timeout_ms = 10);
+
+/** @brief 唤醒在 taskSleep() 中等待的任务（可在其他任务中调用） */
+void taskWake(TaskId id);
+
+/**
+ * @brief 等待另一个任务取得进展（例如队列满时等待消费者）
+ *
+ * AUDIO_TASKS=1：短暂休眠，等待对方 taskWake() 或 1 个 tick；
+ * AUDIO_TASKS=0：直接运行对方的 step 一次。
+ */
+void taskWaitOn(TaskId self, TaskId other);
+
+/**
+ * @brief control 等待后台任务时调用
+ *
+ * AUDIO_TASKS=1：vTaskDelay(ms)；AUDIO_TASKS=0：轮流运行所有登记的 step 一次。
+ */
+void taskWait(uint32_t ms);
+
+/**
+ * @brief control 没有工作可做时调用（loop() 末尾）
+ *
+ * AUDIO_TASKS=1：等待 taskWake(TaskId::Control)（录音 / 播放完成时）或超时，不是固定延时；
+ * AUDIO_TASKS=0：轮流运行所有登记的 step 一次。
+ */
+void taskIdle(uint32_t timeout_ms);
@@ -0,0 +1,67 @@
+/**
+ * @file wav_header.h
+ * @brief WAV 头检查：播放前验证 SD 卡上的文件，拒绝格式异常的 WAV
+ *
+ * player->setPath() 会直接把文件交给解码器；损坏或恶意构造的头部
+ * （块长度越界、格式字段异常、缺少 data 块等）可能让解码器卡住或越界读取。
+ * 这里只在固定大小的缓冲区内做有界解析，不分配内存，任何长度字段都先做范围检查。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FS.h"
+
+// 头部检查最多读取的字节数（data 块必须出现在这个范围内）
+#define WAV_PROBE_HEADER_SIZE 1024
+
+/**
+ * @brief WAV 头检查结果
+ */
+enum class WavError : uint8_t
+{
+  None,        // 正常
+  Io,          // 读取失败
+  NotRiff,     // 不是 RIFF 文件
+  NotWave,     // RIFF 类型不是 WAVE
+  BadChunk,    // 块长度越界
+  NoFmt,       // data 块之前没有 fmt 块
+  BadFmt,      // fmt 块长度或字段不合法
+  Unsupported, // 非 PCM 编码 / 不支持的位数、通道数或采样率
+  NoData,      // 检查范围内没有 data 块
+  Truncated,   // data 块起点超出文件
+};
+
+/**
+ * @brief 解析得到的 WAV 格式
+ */
+struct WavFormat
+{
+  uint16_t channels;
+  uint32_t sample_rate;
+  uint16_t bits_per_sample;
+  uint16_t block_align;
+  uint32_t data_offset; // PCM 数据起点（字节）
+  uint32_t data_length; // PCM 数据长度（已按文件大小截断）
+};
+
+/**
+ * @brief 解析内存中的 WAV 头
+ *
+ * @param buf        文件开头的数据
+ * @param len        buf 的有效长度
+ * @param file_size  文件总大小（用于检查 / 截断 data 长度）
+ * @param out        解析结果（仅在返回 WavError::None 时有效）
+ */
+WavError parseWavHeader(const uint8_t *buf, size_t len, size_t file_size, WavFormat &out);
+
+/**
+ * @brief 从文件开头读取并检查 WAV 头，完成后文件位置恢复到开头
+ */
+WavError probeWavFile(fs::File &file, WavFormat &out);
+
+/**
+ * @brief 错误码名称（用于日志）
+ */
+const char *wavErrorName(WavError err);
@@ -0,0 +1,306 @@
+/**
+ * @file audio_control.cpp
+ * @brief 录音 / 播放命令队列与状态机实现
+ */
+#include "audio_control.h"
+
+#include "audio_stats.h"
+#include "power_manager.h"
+#include "audio_tasks.h"
+#include "ring_buffer.h"
+#include "wav_header.h"
+
+namespace
+{
+  AudioControlConfig s_config;
+
+  // 命令队列：任何任务都可以放入，只有 control 取出
+  MpscRing<AudioCommand, AUDIO_COMMAND_QUEUE_DEPTH> s_queue;
+  std::atomic<uint16_t> s_stop_epoch{0}; // stop 次数（post 时递增）
+  uint16_t s_stopped_epoch = 0;           // 已执行的 stop 次数
+
+  // 已取出、等待空闲才能执行的命令（保持队列顺序）
+  AudioCommand s_pending;
+  bool s_has_pending = false;
+
+  AudioControlState s_state = AudioControlState::Idle;
+  AudioCommand s_current; // 正在执行的 record / play
+
+  // 录音输出（录音期间一直有效）
+  File s_rec_file;
+  StatsFileSink s_rec_sink(s_rec_file); // 统计 SD 写入
+
+  uint32_t s_commands = 0;
+  uint32_t s_step_max_us = 0;
+
+  const char *commandName(AudioCommandType type)
+  {
+    switch (type)
+    {
+    case AudioCommandType::Record:
+      return "record";
+    case AudioCommandType::Play:
+      return "play";
+    case AudioCommandType::Stop:
+      return "stop";
+    case AudioCommandType::Stats:
+      return "stats";
+    }
+    return "?";
+  }
+
+  bool checkWavFile(fs::FS &fs, const char *path)
+  {
+    File file = fs.open(path);
+    if (!file)
+    {
+      s_config.out->printf("无法打开 %s\n", path);
+      return false;
+    }
+
+    WavFormat fmt;
+    WavError err = probeWavFile(file, fmt);
+    file.close();
+    if (err != WavError::None)
+    {
+      s_config.out->printf("WAV 格式错误 %s: %s\n", path, wavErrorName(err));
+      return false;
+    }
+    return true;
+  }
+
+  //===========================================================
+  // 状态切换（只打开文件、设置参数，数据由 audio / storage 任务处理）
+  //===========================================================
+  bool startRecord(const AudioCommand &cmd)
+  {
+    uint16_t seconds = cmd.seconds ? cmd.seconds : s_config.record_seconds;
+    s_config.out->printf("开始录音 %s（%u 秒）\n", s_config.record_path, (unsigned)seconds);
+
+    // 停止播放器，确保 I2S RX 可用
+    s_config.player->end();
+
+    s_rec_file = s_config.record_fs->open(s_config.record_path, FILE_WRITE);
+    if (!s_rec_file)
+    {
+      s_config.out->printf("无法创建 %s\n", s_config.record_path);
+      return false;
+    }
+
+    s_config.encoder->begin(s_config.info);
+    s_config.encoder->setOutput(s_rec_sink);
+
+    // 播放器按文件格式设置过 I2S（例如 44.1 kHz 16 位）：恢复录音格式，与 WAV 头一致
+    if (s_config.i2s && s_config.i2s->audioInfo() != s_config.info)
+      s_config.i2s->setAudioInfo(s_config.info);
+
+    // audio 任务：I2S 读取 → 对齐 → 分发（电平表、storage 队列）；storage 任务：WAV 编码 → SD
+    s_config.level->reset();
+    return audioRecordStart(*s_config.encoder, (size_t)seconds * s_config.info.sample_rate * s_config.info.channels);
+  }
+
+  void finishRecord()
+  {
+    s_config.encoder->end(); // 写 WAV 头
+    s_rec_file.close();
+    s_config.out->printf("录音完成：%s（%.2f 秒，峰值 %.1f dBFS，RMS %.1f dBFS）\n", s_config.record_path,
+                         (double)audioRecordedSamples() / s_config.info.sample_rate, s_config.level->peakDbfs(),
+                         s_config.level->rmsDbfs());
+    uint32_t dropped = audioRecordDroppedBlocks();
+    if (dropped)
+      s_config.out->printf("录音不完整：丢弃 %lu 块（SD 写入跟不上）\n", (unsigned long)dropped);
+  }
+
+  bool startPlay(const AudioCommand &cmd)
+  {
+    s_config.out->printf("播放 %s\n", cmd.path);
+    if (!checkWavFile(*s_config.play_fs, cmd.path))
+      return false;
+
+    s_config.player->setPath(cmd.path);
+    s_config.player->play();
+    return audioPlayStart(); // storage 解码 WAV → 块队列 → audio 写入 I2S
+  }
+
+  void printStatus()
+  {
+    s_config.out->printf("[ctl] state %s, queued %u, commands %lu, step max %lu us\n",
+                         audioControlStateName(s_state), (unsigned)(s_queue.size() + (s_has_pending ? 1 : 0)),
+                         (unsigned long)s_commands, (unsigned long)s_step_max_us);
+    char json[640];
+    audioStatsToJson(json, sizeof(json));
+    s_config.out->println(json);
+    pmToJson(json, sizeof(json));
+    s_config.out->println(json);
+  }
+
+  /** @brief 执行一条命令；record / play 只在 Idle 时调用 */
+  void execute(const AudioCommand &cmd)
+  {
+    s_commands++;
+    switch (cmd.type)
+    {
+    case AudioCommandType::Record:
+      s_current = cmd;
+      s_state = startRecord(cmd) ? AudioControlState::Recording : AudioControlState::Idle;
+      if (s_state == AudioControlState::Idle && s_rec_file)
+        s_rec_file.close();
+      break;
+
+    case AudioCommandType::Play:
+      s_current = cmd;
+      s_state = startPlay(cmd) ? AudioControlState::Playing : AudioControlState::Idle;
+      break;
+
+    case AudioCommandType::Stats:
+      printStatus();
+      break;
+
+    case AudioCommandType::Stop:
+      break;
+    }
+  }
+
+  /** @brief 录音 / 播放完成（或已停止）后回到 Idle */
+  void finishCurrent()
+  {
+    if (s_state == AudioControlState::Recording)
+      finishRecord();
+    else
+      s_config.out->printf("播放完成：%s\n", s_current.path);
+    s_state = AudioControlState::Idle;
+  }
+}
+
+void audioControlBegin(const AudioControlConfig &config) { s_config = config; }
+
+bool audioCommandParse(const char *line, AudioCommand &cmd)
+{
+  memset(&cmd, 0, sizeof(cmd));
+  if (strcmp(line, "stop") == 0)
+  {
+    cmd.type = AudioCommandType::Stop;
+    return true;
+  }
+  if (strcmp(line, "stats") == 0)
+  {
+    cmd.type = AudioCommandType::Stats;
+    return true;
+  }
+  if (strncmp(line, "record", 6) == 0 && (line[6] == 0 || line[6] == ' '))
+  {
+    cmd.type = AudioCommandType::Record;
+    long seconds = atol(line + 6);
+    cmd.seconds = (uint16_t)(seconds > 0 && seconds <= 3600 ? seconds : 0);
+    return true;
+  }
+  if (strncmp(line, "play", 4) == 0 && (line[4] == 0 || line[4] == ' '))
+  {
+    const char *path = line + 4;
+    while (*path == ' ')
+      path++;
+    cmd.type = AudioCommandType::Play;
+    strncpy(cmd.path, *path ? path : s_config.record_path, sizeof(cmd.path) - 1);
+    return true;
+  }
+  return false;
+}
+
+bool audioCommandPost(const AudioCommand &cmd)
+{
+  if (cmd.type == AudioCommandType::Stop)
+  {
+    // 不排队：下一次 audioControlStep() 立即执行
+    s_stop_epoch.fetch_add(1, std::memory_order_acq_rel);
+    taskWake(TaskId::Control);
+    return true;
+  }
+  AudioCommand queued = cmd;
+  queued.epoch = s_stop_epoch.load(std::memory_order_acquire);
+  if (!s_queue.push(queued))
+    return false;
+  taskWake(TaskId::Control);
+  return true;
+}
+
+bool audioCommandPostRecord(uint16_t seconds)
+{
+  AudioCommand cmd{};
+  cmd.type = AudioCommandType::Record;
+  cmd.seconds = seconds;
+  return audioCommandPost(cmd);
+}
+
+bool audioCommandPostPlay(const char *path)
+{
+  AudioCommand cmd{};
+  cmd.type = AudioCommandType::Play;
+  strncpy(cmd.path, path, sizeof(cmd.path) - 1);
+  return audioCommandPost(cmd);
+}
+
+void audioControlStep()
+{
+  uint32_t start_us = micros();
+
+  uint16_t stop_epoch = s_stop_epoch.load(std::memory_order_acquire);
+  if (stop_epoch != s_stopped_epoch)
+  {
+    s_stopped_epoch = stop_epoch;
+    audioStop();
+    s_commands++;
+    s_config.out->println("stop");
+  }
+
+  if (s_state != AudioControlState::Idle && !audioBusy())
+    finishCurrent();
+  if (!audioBusy())
+    pmIdleStep(); // 没有 esp_pm 时在这里降频（不在 audio / storage 任务中切换频率）
+
+  // 按顺序执行：stats 随时可以执行，record / play 等待空闲
+  for (;;)
+  {
+    if (!s_has_pending)
+    {
+      if (!s_queue.pop(s_pending))
+        break;
+      s_has_pending = true;
+    }
+    int16_t age = (int16_t)(s_pending.epoch - s_stopped_epoch); // 回绕安全的比较
+    if (age < 0)
+    {
+      // 在最近一次 stop 之前排队
+      s_has_pending = false;
+      s_config.out->printf("丢弃排队的命令 %s\n", commandName(s_pending.type));
+      continue;
+    }
+    if (age > 0)
+      break; // 在本次读取 stop 计数之后才有新的 stop：留到下一步先执行 stop 再处理
+    if (s_pending.type != AudioCommandType::Stats && s_state != AudioControlState::Idle)
+      break;
+    s_has_pending = false;
+    execute(s_pending);
+  }
+
+  uint32_t elapsed = micros() - start_us;
+  if (elapsed > s_step_max_us)
+    s_step_max_us = elapsed;
+}
+
+bool audioControlIdle() { return s_state == AudioControlState::Idle && !s_has_pending && s_queue.empty(); }
+
+AudioControlState audioControlState() { return s_state; }
+
+const char *audioControlStateName(AudioControlState state)
+{
+  switch (state)
+  {
+  case AudioControlState::Idle:
+    return "idle";
+  case AudioControlState::Recording:
+    return "recording";
+  case AudioControlState::Playing:
+    return "playing";
+  }
+  return "?";
+}
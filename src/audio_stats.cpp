@@ -0,0 +1,137 @@
+/**
+ * @file audio_stats.cpp
+ * @brief 音频流水线统计实现
+ */
+#include "audio_stats.h"
+
+AudioStats g_audio_stats;
+
+//===========================================================
+// 延迟直方图
+//===========================================================
+static inline int bucketIndex(uint32_t us)
+{
+  if (us < LATENCY_HIST_SUB_BUCKETS)
+    return (int)us;
+  int msb = 31 - __builtin_clz(us);
+  int sub = (int)((us >> (msb - 2)) & (LATENCY_HIST_SUB_BUCKETS - 1));
+  return (msb - 1) * LATENCY_HIST_SUB_BUCKETS + sub;
+}
+
+static inline uint32_t bucketUpper(int idx)
+{
+  if (idx < LATENCY_HIST_SUB_BUCKETS)
+    return (uint32_t)idx;
+  int msb = idx / LATENCY_HIST_SUB_BUCKETS + 1;
+  int sub = idx % LATENCY_HIST_SUB_BUCKETS;
+  uint64_t lower = (uint64_t)(LATENCY_HIST_SUB_BUCKETS + sub) << (msb - 2);
+  return (uint32_t)(lower + (1ULL << (msb - 2)) - 1);
+}
+
+void LatencyHistogram::record(uint32_t us)
+{
+  buckets[bucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_relaxed);
+  statMax(max_us, us);
+}
+
+uint32_t LatencyHistogram::percentile(float p) const
+{
+  uint32_t total = count.load(std::memory_order_relaxed);
+  if (!total)
+    return 0;
+  uint32_t rank = (uint32_t)(p / 100.0f * (float)total + 0.5f);
+  if (rank < 1)
+    rank = 1;
+  uint32_t seen = 0;
+  for (int i = 0; i < LATENCY_HIST_BUCKETS; i++)
+  {
+    seen += buckets[i].load(std::memory_order_relaxed);
+    if (seen >= rank)
+    {
+      uint32_t upper = bucketUpper(i);
+      uint32_t max = max_us.load(std::memory_order_relaxed);
+      return upper < max ? upper : max;
+    }
+  }
+  return max_us.load(std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset()
+{
+  for (auto &b : buckets)
+    b.store(0, std::memory_order_relaxed);
+  count.store(0, std::memory_order_relaxed);
+  max_us.store(0, std::memory_order_relaxed);
+}
+
+//===========================================================
+// 统计项
+//===========================================================
+void audioStatsSetDmaBudget(const AudioInfo &info, int buffer_count, int buffer_size)
+{
+  uint32_t frame_bytes = (uint32_t)info.channels * (info.bits_per_sample == 16 ? 2 : 4);
+  uint64_t bytes = (uint64_t)buffer_count * (uint64_t)buffer_size;
+  uint32_t us = (uint32_t)(bytes * 1000000ULL / ((uint64_t)frame_bytes * (uint64_t)info.sample_rate));
+  g_audio_stats.dma_budget_us.store(us, std::memory_order_relaxed);
+  g_audio_stats.byte_rate.store(frame_bytes * (uint32_t)info.sample_rate, std::memory_order_relaxed);
+}
+
+void audioStatsReset()
+{
+  AudioStats &s = g_audio_stats;
+  std::atomic<uint32_t> *counters[] = {
+      &s.i2s_rx_bytes, &s.i2s_tx_bytes, &s.short_reads, &s.overruns, &s.underruns, &s.rx_gap_max_us,
+      &s.tx_block_max, &s.rx_dropped_blocks, &s.encoder_bytes, &s.sd_writes, &s.sd_write_bytes,
+      &s.sd_short_writes, &s.last_read_us, &s.last_write_us,
+  };
+  for (auto *c : counters)
+    c->store(0, std::memory_order_relaxed);
+  s.sd_write_latency.reset();
+  s.rx_jitter.reset();
+}
+
+size_t audioStatsToJson(char *buf, size_t len)
+{
+  AudioStats &s = g_audio_stats;
+  auto v = [](const std::atomic<uint32_t> &a)
+  { return (unsigned long)a.load(std::memory_order_relaxed); };
+
+  int n = snprintf(buf, len,
+                   "{\"i2s\":{\"rx_bytes\":%lu,\"tx_bytes\":%lu,\"short_reads\":%lu,\"overruns\":%lu,"
+                   "\"underruns\":%lu,\"rx_gap_max_us\":%lu,\"dma_budget_us\":%lu,\"tx_block_max\":%lu,"
+                   "\"rx_dropped_blocks\":%lu,\"rx_jitter_us\":{\"p50\":%lu,\"p99\":%lu,\"max\":%lu}},"
+                   "\"encoder\":{\"bytes\":%lu},"
+                   "\"sd\":{\"writes\":%lu,\"bytes\":%lu,\"short_writes\":%lu,"
+                   "\"write_us\":{\"p50\":%lu,\"p99\":%lu,\"max\":%lu}}}",
+                   v(s.i2s_rx_bytes), v(s.i2s_tx_bytes), v(s.short_reads), v(s.overruns), v(s.underruns),
+                   v(s.rx_gap_max_us), v(s.dma_budget_us), v(s.tx_block_max), v(s.rx_dropped_blocks),
+                   (unsigned long)s.rx_jitter.percentile(50), (unsigned long)s.rx_jitter.percentile(99),
+                   v(s.rx_jitter.max_us), v(s.encoder_bytes), v(s.sd_writes),
+                   v(s.sd_write_bytes), v(s.sd_short_writes), (unsigned long)s.sd_write_latency.percentile(50),
+                   (unsigned long)s.sd_write_latency.percentile(99), v(s.sd_write_latency.max_us));
+  if (n < 0)
+    return 0;
+  return (size_t)n < len ? (size_t)n : len - 1;
+}
+
+//===========================================================
+// 统计包装
+//===========================================================
+size_t StatsFileSink::write(const uint8_t *data, size_t len)
+{
+  uint32_t start = micros();
+  TRACE_BEGIN(FileWrite, len);
+  size_t n = out_->write(data, len);
+  TRACE_END(FileWrite, n);
+  g_audio_stats.sd_write_latency.record(micros() - start);
+
+  statAdd(g_audio_stats.sd_writes, 1);
+  statAdd(g_audio_stats.sd_write_bytes, (uint32_t)n);
+  if (n < len)
+  {
+    statAdd(g_audio_stats.sd_short_writes, 1);
+    DLOG("sd short write %u/%u", n, len);
+  }
+  return n;
+}
@@ -0,0 +1,399 @@
+/**
+ * @file audio_tasks.cpp
+ * @brief audio / storage 任务的 step 函数与录音、播放流程
+ */
+#include "audio_tasks.h"
+
+#include "audio_format.h"
+#include "audio_stats.h"
+#include "audio_trace.h"
+#include "deferred_log.h"
+#include "es8311_controls.h"
+#include "input_dsp.h"
+#include "power_manager.h"
+#include "record_pipeline.h"
+
+namespace
+{
+  enum class AudioMode : uint8_t
+  {
+    Idle,
+    Record,      // audio 读取中
+    RecordDrain, // 读取完成，storage 写出剩余块
+    Play,        // storage 解码中
+    PlayDrain    // 解码完成，audio 写出剩余块
+  };
+
+  std::atomic<AudioMode> s_mode{AudioMode::Idle};
+
+  Stream *s_i2s_in;
+  Print *s_i2s_out;
+  AudioPlayer *s_player;
+  BlockFanout *s_rx_fanout;
+  BlockTxStream *s_tx;
+
+  BlockQueueSink<AUDIO_RX_QUEUE_DEPTH> s_rx_queue;
+  BlockQueueSink<AUDIO_TX_QUEUE_DEPTH> s_tx_queue;
+
+  // 停止请求（control 设置，audio / storage 在下一次 step 中进入 Drain）
+  std::atomic<bool> s_stop{false};
+
+  // 录音参数（只在 Idle 时由 control 修改）
+  EncoderSink s_encoder_sink;
+  size_t s_total_samples;
+  size_t s_read_samples; // audio 读取的采样数（决定录音何时结束）
+  size_t s_samples;      // 写入编码器的采样数（storage；分发时被拒收的块不计）
+  uint32_t s_dropped;    // 这次录音丢弃的块数（audio）
+
+  // 硬件处理不可用时的录音软件处理（采样类型在编译期确定）
+  InputDsp<RecordFormat::sample_t> s_input_dsp;
+
+  // 录音写入批次（PSRAM 块）：storage 把 DMA 块复制进来后立即归还，攒满一块再写入编码器 / SD
+  AudioBlock *s_batch = nullptr;
+
+  // 块池耗尽时丢弃数据用，保证 I2S 读取不中断
+  uint8_t s_discard[AUDIO_DMA_BLOCK_SIZE];
+
+  //===========================================================
+  // audio：I2S 读写（最高优先级）
+  //===========================================================
+  void audioStep()
+  {
+    switch (s_mode.load(std::memory_order_acquire))
+    {
+    case AudioMode::Record:
+    {
+      AudioBlock *block = g_dma_blocks.acquire();
+      if (!block)
+      {
+        // storage 跟不上：继续读取以免 DMA 溢出，这一块数据丢弃
+        size_t bytes = s_i2s_in->readBytes(s_discard, sizeof(s_discard));
+        statI2SRead(sizeof(s_discard), bytes);
+        statAdd(g_audio_stats.rx_dropped_blocks, 1);
+        s_dropped++;
+        DLOG("record: no free block, dropped %u bytes", (unsigned)bytes);
+        return;
+      }
+      if (!readBlock(*s_i2s_in, block, RecordFormat::bytes_per_sample))
+      {
+        releaseAudioBlock(block);
+        return;
+      }
+      // 读取（等待 DMA）之后到下一次读取之前是这一块的处理时间，按负载决定是否升频
+      pmWorkBegin(TaskId::Audio);
+      uint32_t length = block->length;
+      s_input_dsp.process(block);
+      s_read_samples += length / RecordFormat::bytes_per_sample;
+      uint32_t dropped = s_rx_fanout->dropped();
+      s_rx_fanout->dispatch(block);
+      dropped = s_rx_fanout->dropped() - dropped;
+      if (dropped)
+      {
+        // 录音队列满（SD 停顿超过队列时长）：这一块不会写入文件
+        statAdd(g_audio_stats.rx_dropped_blocks, dropped);
+        s_dropped += dropped;
+        DLOG("record: queue full, dropped %u bytes", (unsigned)length);
+      }
+      pmWorkEnd(TaskId::Audio, pmBlockUs(length));
+      if (s_read_samples >= s_total_samples || s_stop.load(std::memory_order_relaxed))
+        s_mode.store(AudioMode::RecordDrain, std::memory_order_release);
+      taskWake(TaskId::Storage);
+      return;
+    }
+
+    case AudioMode::Play:
+    case AudioMode::PlayDrain:
+    {
+      // 先读状态再查队列：看到 PlayDrain 且队列为空时，storage 已送出全部数据
+      bool draining = s_mode.load(std::memory_order_acquire) == AudioMode::PlayDrain;
+      AudioBlock *block = s_tx_queue.pop();
+      if (block)
+      {
+        s_i2s_out->write(block->data, block->length);
+        releaseAudioBlock(block);
+        taskWake(TaskId::Storage);
+      }
+      else if (draining)
+      {
+        pmStreamEnd();
+        s_mode.store(AudioMode::Idle, std::memory_order_release);
+        taskWake(TaskId::Control);
+      }
+      else
+      {
+        taskSleep(TaskId::Audio, 2);
+      }
+      return;
+    }
+
+    default:
+      taskSleep(TaskId::Audio);
+      return;
+    }
+  }
+
+  //===========================================================
+  // storage：SD 读写与编解码
+  //===========================================================
+  /** @brief 写出录音批次（没有数据时只归还） */
+  void flushRecordBatch()
+  {
+    if (!s_batch)
+      return;
+    if (s_batch->length)
+      s_encoder_sink.push(s_batch); // 写入编码器并释放
+    else
+      releaseAudioBlock(s_batch);
+    s_batch = nullptr;
+  }
+
+  /** @brief 录音块交给编码器：有 PSRAM 块池时合并成 AUDIO_PSRAM_BLOCK_SIZE 的写入，否则逐块写入 */
+  void writeRecordBlock(AudioBlock *block)
+  {
+    if (!s_batch)
+      s_batch = acquireAudioBlock(AUDIO_PSRAM_BLOCK_SIZE);
+    if (!s_batch)
+    {
+      s_encoder_sink.push(block);
+      return;
+    }
+    memcpy(s_batch->data + s_batch->length, block->data, block->length);
+    s_batch->length += block->length;
+    releaseAudioBlock(block);
+    if (s_batch->capacity - s_batch->length < AUDIO_DMA_BLOCK_SIZE)
+      flushRecordBatch();
+  }
+
+  void storageStep()
+  {
+    AudioMode mode = s_mode.load(std::memory_order_acquire);
+    switch (mode)
+    {
+    case AudioMode::Record:
+    case AudioMode::RecordDrain:
+    {
+      bool any = false;
+      size_t bytes = 0;
+      pmWorkBegin(TaskId::Storage);
+      while (AudioBlock *block = s_rx_queue.pop())
+      {
+        bytes += block->length;
+        s_samples += block->length / RecordFormat::bytes_per_sample;
+        writeRecordBlock(block);
+        any = true;
+      }
+      pmWorkEnd(TaskId::Storage, pmBlockUs(bytes));
+      if (!any)
+      {
+        if (mode == AudioMode::RecordDrain)
+        {
+          pmWorkBegin(TaskId::Storage);
+          flushRecordBatch();
+          pmWorkEnd(TaskId::Storage, 0);
+          pmStreamEnd();
+          s_mode.store(AudioMode::Idle, std::memory_order_release);
+          taskWake(TaskId::Control);
+        }
+        else
+          taskSleep(TaskId::Storage);
+      }
+      return;
+    }
+
+    case AudioMode::Play:
+    {
+      TRACE_BEGIN(PlayerCopy, 0);
+      pmWorkBegin(TaskId::Storage);
+      size_t n = s_player->isActive() && !s_stop.load(std::memory_order_relaxed) ? s_player->copy() : 0;
+      pmWorkEnd(TaskId::Storage, pmBlockUs(n, s_tx->audioInfo())); // WAV：读取的字节数约等于输出 PCM
+      TRACE_END(PlayerCopy, n);
+      if (!n)
+      {
+        s_tx->flush();
+        s_mode.store(AudioMode::PlayDrain, std::memory_order_release);
+        taskWake(TaskId::Audio);
+      }
+      return;
+    }
+
+    default:
+      taskSleep(TaskId::Storage);
+      return;
+    }
+  }
+
+  /** @brief control 等待回到 Idle */
+  void waitIdle()
+  {
+    while (s_mode.load(std::memory_order_acquire) != AudioMode::Idle)
+      taskWait(5);
+  }
+}
+
+//===========================================================
+// BlockTxStream
+//===========================================================
+size_t BlockTxStream::write(const uint8_t *data, size_t len)
+{
+  size_t done = 0;
+  while (done < len)
+  {
+    if (!current_)
+    {
+      current_ = g_dma_blocks.acquire();
+      if (!current_)
+      {
+        pmWorkPause(TaskId::Storage);
+        taskWaitOn(TaskId::Storage, TaskId::Audio); // 等待 audio 归还块
+        pmWorkResume(TaskId::Storage);
+        continue;
+      }
+    }
+    size_t n = std::min((size_t)(current_->capacity - current_->length), len - done);
+    memcpy(current_->data + current_->length, data + done, n);
+    current_->length += (uint32_t)n;
+    done += n;
+    if (current_->length == current_->capacity)
+    {
+      push(current_);
+      current_ = nullptr;
+    }
+  }
+  return done;
+}
+
+void BlockTxStream::flush()
+{
+  if (current_ && current_->length)
+    push(current_);
+  else if (current_)
+    releaseAudioBlock(current_);
+  current_ = nullptr;
+}
+
+void BlockTxStream::push(AudioBlock *block)
+{
+  while (!s_tx_queue.push(block))
+  {
+    pmWorkPause(TaskId::Storage); // 等待不算处理时间
+    taskWaitOn(TaskId::Storage, TaskId::Audio); // TX 队列满，等待 audio 写出
+    pmWorkResume(TaskId::Storage);
+  }
+  taskWake(TaskId::Audio);
+}
+
+//===========================================================
+// 录音 / 播放（control）
+//===========================================================
+bool audioTasksBegin(Stream &i2s_in, Print &i2s_out, AudioPlayer &player, BlockFanout &rx_fanout, BlockTxStream &tx)
+{
+  s_i2s_in = &i2s_in;
+  s_i2s_out = &i2s_out;
+  s_player = &player;
+  s_rx_fanout = &rx_fanout;
+  s_tx = &tx;
+  rx_fanout.add(s_rx_queue);
+
+  return taskStart(TaskId::Audio, audioStep) && taskStart(TaskId::Storage, storageStep);
+}
+
+bool audioRecordStart(Print &encoder, size_t total_samples)
+{
+  if (audioBusy())
+    return false;
+  s_encoder_sink.setEncoder(encoder);
+  s_total_samples = total_samples;
+  s_read_samples = 0;
+  s_samples = 0;
+  s_dropped = 0;
+  s_input_dsp.reset();
+  s_stop.store(false, std::memory_order_relaxed);
+
+  statI2SRestart();
+  pmStreamBegin();
+  s_mode.store(AudioMode::Record, std::memory_order_release);
+  taskWake(TaskId::Audio);
+  return true;
+}
+
+bool audioPlayStart()
+{
+  if (audioBusy())
+    return false;
+  s_stop.store(false, std::memory_order_relaxed);
+
+  statI2SRestart();
+  pmStreamBegin();
+  s_mode.store(AudioMode::Play, std::memory_order_release);
+  taskWake(TaskId::Storage);
+  return true;
+}
+
+bool audioBusy() { return s_mode.load(std::memory_order_acquire) != AudioMode::Idle; }
+
+void audioStop()
+{
+  if (!audioBusy())
+    return;
+  s_stop.store(true, std::memory_order_relaxed);
+  taskWake(TaskId::Audio);
+  taskWake(TaskId::Storage);
+}
+
+size_t audioRecordedSamples() { return s_samples; }
+
+uint32_t audioRecordDroppedBlocks() { return s_dropped; }
+
+size_t audioRecord(Print &encoder, size_t total_samples)
+{
+  if (!audioRecordStart(encoder, total_samples))
+    return 0;
+  waitIdle();
+  return s_samples;
+}
+
+void audioPlay()
+{
+  if (audioPlayStart())
+    waitIdle();
+}
+
+//===========================================================
+// 增益与滤波
+//===========================================================
+bool audioSetInputGainDb(float db)
+{
+  if (es8311SetAdcVolumeDb(db))
+  {
+    s_input_dsp.setGainDb(0);
+    return true;
+  }
+  s_input_dsp.setGainDb(db);
+  return false;
+}
+
+bool audioSetInputHpf(bool enable)
+{
+  if (es8311SetAdcHpf(enable))
+  {
+    s_input_dsp.setHpf(false);
+    return true;
+  }
+  s_input_dsp.setHpf(enable);
+  return false;
+}
+
+bool audioSetOutputVolume(float volume)
+{
+  volume = std::max(0.0f, std::min(1.0f, volume));
+  // 驱动刻度：寄存器 = volume * 255（0.5 dB 步进）；软件退回按同一 dB 换算成线性倍数，
+  // 两条路径的听感一致（软件不放大，高于 0 dB 的部分按 0 dB）
+  float db = es8311VolumeDb((uint8_t)(volume * 255));
+  if (es8311SetDacVolumeDb(db))
+  {
+    s_player->setVolume(1.0f);
+    return true;
+  }
+  s_player->setVolume(db >= 0.0f ? 1.0f : powf(10.0f, db / 20.0f));
+  return false;
+}
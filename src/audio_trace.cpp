@@ -0,0 +1,116 @@
+/**
+ * @file audio_trace.cpp
+ * @brief 跟踪环形缓冲区的导出实现
+ */
+#include "audio_trace.h"
+
+#include <memory>
+
+#if defined(HOST_BUILD)
+#include <chrono>
+#endif
+
+TraceRing g_trace = {{}, {0}, {AUDIO_TRACE != 0}};
+
+const char *traceEventName(TraceEvent event)
+{
+  switch (event)
+  {
+  case TraceEvent::I2sRead:
+    return "i2s_read";
+  case TraceEvent::EncoderWrite:
+    return "encoder_write";
+  case TraceEvent::FileWrite:
+    return "file_write";
+  case TraceEvent::PlayerCopy:
+    return "player_copy";
+  case TraceEvent::I2sWrite:
+    return "i2s_write";
+  case TraceEvent::DmaRx:
+    return "dma_rx";
+  case TraceEvent::DmaTx:
+    return "dma_tx";
+  default:
+    return "unknown";
+  }
+}
+
+void traceClear()
+{
+  g_trace.head.store(0, std::memory_order_relaxed);
+}
+
+namespace
+{
+  // 测量的重复次数
+  const uint32_t kCostRounds = 256;
+
+  /** @brief 计时用的计数：设备上为 CCOUNT（32 位回绕，按差值使用），主机为 steady_clock 纳秒 */
+  inline uint32_t costTicks()
+  {
+#if defined(HOST_BUILD)
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#else
+    return ESP.getCycleCount();
+#endif
+  }
+
+  /** @brief kCostRounds 次的计数差 → 每次的纳秒数（设备上按当前频率换算） */
+  inline unsigned long costNanosEach(uint32_t ticks)
+  {
+#if defined(HOST_BUILD)
+    return (unsigned long)(ticks / kCostRounds);
+#else
+    return (unsigned long)((uint64_t)ticks * 1000 / getCpuFrequencyMhz() / kCostRounds);
+#endif
+  }
+}
+
+size_t traceCostToJson(char *buf, size_t len)
+{
+  // 临时缓冲区（约 8 KB，在堆上），测量期间 g_trace 照常记录
+  std::unique_ptr<TraceRing> ring(new TraceRing());
+  ring->enabled.store(true, std::memory_order_relaxed);
+
+  volatile uint32_t sink = 0;
+  uint32_t t0 = costTicks();
+  for (uint32_t i = 0; i < kCostRounds; i++)
+    sink = sink + traceMicros();
+  uint32_t t1 = costTicks();
+  for (uint32_t i = 0; i < kCostRounds; i++)
+    traceRecordTo(*ring, TraceEvent::I2sRead, TracePhase::Instant, i);
+  uint32_t t2 = costTicks();
+  (void)sink;
+
+  int n = snprintf(buf, len, "{\"point_ns\":%lu,\"timestamp_ns\":%lu,\"cpu_mhz\":%lu}", costNanosEach(t2 - t1),
+                   costNanosEach(t1 - t0), (unsigned long)getCpuFrequencyMhz());
+  return n < 0 ? 0 : ((size_t)n < len ? (size_t)n : len - 1);
+}
+
+void traceDump(Print &out)
+{
+  static const char phases[] = {'B', 'E', 'I'};
+
+  bool was_enabled = g_trace.enabled.exchange(false);
+  uint32_t head = g_trace.head.load(std::memory_order_relaxed);
+  uint32_t count = head < AUDIO_TRACE_ENTRIES ? head : AUDIO_TRACE_ENTRIES;
+
+  out.printf("# trace begin timebase=us entries=%lu dropped=%lu\n", (unsigned long)count,
+             (unsigned long)(head - count));
+  for (uint8_t id = 1; id < (uint8_t)TraceEvent::Count; id++)
+    out.printf("# event %u %s\n", id, traceEventName((TraceEvent)id));
+
+  // 从最旧的条目开始，按写入顺序输出（各核心之间可能有少量乱序，由转换脚本排序）
+  for (uint32_t n = head - count; n != head; n++)
+  {
+    const TraceEntry &e = g_trace.entries[n & (AUDIO_TRACE_ENTRIES - 1)];
+    uint8_t phase = e.ctx & TRACE_CTX_PHASE_MASK;
+    out.printf("T %lu %u %c %u %u %u\n", (unsigned long)e.us, e.event, phase < 3 ? phases[phase] : '?', e.arg,
+               (unsigned)((e.ctx >> TRACE_CTX_CORE_SHIFT) & 0x03), (e.ctx & TRACE_CTX_ISR) ? 1u : 0u);
+  }
+  out.println("# trace end");
+
+  g_trace.enabled.store(was_enabled);
+}
@@ -0,0 +1,139 @@
+/**
+ * @file battery_monitor.cpp
+ * @brief 电池电压监视实现
+ */
+#include "battery_monitor.h"
+
+#include <atomic>
+
+namespace
+{
+  BatteryFilter s_filter;
+  BatteryStatus s_status{};
+  bool s_started = false;
+
+#if BATTERY_ADC_CONTINUOUS
+  std::atomic<bool> s_frame_ready{false};
+
+  /** @brief 一帧转换完成（中断中调用） */
+  void ARDUINO_ISR_ATTR onAdcFrame() { s_frame_ready.store(true, std::memory_order_release); }
+#else
+  uint32_t s_last_poll_ms = 0;
+#endif
+
+  void setLeds(BatteryZone zone)
+  {
+    // 低电平点亮
+    if (BATTERY_LED_HALF_PIN >= 0)
+      digitalWrite(BATTERY_LED_HALF_PIN, zone == BatteryZone::Ok ? HIGH : LOW);
+    if (BATTERY_LED_LOW_PIN >= 0)
+      digitalWrite(BATTERY_LED_LOW_PIN, zone == BatteryZone::Low ? LOW : HIGH);
+    s_status.led_updates++;
+  }
+
+  void addSample(uint32_t pin_mv)
+  {
+    bool first = !s_filter.primed();
+    s_status.millivolts = s_filter.update(pin_mv * BATTERY_DIVIDER);
+    s_status.level = batteryLevel(s_status.millivolts);
+    s_status.samples++;
+
+    // 第一个样本直接决定区间；之后只在区间变化时写 LED
+    BatteryZone zone = first ? batteryZone(s_status.level, BatteryZone::Low) : batteryZone(s_status.level, s_status.zone);
+    if (first || zone != s_status.zone)
+    {
+      s_status.zone = zone;
+      setLeds(zone);
+    }
+  }
+}
+
+uint8_t batteryLevel(uint32_t battery_mv)
+{
+  if (battery_mv <= BATTERY_EMPTY_MV)
+    return 0;
+  if (battery_mv >= BATTERY_FULL_MV)
+    return 255;
+  return (uint8_t)((battery_mv - BATTERY_EMPTY_MV) * 255 / (BATTERY_FULL_MV - BATTERY_EMPTY_MV));
+}
+
+BatteryZone batteryZone(uint8_t level, BatteryZone previous)
+{
+  BatteryZone down = level <= BATTERY_WARNING_LEVEL ? BatteryZone::Low
+                     : level <= BATTERY_HALF_LEVEL  ? BatteryZone::Half
+                                                    : BatteryZone::Ok;
+  if (down >= previous)
+    return down; // 不变或下降
+
+  // 回升：阈值加上滞回
+  BatteryZone up = level <= BATTERY_WARNING_LEVEL + BATTERY_HYSTERESIS ? BatteryZone::Low
+                   : level <= BATTERY_HALF_LEVEL + BATTERY_HYSTERESIS  ? BatteryZone::Half
+                                                                       : BatteryZone::Ok;
+  return up < previous ? up : previous;
+}
+
+const char *batteryZoneName(BatteryZone zone)
+{
+  switch (zone)
+  {
+  case BatteryZone::Ok:
+    return "ok";
+  case BatteryZone::Half:
+    return "half";
+  case BatteryZone::Low:
+    return "low";
+  }
+  return "?";
+}
+
+bool batteryMonitorBegin()
+{
+  if (BATTERY_LED_HALF_PIN >= 0)
+    pinMode(BATTERY_LED_HALF_PIN, OUTPUT);
+  if (BATTERY_LED_LOW_PIN >= 0)
+    pinMode(BATTERY_LED_LOW_PIN, OUTPUT);
+  s_filter.reset();
+  s_status = BatteryStatus{};
+
+#if BATTERY_ADC_CONTINUOUS
+  uint8_t pins[] = {BATTERY_ADC_PIN};
+  s_started = analogContinuous(pins, 1, BATTERY_ADC_FRAME, BATTERY_ADC_SAMPLE_HZ, onAdcFrame) &&
+              analogContinuousStart();
+#else
+  s_last_poll_ms = millis() - BATTERY_POLL_MS;
+  s_started = true;
+#endif
+  return s_started;
+}
+
+void batteryMonitorPoll()
+{
+  if (!s_started)
+    return;
+#if BATTERY_ADC_CONTINUOUS
+  if (!s_frame_ready.exchange(false, std::memory_order_acquire))
+    return;
+  adc_continuous_data_t *result = nullptr;
+  if (analogContinuousRead(&result, 0) && result)
+    addSample((uint32_t)result[0].avg_read_mvolts);
+#else
+  uint32_t now = millis();
+  if (now - s_last_poll_ms < BATTERY_POLL_MS)
+    return;
+  s_last_poll_ms = now;
+  addSample(analogReadMilliVolts(BATTERY_ADC_PIN));
+#endif
+}
+
+BatteryStatus batteryStatus() { return s_status; }
+
+size_t batteryStatusToJson(char *buf, size_t len)
+{
+  int n = snprintf(buf, len,
+                   "{\"battery\":{\"mode\":\"%s\",\"mv\":%lu,\"level\":%u,\"zone\":\"%s\",\"samples\":%lu,"
+                   "\"led_updates\":%lu}}",
+                   BATTERY_ADC_CONTINUOUS ? "continuous" : "oneshot", (unsigned long)s_status.millivolts,
+                   (unsigned)s_status.level, batteryZoneName(s_status.zone), (unsigned long)s_status.samples,
+                   (unsigned long)s_status.led_updates);
+  return n < 0 ? 0 : (size_t)n;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file block_fanout.cpp
+ * @brief 块分发的内置消费者
+ */
+#include "block_fanout.h"
+
+#include "audio_stats.h"
+#include "audio_trace.h"
+
+bool EncoderSink::push(AudioBlock *block)
+{
+  TRACE_BEGIN(EncoderWrite, block->length);
+  encoder_->write(block->data, block->length); // 写入 WAV 编码器
+  TRACE_END(EncoderWrite, block->length);
+  statAdd(g_audio_stats.encoder_bytes, block->length);
+  releaseAudioBlock(block);
+  return true;
+}
+
+bool LevelMeterSink::push(AudioBlock *block)
+{
+  // 均方值按 16 位精度累加（整数运算，ESP32-S3 没有双精度 FPU）
+  uint32_t peak = peak_;
+  uint64_t sum = 0;
+  size_t n;
+  if (bytes_per_sample_ == 2)
+  {
+    const int16_t *s = (const int16_t *)block->data;
+    n = block->length / 2;
+    for (size_t i = 0; i < n; i++)
+    {
+      int32_t v = s[i];
+      uint32_t a = (uint32_t)(v < 0 ? -v : v) << 16;
+      peak = a > peak ? a : peak;
+      sum += (uint64_t)(v * v);
+    }
+  }
+  else
+  {
+    const int32_t *s = (const int32_t *)block->data;
+    n = block->length / 4;
+    for (size_t i = 0; i < n; i++)
+    {
+      int32_t v = s[i];
+      uint32_t a = v < 0 ? (uint32_t)-(int64_t)v : (uint32_t)v;
+      peak = a > peak ? a : peak;
+      int32_t h = v >> 16;
+      sum += (uint64_t)(h * h);
+    }
+  }
+  peak_ = peak;
+  sum_squares_ += sum;
+  samples_ += n;
+  releaseAudioBlock(block);
+  return true;
+}
+
+static float toDbfs(float value, float full_scale)
+{
+  return value > 0 ? 20.0f * log10f(value / full_scale) : -INFINITY;
+}
+
+float LevelMeterSink::peakDbfs() const { return toDbfs((float)peak_, 2147483648.0f); }
+
+float LevelMeterSink::rmsDbfs() const
+{
+  return samples_ ? toDbfs(sqrtf((float)sum_squares_ / (float)samples_), 32768.0f) : -INFINITY;
+}
+
+void LevelMeterSink::reset()
+{
+  peak_ = 0;
+  sum_squares_ = 0;
+  samples_ = 0;
+}
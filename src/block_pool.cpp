@@ -0,0 +1,95 @@
+/**
+ * @file block_pool.cpp
+ * @brief 音频块池初始化与 PSRAM 级分配
+ */
+#include "block_pool.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#endif
+
+StaticBlockPool<AUDIO_DMA_BLOCK_SIZE, AUDIO_DMA_BLOCK_COUNT> g_dma_blocks;
+BlockPool g_psram_blocks;
+
+void BlockPool::init(uint8_t *memory, AudioBlock *blocks, uint16_t count, uint32_t block_size)
+{
+  blocks_ = blocks;
+  block_size_ = block_size;
+  count_ = count;
+  for (uint16_t i = 0; i < count; i++)
+  {
+    blocks[i].data = memory + (size_t)i * block_size;
+    blocks[i].capacity = block_size;
+    blocks[i].length = 0;
+    blocks[i].pool = this;
+    blocks[i].index = i;
+    blocks[i].refs.store(0, std::memory_order_relaxed);
+    blocks[i].next_free.store(i + 1 < count ? (uint16_t)(i + 1) : NONE, std::memory_order_relaxed);
+  }
+  head_.store(0, std::memory_order_release);
+}
+
+bool psramBlockPoolBegin(uint32_t block_size, uint16_t count)
+{
+  if (g_psram_blocks.ready())
+    return true;
+
+#if defined(ESP_PLATFORM)
+  // 块内存放在 PSRAM；描述符含原子变量，必须在内部 RAM
+  uint8_t *memory = (uint8_t *)heap_caps_aligned_alloc(16, (size_t)block_size * count, MALLOC_CAP_SPIRAM);
+  AudioBlock *blocks = (AudioBlock *)heap_caps_calloc(count, sizeof(AudioBlock), MALLOC_CAP_INTERNAL);
+  if (!memory || !blocks)
+  {
+    heap_caps_free(memory);
+    heap_caps_free(blocks);
+    return false;
+  }
+#else
+  uint8_t *memory = (uint8_t *)aligned_alloc(16, ((size_t)block_size * count + 15) & ~(size_t)15);
+  AudioBlock *blocks = (AudioBlock *)calloc(count, sizeof(AudioBlock));
+  if (!memory || !blocks)
+  {
+    free(memory);
+    free(blocks);
+    return false;
+  }
+#endif
+
+  g_psram_blocks.init(memory, blocks, count, block_size);
+  return true;
+}
+
+AudioBlock *acquireAudioBlock(size_t bytes)
+{
+  if (bytes <= g_dma_blocks.blockSize())
+    return g_dma_blocks.acquire();
+  if (g_psram_blocks.ready() && bytes <= g_psram_blocks.blockSize())
+    return g_psram_blocks.acquire();
+  return nullptr;
+}
+
+static size_t poolToJson(char *buf, size_t len, const char *name, const BlockPool &pool)
+{
+  int n = snprintf(buf, len, "\"%s\":{\"size\":%lu,\"count\":%u,\"in_use\":%lu,\"peak\":%lu,\"acquired\":%lu,\"exhausted\":%lu}",
+                   name, (unsigned long)pool.blockSize(), pool.count(), (unsigned long)pool.inUse(),
+                   (unsigned long)pool.peakInUse(), (unsigned long)pool.acquired(), (unsigned long)pool.exhausted());
+  if (n < 0)
+    return 0;
+  return (size_t)n < len ? (size_t)n : len - 1;
+}
+
+size_t blockPoolsToJson(char *buf, size_t len)
+{
+  if (len < 4)
+    return 0;
+  size_t pos = 0;
+  buf[pos++] = '{';
+  pos += poolToJson(buf + pos, len - pos, "dma", g_dma_blocks);
+  if (pos < len - 1)
+    buf[pos++] = ',';
+  pos += poolToJson(buf + pos, len - pos, "psram", g_psram_blocks);
+  if (pos < len - 1)
+    buf[pos++] = '}';
+  buf[pos] = 0;
+  return pos;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file boot_profile.cpp
+ * @brief 启动分析与就绪检查
+ */
+#include "boot_profile.h"
+
+#include <atomic>
+
+#if BOOT_PARALLEL
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace
+{
+  struct PhaseRecord
+  {
+    const char *name;
+    uint32_t start_us;
+    uint32_t end_us; // 0：未结束
+    int8_t core;
+    bool ok;
+  };
+
+  PhaseRecord s_phases[BOOT_PROFILE_MAX_PHASES];
+  std::atomic<int> s_phase_count{0};
+  uint32_t s_ready_us = 0;
+
+  // 最近一次 bootRunParallel()
+  size_t s_group_jobs = 0;
+  uint32_t s_group_sum_us = 0;
+  uint32_t s_group_max_us = 0;
+  uint32_t s_group_elapsed_us = 0;
+
+  int currentCore()
+  {
+#if defined(ESP_PLATFORM)
+    return xPortGetCoreID();
+#else
+    return 1; // Arduino loopTask 所在核心
+#endif
+  }
+
+  void printMs(Print &out, uint32_t us, int width)
+  {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%*lu.%03lu", width - 4, (unsigned long)(us / 1000), (unsigned long)(us % 1000));
+    out.print(buf);
+  }
+}
+
+int bootPhaseBegin(const char *name)
+{
+  int i = s_phase_count.fetch_add(1, std::memory_order_relaxed);
+  if (i >= BOOT_PROFILE_MAX_PHASES)
+    return -1;
+  s_phases[i] = {name, (uint32_t)micros(), 0, (int8_t)currentCore(), true};
+  return i;
+}
+
+void bootPhaseEnd(int phase, bool ok)
+{
+  if (phase < 0)
+    return;
+  s_phases[phase].ok = ok;
+  uint32_t now = (uint32_t)micros();
+  s_phases[phase].end_us = now ? now : 1;
+}
+
+void bootReady() { s_ready_us = (uint32_t)micros(); }
+
+uint32_t bootReadyMicros() { return s_ready_us; }
+
+void bootReport(Print &out)
+{
+  int count = s_phase_count.load(std::memory_order_relaxed);
+  if (count > BOOT_PROFILE_MAX_PHASES)
+    count = BOOT_PROFILE_MAX_PHASES;
+
+  out.println("[boot] phase            start ms    time ms  core");
+  for (int i = 0; i < count; i++)
+  {
+    const PhaseRecord &p = s_phases[i];
+    char name[20];
+    snprintf(name, sizeof(name), "%-16s", p.name);
+    out.print("[boot] ");
+    out.print(name);
+    printMs(out, p.start_us, 10);
+    if (p.end_us)
+      printMs(out, p.end_us - p.start_us, 11);
+    else
+      out.print("          -");
+    out.printf("  %4d%s\n", p.core, p.ok ? "" : "  FAILED");
+  }
+  if (count)
+  {
+    out.print("[boot] ready at ");
+    printMs(out, s_ready_us, 4);
+    out.print(" ms (setup entered at ");
+    printMs(out, s_phases[0].start_us, 4);
+    out.println(" ms)");
+  }
+  if (s_group_jobs)
+  {
+    out.printf("[boot] parallel: %u steps, sum ", (unsigned)s_group_jobs);
+    printMs(out, s_group_sum_us, 4);
+    out.print(" ms, longest ");
+    printMs(out, s_group_max_us, 4);
+    out.print(" ms, elapsed ");
+    printMs(out, s_group_elapsed_us, 4);
+    out.println(" ms");
+  }
+}
+
+//===========================================================
+// 并行初始化
+//===========================================================
+static void runJob(BootJob &job)
+{
+  int phase = bootPhaseBegin(job.name);
+  uint32_t start = (uint32_t)micros();
+  job.ok = job.fn();
+  job.time_us = (uint32_t)micros() - start;
+  bootPhaseEnd(phase, job.ok);
+}
+
+#if BOOT_PARALLEL
+namespace
+{
+  struct BootWorker
+  {
+    BootJob *job;
+    TaskHandle_t parent;
+  };
+
+  void bootWorkerMain(void *arg)
+  {
+    BootWorker *w = (BootWorker *)arg;
+    runJob(*w->job);
+    xTaskNotifyGive(w->parent);
+    vTaskDelete(nullptr);
+  }
+}
+#endif
+
+bool bootRunParallel(BootJob *jobs, size_t count)
+{
+  uint32_t start = (uint32_t)micros();
+  if (count > BOOT_PARALLEL_MAX_JOBS)
+    count = BOOT_PARALLEL_MAX_JOBS;
+
+#if BOOT_PARALLEL
+  BootWorker workers[BOOT_PARALLEL_MAX_JOBS];
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  UBaseType_t priority = uxTaskPriorityGet(nullptr);
+  size_t started = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (jobs[i].where == TaskId::Control)
+      continue;
+    const TaskSpec &spec = taskSpec(jobs[i].where);
+    BaseType_t core = spec.core == TASK_ANY_CORE ? tskNO_AFFINITY : spec.core;
+    workers[i] = {&jobs[i], self};
+    if (xTaskCreatePinnedToCore(bootWorkerMain, jobs[i].name, BOOT_WORKER_STACK, &workers[i], priority, nullptr,
+                                core) == pdPASS)
+      started++;
+    else
+      runJob(jobs[i]); // 无法创建任务时在调用者中运行
+  }
+  for (size_t i = 0; i < count; i++)
+    if (jobs[i].where == TaskId::Control)
+      runJob(jobs[i]);
+  for (size_t i = 0; i < started; i++)
+    ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+#else
+  for (size_t i = 0; i < count; i++)
+    runJob(jobs[i]);
+#endif
+
+  bool ok = true;
+  s_group_jobs = count;
+  s_group_sum_us = 0;
+  s_group_max_us = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    ok = ok && jobs[i].ok;
+    s_group_sum_us += jobs[i].time_us;
+    s_group_max_us = std::max(s_group_max_us, jobs[i].time_us);
+  }
+  s_group_elapsed_us = (uint32_t)micros() - start;
+  return ok;
+}
+
+static bool readReg(TwoWire &wire, uint8_t addr, uint8_t reg, uint8_t &val)
+{
+  wire.beginTransmission(addr);
+  wire.write(reg);
+  if (wire.endTransmission(false) != 0)
+    return false;
+  if (wire.requestFrom(addr, (size_t)1) != 1)
+    return false;
+  val = (uint8_t)wire.read();
+  return true;
+}
+
+bool es8311ChipReady(TwoWire &wire, uint8_t addr)
+{
+  uint8_t id1 = 0, id2 = 0;
+  return readReg(wire, addr, 0xFD, id1) && readReg(wire, addr, 0xFE, id2) && id1 == 0x83 && id2 == 0x11;
+}
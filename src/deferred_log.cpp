@@ -0,0 +1,165 @@
+/**
+ * @file deferred_log.cpp
+ * @brief 延迟日志的格式化与输出任务
+ */
+#include "deferred_log.h"
+
+#include "task_plan.h"
+
+DeferredLogRing g_dlog;
+
+/**
+ * @brief 按格式串逐个转换说明格式化参数
+ *
+ * 参数以 uintptr_t 保存，不能直接交给 vsnprintf；这里按转换字符决定类型，
+ * 忽略长度修饰符（l / ll / h / z ...），整数统一按 64 位输出。
+ */
+static size_t formatEntry(char *buf, size_t len, const DeferredLogEntry &e)
+{
+  size_t pos = 0;
+  uint8_t arg = 0;
+  const char *p = e.fmt;
+
+  auto put = [&](int n)
+  {
+    if (n > 0)
+      pos = pos + (size_t)n < len ? pos + (size_t)n : len - 1;
+  };
+
+  while (*p && pos < len - 1)
+  {
+    if (*p != '%')
+    {
+      buf[pos++] = *p++;
+      continue;
+    }
+    if (p[1] == '%')
+    {
+      buf[pos++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // 复制 标志 / 宽度 / 精度，跳过长度修饰符
+    char spec[16] = "%";
+    size_t n = 1;
+    const char *q = p + 1;
+    while (*q && strchr("-+ #0123456789.", *q) && n < sizeof(spec) - 4)
+      spec[n++] = *q++;
+    while (*q && strchr("hlLqjzt", *q))
+      q++;
+    char conv = *q;
+    if (!conv)
+      break;
+    p = q + 1;
+
+    if (arg >= e.nargs)
+    {
+      put(snprintf(buf + pos, len - pos, "<?>"));
+      continue;
+    }
+    uintptr_t v = e.args[arg];
+    bool is_float = e.float_mask & (1u << arg);
+    arg++;
+
+    switch (conv)
+    {
+    case 'd':
+    case 'i':
+      spec[n++] = 'l';
+      spec[n++] = 'l';
+      spec[n++] = conv;
+      put(snprintf(buf + pos, len - pos, spec, (long long)(intptr_t)v));
+      break;
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      spec[n++] = 'l';
+      spec[n++] = 'l';
+      spec[n++] = conv;
+      put(snprintf(buf + pos, len - pos, spec, (unsigned long long)v));
+      break;
+    case 'c':
+      spec[n++] = conv;
+      put(snprintf(buf + pos, len - pos, spec, (int)v));
+      break;
+    case 's':
+      spec[n++] = conv;
+      put(snprintf(buf + pos, len - pos, spec, v ? (const char *)v : "(null)"));
+      break;
+    case 'p':
+      spec[n++] = conv;
+      put(snprintf(buf + pos, len - pos, spec, (void *)v));
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    {
+      double d;
+      if (is_float)
+      {
+        float f;
+        uint32_t bits = (uint32_t)v;
+        memcpy(&f, &bits, sizeof(f));
+        d = f;
+      }
+      else
+      {
+        d = (double)(intptr_t)v;
+      }
+      spec[n++] = conv;
+      put(snprintf(buf + pos, len - pos, spec, d));
+      break;
+    }
+    default:
+      put(snprintf(buf + pos, len - pos, "<%%%c?>", conv));
+      break;
+    }
+  }
+  buf[pos] = 0;
+  return pos;
+}
+
+size_t deferredLogFlush(Print &out)
+{
+  static uint32_t reported_drops = 0;
+
+  char line[160];
+  size_t count = 0;
+  for (;;)
+  {
+    // 在槽位中就地格式化，格式化后才释放
+    RingSpan<const DeferredLogEntry> r = g_dlog.entries.readSpan(1);
+    if (!r.count)
+      break;
+    const DeferredLogEntry &e = r.data[0];
+    uint64_t us = e.us;
+    formatEntry(line, sizeof(line), e);
+    g_dlog.entries.commitRead(1);
+
+    out.printf("[%lu.%03lu] %s\n", (unsigned long)(us / 1000), (unsigned long)(us % 1000), line);
+    count++;
+  }
+
+  uint32_t drops = g_dlog.dropped.load(std::memory_order_relaxed);
+  if (drops != reported_drops)
+  {
+    out.printf("[dlog] dropped %lu\n", (unsigned long)(drops - reported_drops));
+    reported_drops = drops;
+  }
+  return count;
+}
+
+static Print *s_log_out = nullptr;
+
+static void deferredLogStep() { deferredLogFlush(*s_log_out); }
+
+bool deferredLogStart(Print &out)
+{
+  s_log_out = &out;
+  return taskStart(TaskId::Logging, deferredLogStep);
+}
@@ -0,0 +1,290 @@
+/**
+ * @file es8311.c
+ * @brief ES8311 精简驱动实现
+ *
+ * 初始化顺序与 esp-adf / arduino-audio-driver 的 ES8311 驱动相同（时钟关闭 → 分频与格式 →
+ * 状态机上电 → 时钟打开 → 模拟部分上电 → 音量），只是把相邻寄存器合并为一次突发写。
+ */
+#include "es8311.h"
+
+#include "es8311_reg.h"
+
+#if defined(ES8311_IDF_I2C)
+#include "driver/i2c.h"
+#include "freertos/FreeRTOS.h"
+
+#define ES8311_I2C_TIMEOUT_MS 20
+#endif
+
+//===========================================================
+// I2C
+//===========================================================
+static es8311_err_t write_run(es8311_t *dev, uint8_t reg, const uint8_t *values, size_t count)
+{
+  uint8_t buf[1 + 16];
+  if (count == 0 || count > sizeof(buf) - 1)
+    return ES8311_ERR_ARG;
+  buf[0] = reg;
+  for (size_t i = 0; i < count; i++)
+    buf[1 + i] = values[i];
+  dev->writes++;
+  return dev->bus.write(dev->bus.ctx, dev->bus.addr, buf, 1 + count) == 0 ? ES8311_OK : ES8311_ERR_I2C;
+}
+
+static es8311_err_t write_reg(es8311_t *dev, uint8_t reg, uint8_t value) { return write_run(dev, reg, &value, 1); }
+
+//===========================================================
+// 时钟
+//===========================================================
+typedef struct
+{
+  uint8_t reg01; // 时钟使能（打开时）
+  uint8_t reg02_08[7];
+} clock_regs_t;
+
+/**
+ * @brief 计算分频：内部时钟 = MCLK × PRE_MULTI / PRE_DIV = 256 × 采样率（ADC / DAC OSR 0x10）
+ */
+static es8311_err_t compute_clock(const es8311_clock_t *clock, clock_regs_t *out)
+{
+  if (!clock->sample_rate ||
+      (clock->bits != 16 && clock->bits != 18 && clock->bits != 20 && clock->bits != 24 && clock->bits != 32))
+    return ES8311_ERR_ARG;
+
+  uint32_t frame_bits = (uint32_t)clock->bits * 2;
+  uint32_t mclk = clock->mclk_from_sclk ? clock->sample_rate * frame_bits : clock->mclk_hz;
+  if (!mclk || mclk % clock->sample_rate)
+    return ES8311_ERR_CLOCK;
+  uint32_t ratio = mclk / clock->sample_rate; // 每帧 MCLK 周期数
+
+  // PRE_MULTI ×1 / ×2 / ×4 / ×8 与 PRE_DIV 1..8，使 ratio × multi = 256 × div
+  int multi_code = -1;
+  uint32_t div = 0;
+  for (int code = 0; code < 4 && multi_code < 0; code++)
+  {
+    uint32_t scaled = ratio << code;
+    if (scaled % 256 == 0 && scaled / 256 >= 1 && scaled / 256 <= 8)
+    {
+      multi_code = code;
+      div = scaled / 256;
+    }
+  }
+  if (multi_code < 0)
+    return ES8311_ERR_CLOCK;
+
+  uint8_t bclk_div = (uint8_t)(ratio / frame_bits ? ratio / frame_bits : 1);
+  uint32_t lrck_div = ratio - 1;
+
+  out->reg01 = (uint8_t)(0x3F | (clock->mclk_from_sclk ? 0x80 : 0x00));
+  out->reg02_08[0] = (uint8_t)(((div - 1) << 5) | ((uint32_t)multi_code << 3)); // 0x02
+  out->reg02_08[1] = 0x10;                                                       // 0x03 单速模式，ADC OSR
+  out->reg02_08[2] = 0x10;                                                       // 0x04 DAC OSR
+  out->reg02_08[3] = 0x00;                                                       // 0x05 ADC / DAC 不分频
+  out->reg02_08[4] = (uint8_t)(bclk_div < 19 ? bclk_div - 1 : bclk_div);         // 0x06
+  out->reg02_08[5] = (uint8_t)((lrck_div >> 8) & 0x0F);                          // 0x07
+  out->reg02_08[6] = (uint8_t)(lrck_div & 0xFF);                                 // 0x08
+  return ES8311_OK;
+}
+
+static uint8_t word_length(uint8_t bits)
+{
+  switch (bits)
+  {
+  case 16:
+    return ES8311_SDP_WL_16;
+  case 18:
+    return ES8311_SDP_WL_18;
+  case 20:
+    return ES8311_SDP_WL_20;
+  case 24:
+    return ES8311_SDP_WL_24;
+  default:
+    return ES8311_SDP_WL_32;
+  }
+}
+
+//===========================================================
+// 电源（按 mode 打开 ADC / DAC）
+//===========================================================
+static es8311_err_t power_up(es8311_t *dev)
+{
+  bool adc = dev->mode & ES8311_MODE_ADC;
+  bool dac = dev->mode & ES8311_MODE_DAC;
+
+  // 0x0D 模拟部分上电，0x0E PGA / ADC 调制器
+  const uint8_t r0d[] = {0x01, adc ? 0x02 : 0xFF};
+  // 0x12 DAC 电源，0x13，0x14 麦克风输入与 PGA 增益，0x15 ADC 斜坡
+  const uint8_t r12[] = {dac ? 0x00 : 0x02, 0x10, adc ? 0x1A : 0x00, 0x40};
+  es8311_err_t err;
+  if ((err = write_run(dev, ES8311_SYSTEM_REG0D, r0d, sizeof(r0d))) != ES8311_OK)
+    return err;
+  if ((err = write_run(dev, ES8311_SYSTEM_REG12, r12, sizeof(r12))) != ES8311_OK)
+    return err;
+  dev->powered = true;
+  return ES8311_OK;
+}
+
+//===========================================================
+// 接口
+//===========================================================
+es8311_err_t es8311_read_id(es8311_t *dev, uint16_t *id)
+{
+  uint8_t buf[2];
+  if (dev->bus.read(dev->bus.ctx, dev->bus.addr, ES8311_CHD1_REGFD, buf, 2) != 0)
+    return ES8311_ERR_I2C;
+  *id = (uint16_t)((buf[0] << 8) | buf[1]);
+  return ES8311_OK;
+}
+
+es8311_err_t es8311_init(es8311_t *dev, const es8311_bus_t *bus, const es8311_clock_t *clock, es8311_mode_t mode)
+{
+  if (!dev || !bus || !bus->write || !bus->read || !clock || !(mode & ES8311_MODE_BOTH))
+    return ES8311_ERR_ARG;
+  dev->bus = *bus;
+  dev->mode = mode;
+  dev->dac_volume = ES8311_VOLUME_0DB_REG;
+  dev->adc_volume = ES8311_VOLUME_0DB_REG;
+  dev->muted = false;
+  dev->powered = false;
+  dev->writes = 0;
+
+  uint16_t id = 0;
+  es8311_err_t err = es8311_read_id(dev, &id);
+  if (err != ES8311_OK)
+    return err;
+  if (id != 0x8311)
+    return ES8311_ERR_ID;
+
+  clock_regs_t clk;
+  if ((err = compute_clock(clock, &clk)) != ES8311_OK)
+    return err;
+  dev->clock_on = clk.reg01;
+
+  // 0x01 时钟关闭（分频写入期间），0x02..0x08 分频
+  uint8_t r01[8] = {0x30};
+  for (int i = 0; i < 7; i++)
+    r01[1 + i] = clk.reg02_08[i];
+  // 0x09 / 0x0A I2S 格式与字长，0x0B / 0x0C 系统
+  uint8_t wl = word_length(clock->bits);
+  const uint8_t r09[] = {(uint8_t)(ES8311_SDP_I2S | wl), (uint8_t)(ES8311_SDP_I2S | wl), 0x00, 0x00};
+  const uint8_t r10[] = {0x1F, 0x7F};            // 0x10 / 0x11 参考电压与偏置
+  const uint8_t r16[] = {0x24, dev->adc_volume}; // 0x16 ADC 增益，0x17 ADC 音量
+  const uint8_t r1b[] = {0x0A, 0x6A};            // 0x1B / 0x1C ADC 高通
+  const uint8_t r31[] = {0x00, dev->dac_volume}; // 0x31 不静音，0x32 DAC 音量
+
+  if ((err = write_reg(dev, ES8311_GPIO_REG44, 0x08)) != ES8311_OK || // I2C 抗干扰
+      (err = write_run(dev, ES8311_CLK_MANAGER_REG01, r01, sizeof(r01))) != ES8311_OK ||
+      (err = write_run(dev, ES8311_SDPIN_REG09, r09, sizeof(r09))) != ES8311_OK ||
+      (err = write_run(dev, ES8311_SYSTEM_REG10, r10, sizeof(r10))) != ES8311_OK ||
+      (err = write_reg(dev, ES8311_RESET_REG00, 0x80)) != ES8311_OK ||     // 从模式，状态机上电
+      (err = write_reg(dev, ES8311_CLK_MANAGER_REG01, clk.reg01)) != ES8311_OK || // 时钟打开
+      (err = write_run(dev, ES8311_ADC_REG16, r16, sizeof(r16))) != ES8311_OK ||
+      (err = write_run(dev, ES8311_ADC_REG1B, r1b, sizeof(r1b))) != ES8311_OK ||
+      (err = power_up(dev)) != ES8311_OK ||
+      (err = write_reg(dev, ES8311_DAC_REG37, 0x08)) != ES8311_OK || // DAC EQ 旁路
+      (err = write_reg(dev, ES8311_GP_REG45, 0x00)) != ES8311_OK ||
+      (err = write_run(dev, ES8311_DAC_REG31, r31, sizeof(r31))) != ES8311_OK)
+    return err;
+  return ES8311_OK;
+}
+
+es8311_err_t es8311_set_clock(es8311_t *dev, const es8311_clock_t *clock)
+{
+  clock_regs_t clk;
+  es8311_err_t err = compute_clock(clock, &clk);
+  if (err != ES8311_OK)
+    return err;
+  uint8_t r01[8] = {0x30};
+  for (int i = 0; i < 7; i++)
+    r01[1 + i] = clk.reg02_08[i];
+  dev->clock_on = clk.reg01;
+  uint8_t wl = word_length(clock->bits);
+  const uint8_t r09[] = {(uint8_t)(ES8311_SDP_I2S | wl), (uint8_t)(ES8311_SDP_I2S | wl)};
+  if ((err = write_run(dev, ES8311_CLK_MANAGER_REG01, r01, sizeof(r01))) != ES8311_OK ||
+      (err = write_run(dev, ES8311_SDPIN_REG09, r09, sizeof(r09))) != ES8311_OK)
+    return err;
+  return dev->powered ? write_reg(dev, ES8311_CLK_MANAGER_REG01, clk.reg01) : ES8311_OK;
+}
+
+es8311_err_t es8311_set_volume(es8311_t *dev, int volume)
+{
+  if (volume < 0)
+    volume = 0;
+  if (volume > 100)
+    volume = 100;
+  return es8311_set_dac_volume_reg(dev, (uint8_t)(volume * 255 / 100));
+}
+
+es8311_err_t es8311_set_dac_volume_reg(es8311_t *dev, uint8_t reg)
+{
+  es8311_err_t err = write_reg(dev, ES8311_DAC_REG32, reg);
+  if (err == ES8311_OK)
+    dev->dac_volume = reg;
+  return err;
+}
+
+es8311_err_t es8311_set_adc_volume_reg(es8311_t *dev, uint8_t reg)
+{
+  es8311_err_t err = write_reg(dev, ES8311_ADC_REG17, reg);
+  if (err == ES8311_OK)
+    dev->adc_volume = reg;
+  return err;
+}
+
+es8311_err_t es8311_set_mute(es8311_t *dev, bool mute)
+{
+  es8311_err_t err = write_reg(dev, ES8311_DAC_REG31, mute ? ES8311_DAC_MUTE_BITS : 0x00);
+  if (err == ES8311_OK)
+    dev->muted = mute;
+  return err;
+}
+
+es8311_err_t es8311_set_power(es8311_t *dev, bool on)
+{
+  if (on == dev->powered)
+    return ES8311_OK;
+  es8311_err_t err;
+  if (on)
+  {
+    if ((err = write_reg(dev, ES8311_CLK_MANAGER_REG01, dev->clock_on)) != ES8311_OK)
+      return err;
+    return power_up(dev);
+  }
+
+  // 待机：DAC / ADC / 模拟部分下电，最后关闭时钟
+  const uint8_t r0d[] = {0xFA, 0xFF};
+  const uint8_t r12[] = {0x02, 0x10, 0x00};
+  if ((err = write_run(dev, ES8311_SYSTEM_REG12, r12, sizeof(r12))) != ES8311_OK ||
+      (err = write_run(dev, ES8311_SYSTEM_REG0D, r0d, sizeof(r0d))) != ES8311_OK ||
+      (err = write_reg(dev, ES8311_CLK_MANAGER_REG01, 0x00)) != ES8311_OK)
+    return err;
+  dev->powered = false;
+  return ES8311_OK;
+}
+
+//===========================================================
+// ESP-IDF I2C 总线
+//===========================================================
+#if defined(ES8311_IDF_I2C)
+static int idf_write(void *ctx, uint8_t addr, const uint8_t *data, size_t len)
+{
+  return i2c_master_write_to_device((i2c_port_t)(intptr_t)ctx, addr, data, len,
+                                    pdMS_TO_TICKS(ES8311_I2C_TIMEOUT_MS)) == ESP_OK
+             ? 0
+             : -1;
+}
+
+static int idf_read(void *ctx, uint8_t addr, uint8_t reg, uint8_t *data, size_t len)
+{
+  return i2c_master_write_read_device((i2c_port_t)(intptr_t)ctx, addr, &reg, 1, data, len,
+                                      pdMS_TO_TICKS(ES8311_I2C_TIMEOUT_MS)) == ESP_OK
+             ? 0
+             : -1;
+}
+
+es8311_bus_t es8311_bus_idf(int port, uint8_t addr)
+{
+  es8311_bus_t bus = {idf_write, idf_read, (void *)(intptr_t)port, addr};
+  return bus;
+}
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file es8311_controls.cpp
+ * @brief ES8311 硬件处理模块接口实现
+ */
+#include "es8311_controls.h"
+
+#define ES8311_REG_ALC 0x18
+#define ES8311_REG_ALC_LEVEL 0x19
+#define ES8311_REG_ADC_HPFS1 0x1B
+#define ES8311_REG_ADC_HPF 0x1C
+#define ES8311_REG_ADC_VOLUME 0x17
+#define ES8311_REG_DAC_VOLUME 0x32
+
+#define ES8311_ADC_HPF_EN 0x20
+#define ES8311_ALC_EN 0x80
+
+uint8_t es8311VolumeReg(float db)
+{
+  if (db <= ES8311_VOLUME_MIN_DB)
+    return 0x00;
+  if (db >= ES8311_VOLUME_MAX_DB)
+    return 0xFF;
+  return (uint8_t)lrintf((db - ES8311_VOLUME_MIN_DB) * 2.0f);
+}
+
+float es8311VolumeDb(uint8_t reg) { return ES8311_VOLUME_MIN_DB + (float)reg * 0.5f; }
+
+bool es8311SetDacVolumeDb(float db)
+{
+  if (!g_es8311.ready() || !g_es8311.sync())
+    return false;
+  return g_es8311.write(ES8311_REG_DAC_VOLUME, es8311VolumeReg(db));
+}
+
+bool es8311SetAdcVolumeDb(float db)
+{
+  if (!g_es8311.ready() || !g_es8311.sync())
+    return false;
+  return g_es8311.write(ES8311_REG_ADC_VOLUME, es8311VolumeReg(db));
+}
+
+bool es8311SetAdcHpf(bool enable, uint8_t s1, uint8_t s2)
+{
+  if (!g_es8311.ready() || !g_es8311.sync())
+    return false;
+  g_es8311.update(ES8311_REG_ADC_HPFS1, 0x1F, s1);
+  g_es8311.update(ES8311_REG_ADC_HPF, ES8311_ADC_HPF_EN | 0x1F, (uint8_t)((enable ? ES8311_ADC_HPF_EN : 0) | (s2 & 0x1F)));
+  return g_es8311.flush();
+}
+
+bool es8311AdcHpfEnabled()
+{
+  return g_es8311.ready() && g_es8311.sync() && (g_es8311.get(ES8311_REG_ADC_HPF) & ES8311_ADC_HPF_EN);
+}
+
+bool es8311SetAlc(const Es8311Alc &alc)
+{
+  if (!g_es8311.ready() || !g_es8311.sync())
+    return false;
+  g_es8311.update(ES8311_REG_ALC, ES8311_ALC_EN | 0x0F, (uint8_t)((alc.enable ? ES8311_ALC_EN : 0) | (alc.window & 0x0F)));
+  g_es8311.set(ES8311_REG_ALC_LEVEL, (uint8_t)(((alc.max_level & 0x0F) << 4) | (alc.min_level & 0x0F)));
+  return g_es8311.flush();
+}
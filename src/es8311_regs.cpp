@@ -0,0 +1,191 @@
+/**
+ * @file es8311_regs.cpp
+ * @brief ES8311 寄存器影子缓存实现
+ */
+#include "es8311_regs.h"
+
+Es8311Registers g_es8311;
+
+bool Es8311Registers::begin(TwoWire &wire, uint8_t addr, uint32_t clock_hz)
+{
+  wire_ = &wire;
+  addr_ = addr;
+  if (clock_hz)
+    wire.setClock(clock_hz);
+  clock_hz_ = clock_hz ? clock_hz : wire.getClock();
+  stale_.store(false, std::memory_order_relaxed);
+  if (!refresh())
+  {
+    wire_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool Es8311Registers::refresh()
+{
+  if (!wire_)
+    return false;
+  for (uint32_t r = 0; r <= ES8311_REG_LAST; r += ES8311_BURST_MAX)
+  {
+    size_t n = std::min<size_t>(ES8311_BURST_MAX, ES8311_REG_LAST + 1 - r);
+    if (!burstRead((uint8_t)r, n))
+      return false;
+  }
+  if (!burstRead(ES8311_REG_ID_FIRST, 0x100 - ES8311_REG_ID_FIRST))
+    return false;
+  memset(dirty_, 0, sizeof(dirty_));
+  return true;
+}
+
+bool Es8311Registers::sync()
+{
+  if (!stale_.exchange(false, std::memory_order_acquire))
+    return true;
+  if (refresh())
+    return true;
+  stale_.store(true, std::memory_order_relaxed);
+  return false;
+}
+
+void Es8311Registers::set(uint8_t reg, uint8_t val)
+{
+  if (regs_[reg] == val)
+    return;
+  regs_[reg] = val;
+  dirty_[reg >> 5] |= 1u << (reg & 31);
+}
+
+bool Es8311Registers::flush()
+{
+  if (!wire_)
+    return false;
+  bool ok = true;
+  uint32_t reg = 0;
+  while (reg < 256)
+  {
+    // 跳过一个字内的全部干净寄存器
+    if (!dirty_[reg >> 5])
+    {
+      reg = (reg | 31) + 1;
+      continue;
+    }
+    if (!isDirty((uint8_t)reg))
+    {
+      reg++;
+      continue;
+    }
+    // 连续脏寄存器段
+    uint32_t first = reg;
+    size_t n = 0;
+    while (reg < 256 && isDirty((uint8_t)reg) && n < (ES8311_BURST ? ES8311_BURST_MAX : 1))
+    {
+      reg++;
+      n++;
+    }
+    if (burstWrite((uint8_t)first, n))
+    {
+      for (uint32_t r = first; r < first + n; r++)
+        clearDirty((uint8_t)r);
+    }
+    else
+    {
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+bool Es8311Registers::writeBatch(const uint8_t (*pairs)[2], size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+    set(pairs[i][0], pairs[i][1]);
+  return flush();
+}
+
+size_t Es8311Registers::dirtyCount() const
+{
+  size_t n = 0;
+  for (uint32_t w : dirty_)
+    n += (size_t)__builtin_popcount(w);
+  return n;
+}
+
+bool Es8311Registers::burstRead(uint8_t first, size_t count)
+{
+#if ES8311_BURST
+  const size_t step = count;
+#else
+  const size_t step = 1;
+#endif
+  for (size_t done = 0; done < count; done += step)
+  {
+    wire_->beginTransmission(addr_);
+    wire_->write((uint8_t)(first + done));
+    transactions_++;
+    bytes_ += 2;
+    if (wire_->endTransmission(false) != 0)
+      return false;
+    transactions_++;
+    bytes_ += 1 + (uint32_t)step;
+    if (wire_->requestFrom(addr_, step) != step)
+      return false;
+    for (size_t i = 0; i < step; i++)
+      regs_[(uint8_t)(first + done + i)] = (uint8_t)wire_->read();
+  }
+  return true;
+}
+
+bool Es8311Registers::burstWrite(uint8_t first, size_t count)
+{
+  wire_->beginTransmission(addr_);
+  wire_->write(first);
+  wire_->write(&regs_[first], count);
+  transactions_++;
+  bytes_ += 2 + (uint32_t)count;
+  if (wire_->endTransmission() != 0)
+    return false;
+  registers_written_ += (uint32_t)count;
+  return true;
+}
+
+size_t Es8311Registers::toJson(char *buf, size_t len) const
+{
+  int n = snprintf(buf, len, "{\"clock\":%lu,\"transactions\":%lu,\"bytes\":%lu,\"writes\":%lu,\"dirty\":%u}",
+                   (unsigned long)clock_hz_, (unsigned long)transactions_, (unsigned long)bytes_,
+                   (unsigned long)registers_written_, (unsigned)dirtyCount());
+  if (n < 0)
+    return 0;
+  return (size_t)n < len ? (size_t)n : len - 1;
+}
+
+//===========================================================
+// 精简驱动的 TwoWire 总线
+//===========================================================
+namespace
+{
+  int wireWrite(void *ctx, uint8_t addr, const uint8_t *data, size_t len)
+  {
+    TwoWire *wire = (TwoWire *)ctx;
+    wire->beginTransmission(addr);
+    wire->write(data, len);
+    return wire->endTransmission() == 0 ? 0 : -1;
+  }
+
+  int wireRead(void *ctx, uint8_t addr, uint8_t reg, uint8_t *data, size_t len)
+  {
+    TwoWire *wire = (TwoWire *)ctx;
+    wire->beginTransmission(addr);
+    wire->write(reg);
+    if (wire->endTransmission(false) != 0 || wire->requestFrom(addr, len) != len)
+      return -1;
+    for (size_t i = 0; i < len; i++)
+      data[i] = (uint8_t)wire->read();
+    return 0;
+  }
+}
+
+es8311_bus_t es8311WireBus(TwoWire &wire, uint8_t addr)
+{
+  return {wireWrite, wireRead, &wire, addr};
+}
@@ -0,0 +1,396 @@
+/**
+ * @file i2s_direct.cpp
+ * @brief i2s_std 通道后端：设备上直接调用 ESP-IDF 驱动，主机上为虚拟时钟的 DMA 环模型
+ */
+#include "i2s_direct.h"
+#include "audio_trace.h"
+
+#if !I2S_DIRECT_IDF
+#include "host_env.h"
+#endif
+
+//===========================================================
+// 公共部分
+//===========================================================
+void I2SDirectStream::noteCall(uint32_t &calls, uint32_t &max_us, uint32_t t0)
+{
+  uint32_t us = micros() - t0;
+  calls++;
+  if (us > max_us)
+    max_us = us;
+}
+
+void I2SDirectStream::settle(const std::atomic<uint32_t> &raw, uint32_t &seen, uint32_t &stat, uint32_t gap_us)
+{
+  uint32_t now = raw.load(std::memory_order_relaxed);
+  if (gap_us <= I2S_DIRECT_IDLE_MS * 1000UL)
+    stat += now - seen;
+  seen = now;
+}
+
+int I2SDirectStream::available()
+{
+  return active_ && cfg_.rx ? (int)descriptorBytes() : 0;
+}
+
+int I2SDirectStream::availableForWrite()
+{
+  return active_ && cfg_.tx ? (int)descriptorBytes() : 0;
+}
+
+void I2SDirectStream::markIdle()
+{
+  // 第一次读取 / 写入之前的溢出 / 饥饿不计
+  last_read_us_ = last_write_us_ = micros() - I2S_DIRECT_IDLE_MS * 1000UL - 1;
+  rx_ovf_seen_ = rx_ovf_raw_.load(std::memory_order_relaxed);
+  tx_ovf_seen_ = tx_ovf_raw_.load(std::memory_order_relaxed);
+}
+
+void I2SDirectStream::resetStats()
+{
+  stats_.rx_desc.store(0, std::memory_order_relaxed);
+  stats_.tx_desc.store(0, std::memory_order_relaxed);
+  stats_.rx_overflow = stats_.tx_starved = 0;
+  stats_.reads = stats_.writes = 0;
+  stats_.read_max_us = stats_.write_max_us = 0;
+}
+
+size_t I2SDirectStream::toJson(char *buf, size_t len) const
+{
+  int n = snprintf(buf, len,
+                   "{\"desc\":%lu,\"frames\":%lu,\"latency_us\":%lu,\"rx_desc\":%lu,\"rx_overflow\":%lu,"
+                   "\"tx_desc\":%lu,\"tx_starved\":%lu,\"reads\":%lu,\"read_max_us\":%lu,\"writes\":%lu,"
+                   "\"write_max_us\":%lu}",
+                   (unsigned long)cfg_.dma_desc_num, (unsigned long)cfg_.dma_frame_num, (unsigned long)latencyUs(),
+                   (unsigned long)stats_.rx_desc.load(), (unsigned long)stats_.rx_overflow,
+                   (unsigned long)stats_.tx_desc.load(), (unsigned long)stats_.tx_starved,
+                   (unsigned long)stats_.reads, (unsigned long)stats_.read_max_us, (unsigned long)stats_.writes,
+                   (unsigned long)stats_.write_max_us);
+  return n < 0 ? 0 : ((size_t)n >= len ? len - 1 : (size_t)n);
+}
+
+#if I2S_DIRECT_IDF
+//===========================================================
+// ESP-IDF i2s_std
+//===========================================================
+namespace
+{
+  i2s_std_config_t stdConfig(const I2SDirectConfig &cfg)
+  {
+    i2s_slot_mode_t slots = cfg.info.channels == 1 ? I2S_SLOT_MODE_MONO : I2S_SLOT_MODE_STEREO;
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(cfg.info.sample_rate), // MCLK = 256 fs（ES8311 的默认分频）
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG((i2s_data_bit_width_t)cfg.info.bits_per_sample, slots),
+        .gpio_cfg =
+            {
+                .mclk = (gpio_num_t)cfg.mclk,
+                .bclk = (gpio_num_t)cfg.bclk,
+                .ws = (gpio_num_t)cfg.ws,
+                .dout = (gpio_num_t)cfg.dout,
+                .din = (gpio_num_t)cfg.din,
+                .invert_flags = {.mclk_inv = false, .bclk_inv = false, .ws_inv = false},
+            },
+    };
+    return std_cfg;
+  }
+}
+
+bool IRAM_ATTR I2SDirectStream::onRecv(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+  I2SDirectStream *self = (I2SDirectStream *)ctx;
+  self->stats_.rx_desc.fetch_add(1, std::memory_order_relaxed);
+  TRACE_INSTANT(DmaRx, event->size);
+  return false; // 没有唤醒更高优先级的任务（读取方在 i2s_channel_read 中等待驱动的队列）
+}
+
+bool IRAM_ATTR I2SDirectStream::onRecvOverflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+  I2SDirectStream *self = (I2SDirectStream *)ctx;
+  self->rx_ovf_raw_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool IRAM_ATTR I2SDirectStream::onSent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+  I2SDirectStream *self = (I2SDirectStream *)ctx;
+  self->stats_.tx_desc.fetch_add(1, std::memory_order_relaxed);
+  TRACE_INSTANT(DmaTx, event->size);
+  return false;
+}
+
+bool IRAM_ATTR I2SDirectStream::onSendOverflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx)
+{
+  I2SDirectStream *self = (I2SDirectStream *)ctx;
+  self->tx_ovf_raw_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool I2SDirectStream::begin(const I2SDirectConfig &cfg)
+{
+  end();
+  cfg_ = cfg;
+
+  i2s_chan_config_t chan = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_AUTO, I2S_ROLE_MASTER);
+  chan.dma_desc_num = cfg_.dma_desc_num;
+  chan.dma_frame_num = cfg_.dma_frame_num;
+  chan.auto_clear = true; // TX 欠载时发送静音，而不是重复环中的旧数据
+  if (i2s_new_channel(&chan, cfg_.tx ? &tx_ : nullptr, cfg_.rx ? &rx_ : nullptr) != ESP_OK)
+    return false;
+
+  i2s_std_config_t std_cfg = stdConfig(cfg_);
+  bool ok = true;
+  if (tx_)
+  {
+    i2s_event_callbacks_t cbs = {};
+    cbs.on_sent = onSent;
+    cbs.on_send_q_ovf = onSendOverflow;
+    ok = ok && i2s_channel_init_std_mode(tx_, &std_cfg) == ESP_OK &&
+         i2s_channel_register_event_callback(tx_, &cbs, this) == ESP_OK;
+  }
+  if (rx_)
+  {
+    i2s_event_callbacks_t cbs = {};
+    cbs.on_recv = onRecv;
+    cbs.on_recv_q_ovf = onRecvOverflow;
+    ok = ok && i2s_channel_init_std_mode(rx_, &std_cfg) == ESP_OK &&
+         i2s_channel_register_event_callback(rx_, &cbs, this) == ESP_OK;
+  }
+
+  markIdle();
+
+  ok = ok && (!tx_ || i2s_channel_enable(tx_) == ESP_OK) && (!rx_ || i2s_channel_enable(rx_) == ESP_OK);
+  active_ = true;
+  if (!ok)
+    end(); // 删除通道前先停止（未启动的通道停止失败，不影响删除）
+  return ok;
+}
+
+void I2SDirectStream::end()
+{
+  i2s_chan_handle_t chans[] = {tx_, rx_};
+  for (i2s_chan_handle_t ch : chans)
+  {
+    if (!ch)
+      continue;
+    if (active_)
+      i2s_channel_disable(ch);
+    i2s_del_channel(ch);
+  }
+  tx_ = rx_ = nullptr;
+  active_ = false;
+}
+
+void I2SDirectStream::setAudioInfo(AudioInfo info)
+{
+  if (info == cfg_.info)
+    return;
+  cfg_.info = info;
+  if (!active_)
+    return;
+
+  // 通道停止期间修改时钟与声道格式，编解码器同步修改字长
+  i2s_std_config_t std_cfg = stdConfig(cfg_);
+  i2s_chan_handle_t chans[] = {tx_, rx_};
+  for (i2s_chan_handle_t ch : chans)
+    if (ch)
+      i2s_channel_disable(ch);
+  if (cfg_.on_format)
+    cfg_.on_format(info);
+  for (i2s_chan_handle_t ch : chans)
+  {
+    if (!ch)
+      continue;
+    i2s_channel_reconfig_std_clock(ch, &std_cfg.clk_cfg);
+    i2s_channel_reconfig_std_slot(ch, &std_cfg.slot_cfg);
+    i2s_channel_enable(ch);
+  }
+}
+
+size_t I2SDirectStream::readBytes(uint8_t *data, size_t len)
+{
+  if (!rx_)
+    return 0;
+  uint32_t t0 = micros();
+  settle(rx_ovf_raw_, rx_ovf_seen_, stats_.rx_overflow, t0 - last_read_us_);
+  size_t got = 0;
+  i2s_channel_read(rx_, data, len, &got, portMAX_DELAY);
+  last_read_us_ = micros();
+  noteCall(stats_.reads, stats_.read_max_us, t0);
+  return got;
+}
+
+size_t I2SDirectStream::write(const uint8_t *data, size_t len)
+{
+  if (!tx_)
+    return 0;
+  uint32_t t0 = micros();
+  settle(tx_ovf_raw_, tx_ovf_seen_, stats_.tx_starved, t0 - last_write_us_);
+  size_t done = 0;
+  i2s_channel_write(tx_, data, len, &done, portMAX_DELAY);
+  last_write_us_ = micros();
+  noteCall(stats_.writes, stats_.write_max_us, t0);
+  return done;
+}
+
+#else
+//===========================================================
+// 主机：DMA 环模型
+//
+// RX 描述符按采样率在虚拟时间上依次完成；DMA 写入其中一个，环中最多 dma_desc_num - 1 个
+// 完成未读的描述符，更多时最旧的被覆盖（on_recv_q_ovf）：能容忍的读取停顿约为一个缓冲时长。TX 写入环中的空闲描述符，环满时等待；
+// DMA 发送位置越过写入位置时为饥饿（on_send_q_ovf），之后的写入从 DMA 当前位置开始。
+// 溢出 / 饥饿按描述符计数，与设备回调相同。
+// 不按采样率计时（--no-pace / 基准测试）时没有等待，也不计数。
+//===========================================================
+bool I2SDirectStream::begin(const I2SDirectConfig &cfg)
+{
+  end();
+  cfg_ = cfg;
+  I2SCodecConfig c = data_.defaultConfig(cfg_.rx && cfg_.tx ? RXTX_MODE : (cfg_.rx ? RX_MODE : TX_MODE));
+  c.copyFrom(cfg_.info);
+  c.buffer_count = (int)cfg_.dma_desc_num;
+  c.buffer_size = (int)descriptorBytes();
+  if (!data_.begin(c))
+    return false;
+
+  start_us_ = host::nowMicros();
+  rx_read_ = tx_written_ = 0;
+  rx_desc_seen_ = tx_desc_seen_ = 0;
+  markIdle();
+  active_ = true;
+  return true;
+}
+
+void I2SDirectStream::end()
+{
+  if (active_)
+    data_.end();
+  active_ = false;
+}
+
+void I2SDirectStream::setAudioInfo(AudioInfo info)
+{
+  if (info == cfg_.info)
+    return;
+  cfg_.info = info;
+  data_.setAudioInfo(info);
+  if (cfg_.on_format)
+    cfg_.on_format(info);
+  // 新的字节速率：DMA 位置从现在重新计算
+  start_us_ = host::nowMicros();
+  rx_read_ = tx_written_ = 0;
+  rx_desc_seen_ = tx_desc_seen_ = 0;
+}
+
+uint64_t I2SDirectStream::elapsedBytes() const
+{
+  uint64_t byte_rate = (uint64_t)frameBytes() * cfg_.info.sample_rate;
+  return (host::nowMicros() - start_us_) * byte_rate / 1000000ULL;
+}
+
+void I2SDirectStream::waitForBytes(uint64_t bytes)
+{
+  uint64_t byte_rate = (uint64_t)frameBytes() * cfg_.info.sample_rate;
+  uint64_t at = start_us_ + (bytes * 1000000ULL + byte_rate - 1) / byte_rate;
+  uint64_t now = host::nowMicros();
+  if (at > now)
+    host::advanceMicros(at - now);
+}
+
+void I2SDirectStream::advanceRx(bool blocked)
+{
+  size_t desc = descriptorBytes();
+  uint64_t done = elapsedBytes() / desc;
+  for (; rx_desc_seen_ < done; rx_desc_seen_++)
+  {
+    stats_.rx_desc.fetch_add(1, std::memory_order_relaxed);
+    TRACE_INSTANT(DmaRx, desc);
+  }
+
+  // 读取中（阻塞在 i2s_channel_read）时描述符完成即被取走，不会溢出；
+  // 否则 DMA 正在写入一个描述符，已完成未读的最多 dma_desc_num - 1 个
+  uint64_t ring = (uint64_t)(cfg_.dma_desc_num - 1) * desc;
+  if (blocked || done * desc <= rx_read_ + ring)
+    return;
+
+  uint64_t drop = done * desc - rx_read_ - ring;
+  rx_ovf_raw_.fetch_add((uint32_t)((drop + desc - 1) / desc), std::memory_order_relaxed);
+  // 被覆盖的数据从输入中跳过，之后读到的仍是连续的采样
+  uint8_t scratch[256];
+  for (uint64_t left = drop; left > 0;)
+  {
+    size_t n = left < sizeof(scratch) ? (size_t)left : sizeof(scratch);
+    data_.readUnpaced(scratch, n);
+    left -= n;
+  }
+  rx_read_ += drop;
+}
+
+void I2SDirectStream::advanceTx()
+{
+  size_t desc = descriptorBytes();
+  uint64_t done = elapsedBytes() / desc;
+  for (; tx_desc_seen_ < done; tx_desc_seen_++)
+  {
+    stats_.tx_desc.fetch_add(1, std::memory_order_relaxed);
+    TRACE_INSTANT(DmaTx, desc);
+  }
+
+  uint64_t sent = done * desc;
+  if (sent <= tx_written_)
+    return;
+  tx_ovf_raw_.fetch_add((uint32_t)((sent - tx_written_) / desc), std::memory_order_relaxed);
+  tx_written_ = sent;
+}
+
+size_t I2SDirectStream::readBytes(uint8_t *data, size_t len)
+{
+  if (!active_ || !cfg_.rx)
+    return 0;
+  uint32_t t0 = micros();
+  if (host::env().pace_i2s)
+  {
+    advanceRx(false);
+    settle(rx_ovf_raw_, rx_ovf_seen_, stats_.rx_overflow, t0 - last_read_us_);
+    size_t desc = descriptorBytes();
+    uint64_t need = (rx_read_ + len + desc - 1) / desc * desc; // 读取在描述符完成时返回
+    if (need > rx_desc_seen_ * desc)
+    {
+      waitForBytes(need);
+      advanceRx(true);
+    }
+  }
+  size_t n = data_.readUnpaced(data, len);
+  rx_read_ += n;
+  last_read_us_ = micros();
+  noteCall(stats_.reads, stats_.read_max_us, t0);
+  return n;
+}
+
+size_t I2SDirectStream::write(const uint8_t *data, size_t len)
+{
+  if (!active_ || !cfg_.tx)
+    return 0;
+  uint32_t t0 = micros();
+  if (host::env().pace_i2s)
+  {
+    advanceTx();
+    settle(tx_ovf_raw_, tx_ovf_seen_, stats_.tx_starved, t0 - last_write_us_);
+    size_t desc = descriptorBytes();
+    uint64_t ring = (uint64_t)cfg_.dma_desc_num * desc;
+    uint64_t freed = tx_desc_seen_ * desc;
+    if (tx_written_ + len > freed + ring)
+    {
+      // 环满：等待 DMA 发送完足够的描述符
+      uint64_t need = (tx_written_ + len - ring + desc - 1) / desc * desc;
+      waitForBytes(need);
+      advanceTx();
+    }
+  }
+  size_t n = data_.writeUnpaced(data, len);
+  tx_written_ += n;
+  last_write_us_ = micros();
+  noteCall(stats_.writes, stats_.write_max_us, t0);
+  return n;
+}
+#endif
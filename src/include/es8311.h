@@ -0,0 +1,104 @@
+/**
+ * @file es8311.h
+ * @brief ES8311 精简驱动（寄存器级，ESP-IDF 组件 / Arduino / 主机通用）
+ *
+ * 只包含本项目用到的功能：初始化（从模式、I2S 标准格式）、时钟分频、DAC / ADC 音量、静音、电源。
+ * I2C 访问通过 es8311_bus_t 的回调完成，驱动本身不依赖任何 I2C 库；
+ * 初始化把连续的寄存器合并为一次突发写（ES8311 支持地址自增），事务数不到逐寄存器写入的一半。
+ *
+ * ESP-IDF 组件构建（src/CMakeLists.txt）时 es8311_bus_idf() 使用 driver/i2c.h。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define ES8311_DEFAULT_ADDR 0x18
+
+  typedef int es8311_err_t;
+#define ES8311_OK 0
+#define ES8311_ERR_I2C -1   // I2C 无应答 / 失败
+#define ES8311_ERR_ARG -2   // 参数错误
+#define ES8311_ERR_ID -3    // 芯片 ID 不是 0x8311
+#define ES8311_ERR_CLOCK -4 // 不支持的 MCLK / 采样率组合
+
+  /**
+   * @brief I2C 访问回调（返回 0 表示成功）
+   *
+   * write：一个写事务，data[0] 为起始寄存器，其余为连续寄存器的值
+   * read：先写寄存器地址再读 len 字节（重复起始）
+   */
+  typedef struct
+  {
+    int (*write)(void *ctx, uint8_t addr, const uint8_t *data, size_t len);
+    int (*read)(void *ctx, uint8_t addr, uint8_t reg, uint8_t *data, size_t len);
+    void *ctx;
+    uint8_t addr;
+  } es8311_bus_t;
+
+  typedef enum
+  {
+    ES8311_MODE_ADC = 1,  // 只录音
+    ES8311_MODE_DAC = 2,  // 只播放
+    ES8311_MODE_BOTH = 3, // 全双工
+  } es8311_mode_t;
+
+  typedef struct
+  {
+    uint32_t mclk_hz;     // MCLK 频率（通常为 256 × 采样率）
+    uint32_t sample_rate; // 采样率
+    uint8_t bits;         // 字长 16 / 18 / 20 / 24 / 32
+    bool mclk_from_sclk;  // 没有 MCLK 引脚时用 SCLK 作为时钟源
+  } es8311_clock_t;
+
+  typedef struct
+  {
+    es8311_bus_t bus;
+    es8311_mode_t mode;
+    uint8_t dac_volume; // 寄存器值，0xBF = 0 dB
+    uint8_t adc_volume;
+    uint8_t clock_on; // 0x01 时钟打开时的值
+    bool muted;
+    bool powered;
+    uint32_t writes; // I2C 写事务数（统计）
+  } es8311_t;
+
+  /** @brief 读取芯片 ID（0xFD / 0xFE），期望 0x8311 */
+  es8311_err_t es8311_read_id(es8311_t *dev, uint16_t *id);
+
+  /**
+   * @brief 初始化：检查芯片 ID、写入时钟与格式、上电 mode 对应的模块，DAC 音量 0 dB、不静音
+   */
+  es8311_err_t es8311_init(es8311_t *dev, const es8311_bus_t *bus, const es8311_clock_t *clock, es8311_mode_t mode);
+
+  /** @brief 修改 MCLK / 采样率 / 字长（时钟在写入期间关闭） */
+  es8311_err_t es8311_set_clock(es8311_t *dev, const es8311_clock_t *clock);
+
+  /** @brief DAC 音量 0..100（与 arduino-audio-driver 的刻度相同：寄存器 = volume × 255 / 100） */
+  es8311_err_t es8311_set_volume(es8311_t *dev, int volume);
+
+  /** @brief DAC / ADC 数字音量寄存器值（0xBF = 0 dB，0.5 dB 步进） */
+  es8311_err_t es8311_set_dac_volume_reg(es8311_t *dev, uint8_t reg);
+  es8311_err_t es8311_set_adc_volume_reg(es8311_t *dev, uint8_t reg);
+
+  es8311_err_t es8311_set_mute(es8311_t *dev, bool mute);
+
+  /**
+   * @brief 电源：false 时关闭模拟部分、ADC、DAC 与时钟（待机），true 时按 mode 恢复
+   */
+  es8311_err_t es8311_set_power(es8311_t *dev, bool on);
+
+#if defined(ES8311_IDF_I2C)
+  /** @brief 使用 ESP-IDF I2C 驱动（驱动需已安装）的总线 */
+  es8311_bus_t es8311_bus_idf(int port, uint8_t addr);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file input_dsp.cpp
+ * @brief 录音软件处理实现
+ */
+#include "input_dsp.h"
+
+int32_t inputDspGainQ16(float db)
+{
+  float g = powf(10.0f, db / 20.0f);
+  if (g > 128.0f)
+    g = 128.0f; // +42 dB，保证 64 位乘法不溢出
+  return (int32_t)lrintf(g * 65536.0f);
+}
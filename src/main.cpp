@@ -27,6 +27,23 @@
 #include "AudioTools/Disk/AudioSourceSPIFFS.h"   // SPIFFS 音频源
 #include "AudioTools/AudioCodecs/CodecWAV.h"     //wav解码器
 #include "AudioTools/Disk/AudioSourceSD.h"       // SD 卡音频源
+#include "record_pipeline.h"                     // 录音采集流程
+#include "audio_stats.h"                         // 流水线统计
+#include "audio_trace.h"                         // 跟踪点
+#include "sys_monitor.h"                         // CPU / 栈 / 堆监视
+#include "deferred_log.h"                        // 延迟日志
+#include "static_slot.h"                         // 音频对象静态存储
+#include "block_pool.h"                          // 音频块池
+#include "task_plan.h"                           // 任务核心 / 优先级配置
+#include "audio_tasks.h"                         // 录音 / 播放任务
+#include "boot_profile.h"                        // 启动分析 / 就绪检查
+#include "es8311_regs.h"                         // ES8311 寄存器影子缓存
+#include "audio_control.h"                       // 命令队列与状态机
+#include "battery_monitor.h"                     // 电池电压监视
+#include "i2s_direct.h"                          // i2s_std 通道后端（AUDIO_I2S_DIRECT）
+#include "es8311.h"                              // 精简 ES8311 驱动
+#include "audio_format.h"                        // 编译期音频格式
+#include "power_manager.h"                       // PM 锁 / 动态调频 / 浅睡眠
 
 //===========================================================
 // 存储选择
@@ -38,7 +55,7 @@
 //===========================================================
 #define SDAPIN 10       // I2C 数据线 SDA
 #define SCLPIN 11       // I2C 时钟线 SCL
-#define I2CSPEED 100000 // I2C 时钟频率 100 kHz
+#define I2CSPEED 100000 // I2C 时钟频率 100 kHz（驱动初始化；之后由寄存器缓存切换到 ES8311_I2C_CLOCK_HZ）
 #define ES8311ADDR 0x18 // ES8311 I2C 地址
 
 //===========================================================
@@ -58,6 +75,12 @@
 #define SD_SPI_SCK 26
 #define SD_SPI_CS 33
 
+//===========================================================
+// 启动就绪检查超时（代替固定延时）
+//===========================================================
+#define SD_MOUNT_TIMEOUT_MS 1000    // SD 卡挂载重试上限
+#define CODEC_READY_TIMEOUT_MS 500  // 等待 ES8311 应答芯片 ID 的上限
+
 //===========================================================
 // 功放控制
 //===========================================================
@@ -67,25 +90,18 @@
 // 录音/解码 控制
 //===========================================================
 // 录音时间（秒）
-#define RECORD_SECONDS 5
-
-// 采样率，单位 Hz，这里设置为 16kHz
-#define SAMPLE_RATE 16000 // 16kHz
-
-// 通道数，单声道为1
-#define CHANNELS 1
+constexpr uint16_t RECORD_SECONDS = 5;
 
-// 每个采样的位数，这里使用 32bit PCM
-#define BITS_PER_SAMPLE 32 // 16;
+// 总采样数 = 录音时间 * 采样率 * 通道数
+constexpr size_t TOTAL_SAMPLES = RecordFormat::samples(RECORD_SECONDS);
 
-// 每个采样的字节数（32bit = 4字节）
-#define BYTES_PER_SAMPLE 4 // 2;
+// audio 任务按整块读取：默认录音长度正好是整数个块，文件不会多出一块
+static_assert(TOTAL_SAMPLES * RecordFormat::bytes_per_sample % AUDIO_DMA_BLOCK_SIZE == 0,
+              "默认录音长度不是整数个 DMA 块");
 
-// 总采样数 = 录音时间 * 采样率
-#define TOTAL_SAMPLES RECORD_SECONDS *SAMPLE_RATE
+// 启动后自动执行演示：录音 → 播放录音 → 播放 SD 卡音乐（之后由串口命令控制）
+#define DEMO_ON_BOOT 1
 
-// WVA_RECORD 缓冲区 大小
-#define WVA_RECORD_BUFFER_LENGTH 512
 //===========================================================
 // 音乐文件路径 & PCM 文件路径
 //===========================================================
@@ -96,18 +112,26 @@ const char *ext = "test.wav";         // 默认 WAV 文件名
 //===========================================================
 // I2S 音频信息配置（麦克风输入）
 //===========================================================
-AudioInfo info(16000, 1, 32); // SPH0645 LM4H，单声道，16kHz，32bit PCM
+AudioInfo info = RecordFormat::info(); // SPH0645 LM4H，单声道，16kHz，32bit PCM
 
 WAVEncoder encoder; //  EncoderWAV 编码器对象--用于录音保存为 WAV 文件
 
+//===========================================================
+// 录音块分发：同一 RX 块交给电平表与 storage 任务（编码器），不复制
+//===========================================================
+BlockFanout rx_fanout;
+LevelMeterSink rx_level(RecordFormat::bytes_per_sample);
+
 //===========================================================
 // SD 卡音源初始化
 //===========================================================
 #if MP3_FILE_SD_OR_SPIFFS
 SPIClass mySPI = SPIClass(1);    // 使用第二组 SPI 接口
 AudioSourceSD *source = nullptr; // SD 卡音源指针
+StaticSlot<AudioSourceSD> source_slot;
 #else
 AudioSourceSPIFFS *source = nullptr; // SPIFFS 音源指针
+StaticSlot<AudioSourceSPIFFS> source_slot;
 #endif
 
 //===========================================================
@@ -119,78 +143,270 @@ DriverPins my_pins; // 自定义引脚对象
 //===========================================================
 // 音频板 & I2S 编解码器初始化
 //===========================================================
+/**
+ * @brief I2SCodecStream：格式变化时 AudioBoard 在寄存器缓存之外改写 ES8311，标记缓存过期
+ *
+ * 播放器（storage 任务）切换文件格式、录音开始时恢复录音格式都经过这里。
+ */
+class CodecI2SStream : public I2SCodecStream
+{
+public:
+  using I2SCodecStream::I2SCodecStream;
+
+  void setAudioInfo(AudioInfo info) override
+  {
+    bool changed = info != audioInfo();
+    I2SCodecStream::setAudioInfo(info);
+    if (changed)
+      g_es8311.invalidate();
+  }
+};
+
 AudioBoard *audio_board = nullptr;
-I2SCodecStream *i2s_out_stream = nullptr; // I2S 编解码流对象指针
+CodecI2SStream *i2s_out_stream = nullptr; // I2S 编解码流对象指针
+StatsOutputStream *i2s_stats_out = nullptr; // 统计 I2S 写入的输出包装（播放器 → I2S）
+StaticSlot<AudioBoard> audio_board_slot;
+StaticSlot<CodecI2SStream> i2s_out_stream_slot;
+StaticSlot<StatsOutputStream> i2s_stats_out_slot;
+#if AUDIO_I2S_DIRECT
+I2SDirectStream i2s_direct; // i2s_std 通道后端（代替 AudioBoard + I2SCodecStream）
+es8311_t es8311_dev;        // 精简驱动的状态
+#endif
+AudioStream *i2s_stream = nullptr; // 录音 / 播放使用的 I2S 流
+BlockTxStream *tx_blocks = nullptr; // 播放器输出：解码数据打包成块，由 audio 任务写入 I2S
+StaticSlot<BlockTxStream> tx_blocks_slot;
 TwoWire myWire = TwoWire(0);              // 通用 I2C 接口
 
 //===========================================================
 // 音乐播放器对象
 //===========================================================
 AudioPlayer *player = nullptr; // 音乐播放器对象指针
-
-static bool recordingDone = false;
-static bool playRecDone = false;
-static bool playMusicDone = false;
-uint8_t WVA_RECORDBuf[WVA_RECORD_BUFFER_LENGTH];
+StaticSlot<AudioPlayer> player_slot;
 
 /**
- * @brief 在录音前播放一个短暂的静音 WAV 文件，用于清空 I2S 缓冲区
+ * @brief SD 卡初始化：启动 SPI 并挂载（失败时重试到 SD_MOUNT_TIMEOUT_MS）
  *
- * 该函数会：
- * 1. 创建一个短时静音 WAV 文件（几毫秒）。
- * 2. 使用 WAV 编码器写入静音数据。
- * 3. 停止功放输出，防止噪声干扰。
- * 4. 播放生成的静音 WAV 文件，确保 I2S 编解码器缓冲区被清空。
+ * 只使用 SPI 总线，与 initCodec() 互不依赖，由 bootRunParallel() 在 storage 核心上运行。
  *
- * 使用场景：
- * - 在从播放 WAV 音乐切换到录音前调用，避免录音噪声。
+ * @return 挂载成功
+ */
+bool initSdCard();
+
+/**
+ * @brief 编解码器初始化：功放使能、I2C / I2S 引脚、等待 ES8311 应答、写入寄存器、启动 I2S
  *
- * 注意：
- * - 需要确保 player、encoder、I2S 编解码器对象已经初始化。
- * - 静音 WAV 文件会临时写入 SD 卡路径 `currentFilePath_WVA_RECORD`。
+ * @return 全部成功
+ */
+bool initCodec();
+
+#if AUDIO_I2S_DIRECT
+/** @brief 音频格式对应的 ES8311 时钟（MCLK = 256 fs） */
+es8311_clock_t es8311ClockFor(const AudioInfo &fmt);
+
+/** @brief I2SDirectStream 格式变化回调：同步 ES8311 的字长与分频 */
+void onI2SFormat(const AudioInfo &fmt);
+#endif
+
+/**
+ * @brief 处理串口命令（按行读取，非阻塞）
  *
+ * 支持的命令：
+ * - record [秒]  录音到 rec.wav（默认 RECORD_SECONDS 秒；忙时排队）
+ * - play [路径]  播放 WAV 文件（默认 rec.wav；忙时排队）
+ * - stop         停止当前录音 / 播放，丢弃排队的命令
+ * - stats        输出状态机状态与流水线统计（JSON，一行；排在前面的命令之后）
+ * - stats reset  清零统计（含 pm）
+ * - trace        导出跟踪环形缓冲区（host/tools/trace2chrome.py 转换）
+ * - trace clear  清空跟踪记录
+ * - trace cost   测量一个跟踪点与其中时间戳的耗时（当前频率下，JSON，一行）
+ * - mon          输出一次 CPU 占用 / 任务栈 / 堆统计（JSON，一行）
+ * - pool         输出块池统计（JSON，一行）
+ * - jitter       输出 I2S 读取抖动（p50 / p99 / max）与溢出次数
+ * - es8311       输出寄存器缓存的 I2C 时钟、事务数与待写入寄存器数（JSON，一行）
+ * - battery      输出电池电压、电量、区间与 LED 写入次数（JSON，一行）
+ * - i2s          输出 i2s_std 后端的 DMA 描述符、溢出 / 饥饿与读写耗时（JSON，一行；AUDIO_I2S_DIRECT=1）
+ * - pm           输出电源管理模式、升频状态、各状态时间、估算电流（est_ma，按数据手册典型值推算，不是测量值）与溢出 / 欠载计数（JSON，一行）
  */
-void flushI2SWithSilentWAV();
+void pollSerialCommands();
 
 // ====================== WAV 编码器 ======================
 void setup()
 {
+  uint32_t boot_start_us = micros();
+  HeapSnapshot heap_at_boot = heapSnapshot();
+
   //===========================================================
   // 串口初始化（用于调试日志）
   //===========================================================
+  int phase = bootPhaseBegin("serial");
   Serial.begin(115200);
+  bootPhaseEnd(phase);
 
   //===========================================================
-  // SD 或 SPIFFS 音源初始化
+  // SD 或 SPIFFS 音源对象（只构造，挂载在 initSdCard() 中）
   //===========================================================
+  phase = bootPhaseBegin("objects");
 #if MP3_FILE_SD_OR_SPIFFS
-  // 初始化 SPI 接口
-  mySPI.begin(SD_SPI_SCK, SD_SPI_MISO, SD_SPI_MOSI, SD_SPI_CS);
-  // 创建 SD 音源对象
-  source = new AudioSourceSD(startFilePath, ext, SD_SPI_CS, mySPI);
+  source = source_slot.emplace(startFilePath, ext, SD_SPI_CS, mySPI);
 #else
-  // SPIFFS 音源对象
-  source = new AudioSourceSPIFFS(startFilePath, ext);
+  source = source_slot.emplace(startFilePath, ext);
 #endif
 
-  // 初始化 SD 卡
-  SD.begin(SD_SPI_CS, mySPI);
+  // PSRAM 大块池：录音的 SD 写入批次（没有 PSRAM 时逐块写入）
+  psramBlockPoolBegin();
+
+  // control（loopTask）优先级按任务计划设置
+  taskStart(TaskId::Control, nullptr);
+
+  // 录音块的消费者（编码器由 storage 任务在 audioTasksBegin 中添加）
+  rx_fanout.add(rx_level);
 
   //===========================================================
   // 音频板和 I2S 初始化
   //===========================================================
-  audio_board = new AudioBoard(AudioDriverES8311, my_pins);    // 创建音频板对象
-  i2s_out_stream = new I2SCodecStream(audio_board);            // 创建 I2S 编解码流对象
-  player = new AudioPlayer(*source, *i2s_out_stream, decoder); // 创建播放器对象
+#if AUDIO_I2S_DIRECT
+  i2s_stream = &i2s_direct;
+#else
+  audio_board = audio_board_slot.emplace(AudioDriverES8311, my_pins); // 创建音频板对象
+  i2s_out_stream = i2s_out_stream_slot.emplace(audio_board);          // 创建 I2S 编解码流对象
+  i2s_stream = i2s_out_stream;
+#endif
+  i2s_stats_out = i2s_stats_out_slot.emplace(*i2s_stream);            // 统计 I2S 写入
+  tx_blocks = tx_blocks_slot.emplace(*i2s_stats_out);                 // 播放块输出
+  player = player_slot.emplace(*source, *tx_blocks, decoder);         // 创建播放器对象
+  bootPhaseEnd(phase);
 
   //===========================================================
   // 日志系统初始化
   //===========================================================
+  phase = bootPhaseBegin("logging");
   AudioLogger::instance().begin(Serial, AudioLogger::Warning);
   AudioDriverLogger.begin(Serial, AudioDriverLogLevel::Warning);
 
-  delay(2000); // 等待系统稳定
+  // 热路径日志（DLOG）由低优先级任务格式化输出
+  deferredLogStart(Serial);
+
+  // 周期输出 CPU 占用、任务栈高水位与堆最小剩余（SYS_MONITOR_PERIOD_MS）
+  sysMonitorStart(Serial);
+  bootPhaseEnd(phase);
 
+  //===========================================================
+  // SD 卡（SPI，storage 核心）与 ES8311 + I2S（I2C / I2S，当前核心）并行初始化
+  //===========================================================
+  BootJob init_jobs[] = {
+      {"sd mount", initSdCard, TaskId::Storage},
+      {"codec + i2s", initCodec, TaskId::Control},
+  };
+  bootRunParallel(init_jobs, sizeof(init_jobs) / sizeof(init_jobs[0]));
+  if (!init_jobs[0].ok)
+    Serial.println("SD 卡挂载失败");
+  if (!init_jobs[1].ok)
+    Serial.println("ES8311 初始化失败");
+
+  phase = bootPhaseBegin("player");
+
+  //===========================================================
+  // WAV 文件初始化（加载 test.wav，但不播放）
+  //===========================================================
+  player->begin(0, 0);
+  // std::string filepath = "/music/a1.wav"; // 指向新的 WAV 文件
+  // player->setPath(filepath.c_str());      // 重新设置播放路径
+
+  // audio（I2S，核心 1）与 storage（SD / 编解码，核心 0）任务
+  audioTasksBegin(*i2s_stream, *i2s_stats_out, *player, rx_fanout, *tx_blocks);
+
+  //===========================================================
+  // 增益与滤波：ES8311 硬件处理（DAC 音量、ADC 高通），不可用时退回软件
+  //===========================================================
+  audioSetOutputVolume(0.55); // 初始音量（硬件时播放器软件音量为 1.0）
+  audioSetInputHpf(true);     // 录音直流去除
+
+  //===========================================================
+  // 命令状态机（loop() 中运行）
+  //===========================================================
+  AudioControlConfig control;
+  control.record_fs = &SD;
+#if MP3_FILE_SD_OR_SPIFFS
+  control.play_fs = &SD;
+#else
+  control.play_fs = &SPIFFS;
+#endif
+  control.record_path = RECORD_FILE_PATH;
+  control.encoder = &encoder;
+  control.info = info;
+  control.i2s = i2s_stream;
+  control.record_seconds = RECORD_SECONDS;
+  control.player = player;
+  control.level = &rx_level;
+  control.out = &Serial;
+  audioControlBegin(control);
+  bootPhaseEnd(phase);
+
+  //===========================================================
+  // 电池电压：ADC 连续采样，loop() 中只处理新帧（代替旧的 analogRead 忙循环任务）
+  //===========================================================
+  phase = bootPhaseBegin("battery");
+  if (!batteryMonitorBegin())
+    Serial.println("电池 ADC 启动失败");
+  if (BATTERY_LED_HALF_PIN < 0 && BATTERY_LED_LOW_PIN < 0)
+    Serial.println("电量 LED 未配置（BATTERY_LED_HALF_PIN / BATTERY_LED_LOW_PIN），只能用 battery 命令查看电量");
+  bootPhaseEnd(phase);
+
+  //===========================================================
+  // 电源管理（AUDIO_PM=1）：空闲时降频 / 浅睡眠，录音 / 播放期间按负载升频
+  //===========================================================
+  phase = bootPhaseBegin("power");
+  if (!pmBegin())
+    Serial.println("电源管理不可用（需要 CONFIG_PM_ENABLE），保持固定频率");
+  // I2S 通道在 initCodec() 中启动后一直运行（驱动持有 PM 锁），之后不再停止：设备从不浅睡眠，只调频
+  pmSetI2SRunning(true);
+  bootPhaseEnd(phase);
+  bootReady();
+
+  // 各阶段耗时
+  bootReport(Serial);
+
+  // 启动耗时与堆使用（AUDIO_STATIC_ALLOC=0 时音频对象在堆上，可对比）
+  HeapSnapshot heap_ready = heapSnapshot();
+  Serial.printf("[boot] %s alloc, setup %lu ms, heap free %lu (used %ld), largest block %lu, frag %lu%%\n",
+                AUDIO_STATIC_ALLOC ? "static" : "heap", (unsigned long)((micros() - boot_start_us) / 1000),
+                (unsigned long)heap_ready.free_bytes, (long)heap_at_boot.free_bytes - (long)heap_ready.free_bytes,
+                (unsigned long)heap_ready.largest_block, (unsigned long)heapFragmentation(heap_ready));
+
+#if DEMO_ON_BOOT
+  audioCommandPostRecord(RECORD_SECONDS);
+  audioCommandPostPlay(RECORD_FILE_PATH);
+  audioCommandPostPlay("/music/test.wav");
+#endif
+}
+
+void loop()
+{
+  // 串口命令放入队列，状态机执行一步（只切换状态，不等待录音 / 播放完成）
+  pollSerialCommands();
+  audioControlStep();
+  batteryMonitorPoll();
+#if PM_CONSOLE_USB
+  pmConsoleActive(Serial); // USB 串口连接期间不浅睡眠
+#endif
+
+  // 没有工作时等待录音 / 播放完成的通知，最多 AUDIO_CONTROL_POLL_MS
+  taskIdle(AUDIO_CONTROL_POLL_MS);
+}
+
+bool initSdCard()
+{
+#if MP3_FILE_SD_OR_SPIFFS
+  // 初始化 SPI 接口
+  mySPI.begin(SD_SPI_SCK, SD_SPI_MISO, SD_SPI_MOSI, SD_SPI_CS);
+#endif
+  // 初始化 SD 卡（挂载失败时重试，直到卡就绪或超时）
+  return bootWaitUntil(
+      SD_MOUNT_TIMEOUT_MS, [] { return SD.begin(SD_SPI_CS, mySPI) && SD.cardType() != CARD_NONE; }, 10);
+}
+
+bool initCodec()
+{
   //===========================================================
   // 功放使能
   //===========================================================
@@ -209,9 +425,35 @@ void setup()
   my_pins.begin();
 
   //===========================================================
-  // 初始化音频板
+  // 初始化音频板（等待 ES8311 上电应答芯片 ID，代替固定延时）
   //===========================================================
-  audio_board->begin();
+  if (!bootWaitUntil(CODEC_READY_TIMEOUT_MS, [] { return es8311ChipReady(myWire, ES8311ADDR); }))
+    return false;
+
+#if AUDIO_I2S_DIRECT
+  //===========================================================
+  // ES8311（精简驱动）+ i2s_std 通道，不经过 AudioBoard / I2SCodecStream
+  //===========================================================
+  es8311_bus_t bus = es8311WireBus(myWire, ES8311ADDR);
+  es8311_clock_t clock = es8311ClockFor(info);
+  if (es8311_init(&es8311_dev, &bus, &clock, ES8311_MODE_BOTH) != ES8311_OK)
+    return false;
+
+  I2SDirectConfig direct;
+  direct.info = info;
+  direct.mclk = MCLKPIN;
+  direct.bclk = BCLKPIN;
+  direct.ws = WSPIN;
+  direct.dout = DOPIN;
+  direct.din = DIPIN;
+  direct.on_format = onI2SFormat;
+  if (!i2s_direct.begin(direct))
+    return false;
+  int dma_count = (int)direct.dma_desc_num;
+  int dma_size = (int)i2s_direct.descriptorBytes();
+#else
+  if (!audio_board->begin())
+    return false;
 
   //===========================================================
   // I2S 配置并启动
@@ -219,143 +461,134 @@ void setup()
   auto i2s_config = i2s_out_stream->defaultConfig(RXTX_MODE); // 获取默认配置
   i2s_config.copyFrom(info);                                  // 应用麦克风参数
   i2s_config.i2s_format = I2S_STD_FORMAT;                     // I2S 标准格式
-  i2s_out_stream->begin(i2s_config);                          // 启动 I2S
-  i2s_out_stream->setVolume(0.55);                            // I2S 初始音量
-
-  //===========================================================
-  // 播放器增益设置
-  //===========================================================
-  player->setVolume(1.0); // 设置播放器音量
+  if (!i2s_out_stream->begin(i2s_config))                     // 启动 I2S
+    return false;
+  int dma_count = i2s_config.buffer_count;
+  int dma_size = i2s_config.buffer_size;
+#endif
 
-  //===========================================================
-  // WAV 文件初始化（加载 test.wav，但不播放）
-  //===========================================================
-  player->begin(0, 0);
-  // std::string filepath = "/music/a1.wav"; // 指向新的 WAV 文件
-  // player->setPath(filepath.c_str());      // 重新设置播放路径
+  // ES8311 寄存器影子缓存：之后的寄存器调整在本地读-改-写，批量写入（I2C 切换到快速模式）
+  if (!g_es8311.begin(myWire, ES8311ADDR))
+    Serial.println("ES8311 寄存器缓存不可用，增益与滤波使用软件处理");
 
-  delay(1000); // 等待系统准备完毕
+  // DMA 缓冲时长，用于判断 RX 溢出 / TX 欠载
+  audioStatsSetDmaBudget(info, dma_count, dma_size);
+  return true;
 }
 
-void loop()
+#if AUDIO_I2S_DIRECT
+es8311_clock_t es8311ClockFor(const AudioInfo &fmt)
 {
+  return {256 * (uint32_t)fmt.sample_rate, (uint32_t)fmt.sample_rate, (uint8_t)fmt.bits_per_sample, false};
+}
 
-  // =====================================================
-  // 1️⃣ 录音 → 保存为 WAV
-  // =====================================================
-  if (!recordingDone)
-  {
-    Serial.println("开始录音 WAV");
+void onI2SFormat(const AudioInfo &fmt)
+{
+  // 播放器切换格式（如 16 bit 的 WAV）时在 I2S 通道停止期间调用
+  es8311_clock_t clock = es8311ClockFor(fmt);
+  if (es8311_set_clock(&es8311_dev, &clock) != ES8311_OK)
+    DLOG("es8311 clock %d Hz %d bit rejected", fmt.sample_rate, fmt.bits_per_sample);
+  g_es8311.invalidate(); // 精简驱动直接写了时钟 / 字长寄存器
+}
+#endif
 
-    // 停止播放器，确保 I2S RX 可用
-    player->end();
+void pollSerialCommands()
+{
+  static char line[64];
+  static size_t len = 0;
 
-    File recFile = SD.open(RECORD_FILE_PATH, FILE_WRITE);
-    if (!recFile)
+  while (Serial.available() > 0)
+  {
+    char c = (char)Serial.read();
+    if (c != '\n' && c != '\r')
     {
-      Serial.println("无法创建 rec.wav");
-      return;
+      if (len < sizeof(line) - 1)
+        line[len++] = c;
+      continue;
     }
+    if (len == 0)
+      continue;
+    line[len] = 0;
+    len = 0;
 
-    encoder.begin(info);
-    encoder.setOutput(recFile);
-
-    int samples_recorded = 0;
-
-    while (samples_recorded < TOTAL_SAMPLES)
+    AudioCommand cmd;
+    if (audioCommandParse(line, cmd))
     {
-      size_t bytes = i2s_out_stream->readBytes(WVA_RECORDBuf, sizeof(WVA_RECORDBuf)); // 从 I2S 读取音频数据
-      if (bytes < BYTES_PER_SAMPLE)                                                   // 数据不足，继续读取
-        continue;
-
-      size_t aligned = (bytes / BYTES_PER_SAMPLE) * BYTES_PER_SAMPLE;
-
-      encoder.write(WVA_RECORDBuf, aligned); // 写入 WAV 编码器
-      samples_recorded += aligned / BYTES_PER_SAMPLE;
+      if (!audioCommandPost(cmd))
+        Serial.println("命令队列已满");
     }
-
-    encoder.end(); // 写 WAV 头
-    recFile.close();
-
-    recordingDone = true;
-    Serial.println("录音完成：rec.wav");
-    delay(1000);
-  }
-
-  // =====================================================
-  // 2️⃣ 播放录音 WAV
-  // =====================================================
-  if (recordingDone && !playRecDone)
-  {
-    Serial.println("播放录音 WAV");
-
-    player->setPath(RECORD_FILE_PATH);
-    player->play();
-
-    while (player->copy())
+    else if (strcmp(line, "stats reset") == 0)
     {
-      // AudioPlayer 内部自动解码 WAV → I2S
+      audioStatsReset();
+      pmStatsReset();
+      Serial.println("stats cleared");
     }
-
-    playRecDone = true;
-    Serial.println("录音 WAV 播放完成");
-    delay(1000);
-  }
-
-  // =====================================================
-  // 3️⃣ 播放 SD 卡 WAV 音乐
-  // =====================================================
-  if (!playMusicDone)
-  {
-    Serial.println("播放 SD WAV 音乐");
-
-    // 使用你 setup 里定义的 source/ext
-    player->setPath("/music/test.wav");
-    player->play();
-
-    while (player->copy())
+    else if (strcmp(line, "mon") == 0)
     {
+      char json[SYS_MONITOR_JSON_SIZE];
+      sysMonitorLast(json, sizeof(json));
+      Serial.println(json);
+    }
+    else if (strcmp(line, "pool") == 0)
+    {
+      char json[256];
+      blockPoolsToJson(json, sizeof(json));
+      Serial.println(json);
+    }
+    else if (strcmp(line, "jitter") == 0)
+    {
+      const LatencyHistogram &j = g_audio_stats.rx_jitter;
+      Serial.printf("[jitter] tasks %s, rx p50 %lu us, p99 %lu us, max %lu us, overruns %lu, dropped blocks %lu\n",
+                    AUDIO_TASKS ? "on" : "off", (unsigned long)j.percentile(50), (unsigned long)j.percentile(99),
+                    (unsigned long)j.max_us.load(), (unsigned long)g_audio_stats.overruns.load(),
+                    (unsigned long)g_audio_stats.rx_dropped_blocks.load());
+    }
+    else if (strcmp(line, "es8311") == 0)
+    {
+      char json[128];
+      g_es8311.toJson(json, sizeof(json));
+      Serial.println(json);
+    }
+    else if (strcmp(line, "i2s") == 0)
+    {
+#if AUDIO_I2S_DIRECT
+      char json[320];
+      i2s_direct.toJson(json, sizeof(json));
+      Serial.println(json);
+#else
+      Serial.println("[i2s] AudioTools I2SCodecStream（AUDIO_I2S_DIRECT=0），DMA 统计见 stats / jitter");
+#endif
+    }
+    else if (strcmp(line, "pm") == 0)
+    {
+      char json[384];
+      pmToJson(json, sizeof(json));
+      Serial.println(json);
+    }
+    else if (strcmp(line, "battery") == 0)
+    {
+      char json[160];
+      batteryStatusToJson(json, sizeof(json));
+      Serial.println(json);
+    }
+    else if (strcmp(line, "trace") == 0)
+    {
+      traceDump(Serial);
+    }
+    else if (strcmp(line, "trace cost") == 0)
+    {
+      char json[96];
+      traceCostToJson(json, sizeof(json));
+      Serial.println(json);
+    }
+    else if (strcmp(line, "trace clear") == 0)
+    {
+      traceClear();
+      Serial.println("trace cleared");
+    }
+    else
+    {
+      Serial.printf("未知命令: %s\n", line);
     }
-
-    playMusicDone = true;
-    Serial.println("音乐 WAV 播放完成");
-  }
-
-  delay(2000);
-}
-
-void flushI2SWithSilentWAV()
-{
-  // 清空数据
-  memset(WVA_RECORDBuf, 0, WVA_RECORD_BUFFER_LENGTH);
-
-  File WVA_RECORDFile = SD.open(RECORD_FILE_PATH, FILE_WRITE);
-  if (!WVA_RECORDFile)
-  {
-    return;
-  }
-
-  encoder.begin(info);               // 使用与输入相同的音频信息初始化编码器
-  encoder.setOutput(WVA_RECORDFile); // 设置输出文件
-
-  digitalWrite(I2S_PA_EN, 0); // 停止功放
-
-  //单位8ms(与音频info设置有关)
-  for (int o = 0; o < 1; o++)
-  {
-    // 写入一个空数据
-    encoder.write(WVA_RECORDBuf, WVA_RECORD_BUFFER_LENGTH); // 512 总结大概8ms
   }
-
-  encoder.end(); // 写 WAV 头
-  // 关闭文件
-  WVA_RECORDFile.close();
-  vTaskDelay(5 / portTICK_PERIOD_MS); // 等待完成
-  // 设置文件路径
-  player->setPath(RECORD_FILE_PATH);
-  player->play();
-  player->copyAll(); // 播放
-
-  vTaskDelay(5 / portTICK_PERIOD_MS); // 等待完成
 }
-
@@ -0,0 +1,395 @@
+/**
+ * @file power_manager.cpp
+ * @brief 电源管理实现：PM 锁、负载估计与电流估算
+ */
+#include "power_manager.h"
+
+#include <atomic>
+
+#include "audio_stats.h"
+
+#if defined(HOST_BUILD)
+#include "host_env.h"
+#else
+#include "esp_timer.h"
+#endif
+
+#if PM_IDF
+#include "esp_idf_version.h"
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#if !PM_CONSOLE_USB
+#include "driver/uart.h"
+#endif
+#endif
+
+namespace
+{
+  /**
+   * @brief 每个处理任务的状态（只由该任务写入；pmToJson 读取时可能差一块，只用于统计）
+   */
+  struct PmTask
+  {
+    PmGovernor governor;
+    bool boosted = false; // 这一块持有 CPU_FREQ_MAX
+    uint32_t mhz = PM_MAX_MHZ;
+    uint64_t start_us = 0;
+    uint32_t paused_work_us = 0; // pmWorkPause 之前的处理时间
+    bool active = false;
+    uint64_t work_max_us = 0;
+    uint64_t work_min_us = 0;
+    uint32_t blocks = 0;
+    uint32_t late = 0; // 处理时间超过块时长的块数
+#if PM_IDF
+    esp_pm_lock_handle_t cpu_lock = nullptr;
+#endif
+  };
+
+  PmTask s_tasks[2]; // audio / storage
+  PmMode s_mode = PmMode::Off;
+  bool s_dfs = false; // esp_pm 动态调频已启用
+  bool s_light_sleep = false;
+
+  std::atomic<uint32_t> s_streams{0};
+  uint64_t s_stream_start_us = 0;
+  uint64_t s_stream_us = 0;
+  uint64_t s_since_us = 0;
+
+  // 可以浅睡眠的空闲时间（只在 control 中更新）
+  bool s_i2s_running = false;
+  bool s_console = false;
+  bool s_sleep_window = false;
+  uint64_t s_sleep_start_us = 0;
+  uint64_t s_sleep_us = 0;
+#if PM_IDF
+  esp_pm_lock_handle_t s_stream_lock = nullptr;
+  esp_pm_lock_handle_t s_console_lock = nullptr;
+#endif
+
+  uint64_t nowUs()
+  {
+#if defined(HOST_BUILD)
+    return host::nowMicros();
+#else
+    return (uint64_t)esp_timer_get_time();
+#endif
+  }
+
+  PmTask *taskState(TaskId task)
+  {
+    if (task == TaskId::Audio)
+      return &s_tasks[0];
+    if (task == TaskId::Storage)
+      return &s_tasks[1];
+    return nullptr;
+  }
+
+  /** @brief 没有 esp_pm 时：录音 / 播放期间最高频率，空闲时最低频率 */
+  void setFixedMhz(uint32_t mhz)
+  {
+#if AUDIO_PM && !PM_IDF && !defined(HOST_BUILD)
+    if (getCpuFrequencyMhz() != mhz)
+      setCpuFrequencyMhz(mhz);
+#else
+    (void)mhz;
+#endif
+  }
+
+  /** @brief 结算上一段并重新判断：空闲、I2S 通道停止、没有控制台锁时才可能浅睡眠（control 中调用） */
+  void updateSleepWindow()
+  {
+    uint64_t now = nowUs();
+    if (s_sleep_window)
+      s_sleep_us += now - s_sleep_start_us;
+    s_sleep_start_us = now;
+    s_sleep_window = s_light_sleep && !s_i2s_running && !s_console && !s_streams.load(std::memory_order_acquire);
+  }
+
+  /** @brief 当前没有持有 CPU 锁时处理所在的频率 */
+  uint32_t baseMhz()
+  {
+    if (s_dfs)
+      return PM_MIN_MHZ;
+#if AUDIO_PM && !defined(HOST_BUILD)
+    return getCpuFrequencyMhz();
+#else
+    return PM_MAX_MHZ;
+#endif
+  }
+}
+
+uint32_t pmCurrentUa(uint32_t mhz, bool running)
+{
+  int32_t lo = running ? PM_UA_RUN_80 : PM_UA_IDLE_80;
+  int32_t hi = running ? PM_UA_RUN_240 : PM_UA_IDLE_240;
+  return (uint32_t)(lo + (hi - lo) * ((int32_t)mhz - 80) / 160);
+}
+
+const char *pmModeName(PmMode mode)
+{
+  switch (mode)
+  {
+  case PmMode::Off:
+    return "off";
+  case PmMode::Stream:
+    return "stream";
+  case PmMode::Dfs:
+    return "dfs";
+  }
+  return "?";
+}
+
+uint32_t pmEstimateUa(const PmTimes &t, PmMode mode)
+{
+  if (!t.total_us)
+    return 0;
+  double work_max = (double)t.work_max_us;
+  double work_min = (double)t.work_min_us;
+  double stream = (double)t.stream_us;
+  double total = (double)t.total_us;
+  double uas; // µA·µs
+  if (mode == PmMode::Dfs)
+  {
+    double wait = stream - work_max - work_min;
+    double sleep = (double)t.sleep_us;
+    uas = work_max * pmCurrentUa(PM_MAX_MHZ, true) + work_min * pmCurrentUa(PM_MIN_MHZ, true) +
+          (wait > 0 ? wait : 0) * pmCurrentUa(PM_MIN_MHZ, false) + sleep * PM_UA_LIGHT_SLEEP +
+          (total - stream - sleep) * pmCurrentUa(PM_MIN_MHZ, false);
+  }
+  else
+  {
+    double work = work_max + work_min * PM_MIN_MHZ / PM_MAX_MHZ;
+    double idle_ua = pmCurrentUa(mode == PmMode::Stream ? PM_MIN_MHZ : PM_MAX_MHZ, false);
+    uas = work * pmCurrentUa(PM_MAX_MHZ, true) + (stream - work) * pmCurrentUa(PM_MAX_MHZ, false) +
+          (total - stream) * idle_ua;
+  }
+  return (uint32_t)(uas / total);
+}
+
+bool pmBegin()
+{
+  s_since_us = nowUs();
+#if PM_IDF
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t cfg = {};
+#else
+  esp_pm_config_esp32s3_t cfg = {};
+#endif
+  cfg.max_freq_mhz = PM_MAX_MHZ;
+  cfg.min_freq_mhz = PM_MIN_MHZ;
+  cfg.light_sleep_enable = PM_LIGHT_SLEEP;
+  esp_err_t err = esp_pm_configure(&cfg);
+  if (err == ESP_ERR_NOT_SUPPORTED && cfg.light_sleep_enable)
+  {
+    // 没有 tickless idle：只调频
+    cfg.light_sleep_enable = false;
+    err = esp_pm_configure(&cfg);
+  }
+  if (err != ESP_OK)
+    return false;
+  s_light_sleep = cfg.light_sleep_enable;
+#if !PM_CONSOLE_USB
+  if (s_light_sleep)
+  {
+    // UART 串口：RX 边沿唤醒（唤醒前收到的几个字符会丢失）
+    uart_set_wakeup_threshold((uart_port_t)CONFIG_ESP_CONSOLE_UART_NUM, 3);
+    esp_sleep_enable_uart_wakeup(CONFIG_ESP_CONSOLE_UART_NUM);
+  }
+#endif
+  if (esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "audio_stream", &s_stream_lock) != ESP_OK ||
+      esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "console", &s_console_lock) != ESP_OK ||
+      esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "audio_work", &s_tasks[0].cpu_lock) != ESP_OK ||
+      esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "storage_work", &s_tasks[1].cpu_lock) != ESP_OK)
+    return false;
+  s_dfs = true;
+  s_mode = PmMode::Dfs;
+  if (s_console)
+    esp_pm_lock_acquire(s_console_lock);
+  updateSleepWindow();
+  return true;
+#elif AUDIO_PM
+  s_mode = PmMode::Stream;
+  setFixedMhz(PM_MIN_MHZ);
+  return true;
+#else
+  return true;
+#endif
+}
+
+PmMode pmMode() { return s_mode; }
+
+void pmStreamBegin()
+{
+  if (s_streams.fetch_add(1, std::memory_order_acq_rel) != 0)
+    return;
+  s_stream_start_us = nowUs();
+  updateSleepWindow();
+#if PM_IDF
+  if (s_stream_lock)
+    esp_pm_lock_acquire(s_stream_lock);
+#endif
+  setFixedMhz(PM_MAX_MHZ);
+}
+
+void pmStreamEnd()
+{
+  uint32_t n = s_streams.load(std::memory_order_acquire);
+  while (n && !s_streams.compare_exchange_weak(n, n - 1, std::memory_order_acq_rel))
+  {
+  }
+  if (n != 1)
+    return;
+  s_stream_us += nowUs() - s_stream_start_us;
+  for (PmTask &t : s_tasks)
+    t.governor.reset();
+#if PM_IDF
+  if (s_stream_lock)
+    esp_pm_lock_release(s_stream_lock);
+#endif
+}
+
+void pmIdleStep()
+{
+  if (s_streams.load(std::memory_order_acquire))
+    return;
+  setFixedMhz(PM_MIN_MHZ);
+  updateSleepWindow();
+}
+
+void pmSetI2SRunning(bool running)
+{
+  s_i2s_running = running;
+  updateSleepWindow();
+}
+
+void pmConsoleActive(bool active)
+{
+  if (active == s_console)
+    return;
+  s_console = active;
+#if PM_IDF
+  if (s_console_lock)
+    active ? esp_pm_lock_acquire(s_console_lock) : esp_pm_lock_release(s_console_lock);
+#endif
+  updateSleepWindow();
+}
+
+void pmWorkBegin(TaskId task)
+{
+  PmTask *t = taskState(task);
+  if (!t)
+    return;
+  t->paused_work_us = 0;
+  t->boosted = s_dfs && t->governor.boost();
+  pmWorkResume(task);
+}
+
+void pmWorkPause(TaskId task)
+{
+  PmTask *t = taskState(task);
+  if (!t || !t->active)
+    return;
+  uint32_t work = (uint32_t)(nowUs() - t->start_us);
+#if PM_IDF
+  if (t->boosted)
+    esp_pm_lock_release(t->cpu_lock);
+#endif
+  t->active = false;
+  t->paused_work_us += work;
+  if (t->mhz >= PM_MAX_MHZ)
+    t->work_max_us += work;
+  else
+    t->work_min_us += work;
+}
+
+void pmWorkResume(TaskId task)
+{
+  PmTask *t = taskState(task);
+  if (!t || t->active)
+    return;
+#if PM_IDF
+  if (t->boosted)
+    esp_pm_lock_acquire(t->cpu_lock);
+#endif
+  t->active = true;
+  t->mhz = t->boosted ? PM_MAX_MHZ : baseMhz();
+  t->start_us = nowUs();
+}
+
+void pmWorkEnd(TaskId task, uint32_t budget_us)
+{
+  PmTask *t = taskState(task);
+  if (!t)
+    return;
+  pmWorkPause(task);
+  uint32_t work = t->paused_work_us;
+  t->paused_work_us = 0;
+  if (!budget_us)
+    return;
+  t->blocks++;
+  if (work > budget_us)
+    t->late++;
+  t->governor.update(work, t->mhz, budget_us);
+}
+
+uint32_t pmBlockUs(size_t bytes)
+{
+  uint32_t rate = g_audio_stats.byte_rate.load(std::memory_order_relaxed);
+  return rate ? (uint32_t)((uint64_t)bytes * 1000000ULL / rate) : 0;
+}
+
+uint32_t pmBlockUs(size_t bytes, const AudioInfo &info)
+{
+  uint64_t rate = (uint64_t)info.sample_rate * info.channels * (info.bits_per_sample == 16 ? 2 : 4);
+  return rate ? (uint32_t)((uint64_t)bytes * 1000000ULL / rate) : 0;
+}
+
+void pmStatsReset()
+{
+  s_since_us = nowUs();
+  s_stream_us = 0;
+  if (s_streams.load(std::memory_order_acquire))
+    s_stream_start_us = s_since_us;
+  s_sleep_us = 0;
+  s_sleep_start_us = s_since_us;
+  for (PmTask &t : s_tasks)
+  {
+    t.work_max_us = 0;
+    t.work_min_us = 0;
+    t.blocks = 0;
+    t.late = 0;
+  }
+}
+
+size_t pmToJson(char *buf, size_t len)
+{
+  uint64_t now = nowUs();
+  PmTimes times{};
+  times.total_us = now - s_since_us;
+  times.stream_us = s_stream_us + (s_streams.load(std::memory_order_acquire) ? now - s_stream_start_us : 0);
+  times.sleep_us = s_sleep_us + (s_sleep_window ? now - s_sleep_start_us : 0);
+  for (const PmTask &t : s_tasks)
+  {
+    times.work_max_us += t.work_max_us;
+    times.work_min_us += t.work_min_us;
+  }
+  const PmTask &a = s_tasks[0];
+  const PmTask &s = s_tasks[1];
+  const AudioStats &st = g_audio_stats;
+  int n = snprintf(
+      buf, len,
+      "{\"pm\":\"%s\",\"light_sleep\":%d,\"mhz\":[%d,%d],\"boost\":[%d,%d],\"boosts\":[%lu,%lu],"
+      "\"ms\":{\"total\":%lu,\"stream\":%lu,\"work_max\":%lu,\"work_min\":%lu,\"sleep\":%lu},"
+      "\"late\":[%lu,%lu],\"est_ma\":%.1f,\"est_ma_240\":%.1f,"
+      "\"overruns\":%lu,\"underruns\":%lu,\"rx_dropped\":%lu}",
+      pmModeName(s_mode), s_light_sleep ? 1 : 0, PM_MIN_MHZ, PM_MAX_MHZ,
+      a.governor.boost() ? 1 : 0, s.governor.boost() ? 1 : 0, (unsigned long)a.governor.boosts(),
+      (unsigned long)s.governor.boosts(), (unsigned long)(times.total_us / 1000),
+      (unsigned long)(times.stream_us / 1000), (unsigned long)(times.work_max_us / 1000),
+      (unsigned long)(times.work_min_us / 1000), (unsigned long)(times.sleep_us / 1000), (unsigned long)a.late, (unsigned long)s.late,
+      pmEstimateUa(times, s_mode) / 1000.0, pmEstimateUa(times, PmMode::Off) / 1000.0,
+      (unsigned long)st.overruns.load(std::memory_order_relaxed),
+      (unsigned long)st.underruns.load(std::memory_order_relaxed),
+      (unsigned long)st.rx_dropped_blocks.load(std::memory_order_relaxed));
+  return n < 0 ? 0 : ((size_t)n < len ? (size_t)n : len - 1);
+}
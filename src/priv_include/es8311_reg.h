@@ -0,0 +1,70 @@
+/**
+ * @file es8311_reg.h
+ * @brief ES8311 寄存器地址与位定义（见 ES8311 数据手册），只在驱动内部使用
+ */
+#pragma once
+
+//===========================================================
+// 复位 / 时钟管理
+//===========================================================
+#define ES8311_RESET_REG00 0x00       // [7] CSM_ON 状态机上电，[6] MSC 主模式，[4:0] 复位
+#define ES8311_CLK_MANAGER_REG01 0x01 // [7] MCLK 来自 SCLK，[6] MCLK 反相，[5:0] 各模块时钟使能
+#define ES8311_CLK_MANAGER_REG02 0x02 // [7:5] PRE_DIV - 1，[4:3] PRE_MULTI（×1 / ×2 / ×4 / ×8）
+#define ES8311_CLK_MANAGER_REG03 0x03 // [6] ADC FS_MODE，[5:0] ADC_OSR
+#define ES8311_CLK_MANAGER_REG04 0x04 // [5:0] DAC_OSR
+#define ES8311_CLK_MANAGER_REG05 0x05 // [7:4] ADC_DIV - 1，[3:0] DAC_DIV - 1
+#define ES8311_CLK_MANAGER_REG06 0x06 // [5] SCLK 反相，[4:0] BCLK_DIV
+#define ES8311_CLK_MANAGER_REG07 0x07 // [3:0] LRCK_DIV 高位
+#define ES8311_CLK_MANAGER_REG08 0x08 // [7:0] LRCK_DIV 低位
+
+//===========================================================
+// 串行数据口
+//===========================================================
+#define ES8311_SDPIN_REG09 0x09  // DAC 输入：[6] 静音，[4:2] 字长，[1:0] 格式
+#define ES8311_SDPOUT_REG0A 0x0A // ADC 输出：同上
+#define ES8311_SDP_WL_24 (0 << 2)
+#define ES8311_SDP_WL_20 (1 << 2)
+#define ES8311_SDP_WL_18 (2 << 2)
+#define ES8311_SDP_WL_16 (3 << 2)
+#define ES8311_SDP_WL_32 (4 << 2)
+#define ES8311_SDP_I2S 0x00
+
+//===========================================================
+// 系统 / 电源
+//===========================================================
+#define ES8311_SYSTEM_REG0B 0x0B
+#define ES8311_SYSTEM_REG0C 0x0C
+#define ES8311_SYSTEM_REG0D 0x0D // 模拟部分电源：0x01 上电，0xFA 下电
+#define ES8311_SYSTEM_REG0E 0x0E // PGA / ADC 调制器：0x02 上电，0xFF 下电
+#define ES8311_SYSTEM_REG10 0x10
+#define ES8311_SYSTEM_REG11 0x11
+#define ES8311_SYSTEM_REG12 0x12 // DAC：0x00 上电，0x02 下电
+#define ES8311_SYSTEM_REG13 0x13
+#define ES8311_SYSTEM_REG14 0x14 // [6] 数字麦克风，[5:4] 输入选择，[3:0] PGA 增益（3 dB 步进）
+
+//===========================================================
+// ADC
+//===========================================================
+#define ES8311_ADC_REG15 0x15
+#define ES8311_ADC_REG16 0x16 // [2:0] ADC 数字增益（6 dB 步进）
+#define ES8311_ADC_REG17 0x17 // ADC 数字音量：0xBF = 0 dB，0.5 dB 步进
+#define ES8311_ADC_REG1B 0x1B
+#define ES8311_ADC_REG1C 0x1C
+
+//===========================================================
+// DAC
+//===========================================================
+#define ES8311_DAC_REG31 0x31 // [6:5] DAC 静音
+#define ES8311_DAC_REG32 0x32 // DAC 数字音量：0xBF = 0 dB，0.5 dB 步进
+#define ES8311_DAC_REG37 0x37 // [3] DAC EQ 旁路
+
+//===========================================================
+// 其他
+//===========================================================
+#define ES8311_GPIO_REG44 0x44 // [3] I2C 抗干扰（写两次）
+#define ES8311_GP_REG45 0x45
+#define ES8311_CHD1_REGFD 0xFD // 芯片 ID 0x83
+#define ES8311_CHD2_REGFE 0xFE // 芯片 ID 0x11
+
+#define ES8311_DAC_MUTE_BITS 0x60
+#define ES8311_VOLUME_0DB_REG 0xBF
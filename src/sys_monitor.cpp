@@ -0,0 +1,195 @@
+/**
+ * @file sys_monitor.cpp
+ * @brief 系统监视实现
+ */
+#include "sys_monitor.h"
+
+#include "task_plan.h"
+
+#include <atomic>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+/**
+ * @brief 追加格式化文本，返回新的写入位置（缓冲区满时停在末尾）
+ */
+static size_t appendf(char *buf, size_t len, size_t pos, const char *fmt, ...)
+{
+  if (pos >= len)
+    return pos;
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf + pos, len - pos, fmt, args);
+  va_end(args);
+  if (n < 0)
+    return pos;
+  return pos + (size_t)n < len ? pos + (size_t)n : len - 1;
+}
+
+#if defined(ESP_PLATFORM)
+
+static TaskStatus_t s_tasks[SYS_MONITOR_MAX_TASKS];
+
+#if configGENERATE_RUN_TIME_STATS
+static TaskHandle_t idleTask(int core)
+{
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+  return xTaskGetIdleTaskHandleForCore(core);
+#else
+  return xTaskGetIdleTaskHandleForCPU(core);
+#endif
+}
+#endif
+
+size_t sysMonitorToJson(char *buf, size_t len)
+{
+  uint32_t total_runtime = 0;
+  UBaseType_t count = uxTaskGetSystemState(s_tasks, SYS_MONITOR_MAX_TASKS, &total_runtime);
+
+  size_t pos = appendf(buf, len, 0, "{\"t\":%lu,\"cpu\":[", (unsigned long)millis());
+
+#if configGENERATE_RUN_TIME_STATS
+  // 占用 = 1 - 空闲任务运行时间增量 / 总时间增量（每个核心各自计算）
+  static uint32_t last_total = 0;
+  static uint32_t last_idle[portNUM_PROCESSORS] = {};
+  uint32_t dt = total_runtime - last_total;
+  for (int core = 0; core < portNUM_PROCESSORS; core++)
+  {
+    uint32_t idle = 0;
+    for (UBaseType_t i = 0; i < count; i++)
+      if (s_tasks[i].xHandle == idleTask(core))
+        idle = s_tasks[i].ulRunTimeCounter;
+    uint32_t idle_dt = idle - last_idle[core];
+    last_idle[core] = idle;
+    unsigned load = dt && idle_dt < dt ? (unsigned)(100 - (uint64_t)idle_dt * 100 / dt) : 0;
+    pos = appendf(buf, len, pos, core ? ",%u" : "%u", load);
+  }
+  last_total = total_runtime;
+#endif
+
+  pos = appendf(buf, len, pos, "],\"heap\":{\"int\":[%u,%u,%u],\"psram\":[%u,%u],\"dma\":[%u,%u]},\"tasks\":[",
+                (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+                (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL),
+                (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL),
+                (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+                (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM),
+                (unsigned)heap_caps_get_free_size(MALLOC_CAP_DMA),
+                (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_DMA));
+
+  for (UBaseType_t i = 0; i < count; i++)
+  {
+    // ESP-IDF 中栈高水位单位为字节
+    pos = appendf(buf, len, pos, "%s[\"%s\",%u,%u]", i ? "," : "", s_tasks[i].pcTaskName,
+                  (unsigned)s_tasks[i].usStackHighWaterMark, (unsigned)s_tasks[i].uxCurrentPriority);
+  }
+  return appendf(buf, len, pos, "]}");
+}
+
+HeapSnapshot heapSnapshot()
+{
+  HeapSnapshot h;
+  h.free_bytes = (uint32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  h.min_free = (uint32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL);
+  h.largest_block = (uint32_t)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+  return h;
+}
+
+#endif
+
+//===========================================================
+// 最近一次采样（监视任务写，mon 命令读）
+//===========================================================
+// 顺序锁：写入期间序号为奇数，读取前后序号不同则重读；写入方只有监视任务
+static char s_last_json[SYS_MONITOR_JSON_SIZE];
+static std::atomic<uint32_t> s_last_seq{0};
+static std::atomic<bool> s_monitor_running{false};
+
+size_t sysMonitorLast(char *buf, size_t len)
+{
+  if (len == 0)
+    return 0;
+  // 监视任务未运行：调用者是唯一的采样方，直接采样
+  if (!s_monitor_running.load(std::memory_order_acquire))
+    return sysMonitorToJson(buf, len);
+
+  for (;;)
+  {
+    uint32_t seq = s_last_seq.load(std::memory_order_acquire);
+    if (seq & 1)
+    {
+      delay(1); // 监视任务优先级最低，同一核心上忙等会让它无法写完
+      continue;
+    }
+    size_t n = strnlen(s_last_json, sizeof(s_last_json) - 1);
+    n = n < len - 1 ? n : len - 1;
+    memcpy(buf, s_last_json, n);
+    buf[n] = 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s_last_seq.load(std::memory_order_relaxed) == seq)
+      return n;
+  }
+}
+
+#if defined(HOST_BUILD)
+
+bool sysMonitorStart(Print &out)
+{
+  // 主机构建没有可监视的任务与堆，不启动
+  (void)out;
+  return false;
+}
+
+#else
+
+static Print *s_monitor_out = nullptr;
+
+static void publishLast(const char *json, size_t n)
+{
+  uint32_t seq = s_last_seq.load(std::memory_order_relaxed);
+  s_last_seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(s_last_json, json, n + 1);
+  s_last_seq.store(seq + 2, std::memory_order_release);
+}
+
+static void monitorStep()
+{
+  static char json[SYS_MONITOR_JSON_SIZE];
+  size_t n = sysMonitorToJson(json, sizeof(json));
+  publishLast(json, n);
+  s_monitor_out->println(json);
+}
+
+bool sysMonitorStart(Print &out)
+{
+  if (taskSpec(TaskId::Monitor).period_ms == 0)
+    return false;
+  s_monitor_out = &out;
+  // 第一次输出之前 mon 返回启动时的一次采样（同时作为 CPU 占用的基准）
+  size_t n = sysMonitorToJson(s_last_json, sizeof(s_last_json));
+  s_last_json[n] = 0;
+  if (!taskStart(TaskId::Monitor, monitorStep))
+    return false;
+  s_monitor_running.store(true, std::memory_order_release);
+  return true;
+}
+
+#endif
+
+#if !defined(ESP_PLATFORM)
+
+// 主机构建：没有 FreeRTOS 任务与多个堆，只输出时间戳
+size_t sysMonitorToJson(char *buf, size_t len)
+{
+  return appendf(buf, len, 0, "{\"t\":%lu,\"cpu\":[],\"heap\":{},\"tasks\":[]}", (unsigned long)millis());
+}
+
+HeapSnapshot heapSnapshot() { return HeapSnapshot{0, 0, 0}; }
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file task_plan.cpp
+ * @brief 任务拓扑配置与启动
+ */
+#include "task_plan.h"
+
+#include "sys_monitor.h"
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+//===========================================================
+// 任务计划（唯一的配置位置）
+//===========================================================
+const TaskSpec TASK_PLAN[(size_t)TaskId::Count] = {
+    // 名称      栈      优先级 核心           周期
+    {"audio", 4096, 20, 1, 0},
+    {"storage", 6144, 10, 0, 0},
+    {"control", 0, 3, TASK_ANY_CORE, 0}, // Arduino loopTask，栈与核心由 Arduino 决定
+    {"log", 3072, 2, TASK_ANY_CORE, 20},
+    {"monitor", 3072, 1, TASK_ANY_CORE, SYS_MONITOR_PERIOD_MS},
+};
+
+namespace
+{
+  TaskStep s_steps[(size_t)TaskId::Count];
+#if AUDIO_TASKS
+  TaskHandle_t s_handles[(size_t)TaskId::Count];
+
+  void taskMain(void *arg)
+  {
+    TaskId id = (TaskId)(uintptr_t)arg;
+    const TaskSpec &spec = taskSpec(id);
+    TaskStep step = s_steps[(size_t)id];
+    TickType_t last_wake = xTaskGetTickCount();
+    for (;;)
+    {
+      step();
+      if (spec.period_ms)
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(spec.period_ms));
+    }
+  }
+#else
+  uint32_t s_last_run_ms[(size_t)TaskId::Count];
+
+  /** @brief 不创建任务时运行一次 step（周期任务按周期限速） */
+  void runStep(TaskId id)
+  {
+    TaskStep step = s_steps[(size_t)id];
+    if (!step)
+      return;
+    uint32_t period = taskSpec(id).period_ms;
+    if (period)
+    {
+      uint32_t now = millis();
+      if (now - s_last_run_ms[(size_t)id] < period)
+        return;
+      s_last_run_ms[(size_t)id] = now;
+    }
+    step();
+  }
+#endif
+}
+
+bool taskStart(TaskId id, TaskStep step)
+{
+  const TaskSpec &spec = taskSpec(id);
+  s_steps[(size_t)id] = step;
+
+#if AUDIO_TASKS
+  if (id == TaskId::Control)
+  {
+    vTaskPrioritySet(nullptr, spec.priority);
+    s_handles[(size_t)id] = xTaskGetCurrentTaskHandle();
+    return true;
+  }
+  BaseType_t core = spec.core == TASK_ANY_CORE ? tskNO_AFFINITY : spec.core;
+  return xTaskCreatePinnedToCore(taskMain, spec.name, spec.stack_bytes, (void *)(uintptr_t)id, spec.priority,
+                                 &s_handles[(size_t)id], core) == pdPASS;
+#else
+  (void)spec;
+  s_last_run_ms[(size_t)id] = millis();
+  return true;
+#endif
+}
+
+void taskSleep(TaskId self, uint32_t timeout_ms)
+{
+#if AUDIO_TASKS
+  (void)self;
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+#else
+  (void)self;
+  (void)timeout_ms;
+#endif
+}
+
+void taskWake(TaskId id)
+{
+#if AUDIO_TASKS
+  TaskHandle_t handle = s_handles[(size_t)id];
+  if (handle)
+    xTaskNotifyGive(handle);
+#else
+  (void)id;
+#endif
+}
+
+void taskWaitOn(TaskId self, TaskId other)
+{
+#if AUDIO_TASKS
+  (void)self;
+  (void)other;
+  ulTaskNotifyTake(pdTRUE, 1);
+#else
+  (void)self;
+  runStep(other);
+#endif
+}
+
+void taskWait(uint32_t ms)
+{
+#if AUDIO_TASKS
+  vTaskDelay(pdMS_TO_TICKS(ms));
+#else
+  (void)ms;
+  for (size_t i = 0; i < (size_t)TaskId::Count; i++)
+    if ((TaskId)i != TaskId::Control)
+      runStep((TaskId)i);
+#endif
+}
+
+void taskIdle(uint32_t timeout_ms)
+{
+#if AUDIO_TASKS
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+#else
+  taskWait(timeout_ms);
+#endif
+}
@@ -0,0 +1,147 @@
+/**
+ * @file wav_header.cpp
+ * @brief WAV 头有界解析
+ */
+#include "wav_header.h"
+
+#include <string.h>
+
+static inline uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t rd32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief 检查 fmt 块内容
+ */
+static WavError parseFmt(const uint8_t *p, uint32_t size, WavFormat &out)
+{
+  // PCM 为 16 字节，带 cbSize 为 18 字节，WAVE_FORMAT_EXTENSIBLE 为 40 字节
+  if (size < 16 || size > 40)
+    return WavError::BadFmt;
+
+  uint16_t format = rd16(p);
+  if (format == 0xFFFE)
+  {
+    // EXTENSIBLE：子格式 GUID 的前两个字节为实际编码
+    if (size < 40)
+      return WavError::BadFmt;
+    format = rd16(p + 24);
+  }
+  if (format != 1)
+    return WavError::Unsupported;
+
+  out.channels = rd16(p + 2);
+  out.sample_rate = rd32(p + 4);
+  out.block_align = rd16(p + 12);
+  out.bits_per_sample = rd16(p + 14);
+
+  if (out.channels < 1 || out.channels > 8)
+    return WavError::Unsupported;
+  if (out.bits_per_sample != 8 && out.bits_per_sample != 16 && out.bits_per_sample != 24 && out.bits_per_sample != 32)
+    return WavError::Unsupported;
+  if (out.sample_rate < 8000 || out.sample_rate > 192000)
+    return WavError::Unsupported;
+
+  // 块对齐至少容纳一帧；24bit 允许按 4 字节存储
+  uint32_t min_align = (uint32_t)out.channels * (out.bits_per_sample / 8);
+  if (out.block_align < min_align || out.block_align > (uint32_t)out.channels * 4)
+    return WavError::BadFmt;
+  return WavError::None;
+}
+
+WavError parseWavHeader(const uint8_t *buf, size_t len, size_t file_size, WavFormat &out)
+{
+  if (len < 12)
+    return WavError::NotRiff;
+  if (memcmp(buf, "RIFF", 4) != 0)
+    return WavError::NotRiff;
+  if (memcmp(buf + 8, "WAVE", 4) != 0)
+    return WavError::NotWave;
+
+  bool has_fmt = false;
+  size_t pos = 12;
+  while (pos + 8 <= len)
+  {
+    const uint8_t *chunk = buf + pos;
+    uint32_t size = rd32(chunk + 4);
+    uint64_t body = (uint64_t)pos + 8;
+
+    if (memcmp(chunk, "data", 4) == 0)
+    {
+      if (!has_fmt)
+        return WavError::NoFmt;
+      if (body > file_size)
+        return WavError::Truncated;
+      // 录音时长度可能未回填（占位值），按文件实际大小截断
+      uint64_t avail = file_size - body;
+      out.data_offset = (uint32_t)body;
+      out.data_length = (uint32_t)(size < avail ? size : avail);
+      return WavError::None;
+    }
+
+    uint64_t next = body + size + (size & 1);
+    if (next > file_size)
+      return WavError::BadChunk;
+
+    if (memcmp(chunk, "fmt ", 4) == 0)
+    {
+      if (has_fmt || body + size > len)
+        return WavError::BadFmt;
+      WavError err = parseFmt(buf + body, size, out);
+      if (err != WavError::None)
+        return err;
+      has_fmt = true;
+    }
+
+    if (next > len)
+      break; // 下一个块超出检查范围
+    pos = (size_t)next;
+  }
+  return WavError::NoData;
+}
+
+WavError probeWavFile(fs::File &file, WavFormat &out)
+{
+  uint8_t buf[WAV_PROBE_HEADER_SIZE];
+  size_t file_size = file.size();
+
+  if (!file.seek(0))
+    return WavError::Io;
+  size_t want = file_size < sizeof(buf) ? file_size : sizeof(buf);
+  size_t len = file.read(buf, want);
+  file.seek(0);
+  if (len != want)
+    return WavError::Io;
+
+  return parseWavHeader(buf, len, file_size, out);
+}
+
+const char *wavErrorName(WavError err)
+{
+  switch (err)
+  {
+  case WavError::None:
+    return "ok";
+  case WavError::Io:
+    return "io";
+  case WavError::NotRiff:
+    return "not RIFF";
+  case WavError::NotWave:
+    return "not WAVE";
+  case WavError::BadChunk:
+    return "chunk out of range";
+  case WavError::NoFmt:
+    return "missing fmt";
+  case WavError::BadFmt:
+    return "bad fmt";
+  case WavError::Unsupported:
+    return "unsupported format";
+  case WavError::NoData:
+    return "missing data";
+  case WavError::Truncated:
+    return "truncated";
+  }
+  return "?";
+}
@@ -0,0 +1,244 @@
+/**
+ * @file test_main.cpp
+ * @brief 命令状态机：stop 之前排队的命令被丢弃，之后（含 stop 计数回绕）的命令保留并按顺序执行；
+ *        播放 44.1 kHz 16 位文件之后录音，I2S 恢复录音格式，WAV 头与采集格式一致；
+ *        ES8311 不可用时软件音量与 DAC 寄存器使用同一 dB 曲线
+ *
+ * 状态输出写入字符串后检查；录音 / 播放使用模拟 I2S 与 SD（test_audio_control_sd 目录）。
+ *
+ * 运行：pio test -e native -f test_audio_control
+ */
+#include <unity.h>
+
+#include "audio_control.h"
+#include "audio_format.h"
+#include "audio_stats.h"
+#include "audio_tasks.h"
+#include "es8311_controls.h"
+#include "wav_header.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+  /**
+   * @brief 记录状态输出；armed 时在输出 "stop" 后立即再发送 stop 与 stats，
+   *        模拟其他任务在 audioControlStep() 读取 stop 计数之后、取出命令之前发送命令
+   */
+  class CapturePrint : public Print
+  {
+  public:
+    using Print::write;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      text.append((const char *)data, len);
+      if (armed && text.size() >= 5 && text.compare(text.size() - 5, 5, "stop\n") == 0)
+      {
+        armed = false;
+        postStop();
+        postStats();
+      }
+      return len;
+    }
+
+    static void postStop()
+    {
+      AudioCommand cmd{};
+      cmd.type = AudioCommandType::Stop;
+      audioCommandPost(cmd);
+    }
+
+    static void postStats()
+    {
+      AudioCommand cmd{};
+      cmd.type = AudioCommandType::Stats;
+      audioCommandPost(cmd);
+    }
+
+    size_t count(const char *s) const
+    {
+      size_t n = 0;
+      for (size_t pos = text.find(s); pos != std::string::npos; pos = text.find(s, pos + 1))
+        n++;
+      return n;
+    }
+
+    std::string text;
+    bool armed = false;
+  };
+
+  CapturePrint s_out;
+
+  // 与 main.cpp 相同的对象组合（ES8311 未启动：音量走软件路径）
+  I2SCodecStream s_i2s(nullptr);
+  StatsOutputStream s_i2s_out(s_i2s);
+  BlockTxStream s_tx(s_i2s_out);
+  WAVDecoder s_decoder;
+  AudioSourceSD s_source("/", ".wav");
+  AudioPlayer s_player(s_source, s_tx, s_decoder);
+  BlockFanout s_fanout;
+  WAVEncoder s_encoder;
+  LevelMeterSink s_level(RecordFormat::bytes_per_sample);
+
+  /** @brief 执行命令行并运行 control / audio / storage 直到回到空闲 */
+  void runCommand(const char *line)
+  {
+    AudioCommand cmd{};
+    TEST_ASSERT_TRUE(audioCommandParse(line, cmd));
+    TEST_ASSERT_TRUE(audioCommandPost(cmd));
+    for (int i = 0; i < 100000 && !(audioControlIdle() && !audioBusy()); i++)
+    {
+      audioControlStep();
+      taskWait(0);
+    }
+    TEST_ASSERT_TRUE(audioControlIdle());
+  }
+
+  void writeLe(std::vector<uint8_t> &out, uint32_t v, int bytes)
+  {
+    for (int i = 0; i < bytes; i++)
+      out.push_back((uint8_t)(v >> (8 * i)));
+  }
+
+  /** @brief 44.1 kHz 立体声 16 位 PCM WAV（0.1 秒静音） */
+  void writeCdWav(const std::string &path)
+  {
+    const uint32_t data_len = 4410 * 4;
+    std::vector<uint8_t> w = {'R', 'I', 'F', 'F'};
+    writeLe(w, data_len + 36, 4);
+    w.insert(w.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    writeLe(w, 16, 4);
+    writeLe(w, 1, 2); // PCM
+    writeLe(w, 2, 2);
+    writeLe(w, 44100, 4);
+    writeLe(w, 44100 * 4, 4);
+    writeLe(w, 4, 2);
+    writeLe(w, 16, 2);
+    w.insert(w.end(), {'d', 'a', 't', 'a'});
+    writeLe(w, data_len, 4);
+    w.resize(w.size() + data_len, 0);
+    FILE *f = fopen(path.c_str(), "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fwrite(w.data(), 1, w.size(), f);
+    fclose(f);
+  }
+
+  void test_stats_executes_when_idle()
+  {
+    CapturePrint::postStats();
+    audioControlStep();
+    TEST_ASSERT_EQUAL_UINT32(1, s_out.count("[ctl] state idle"));
+    TEST_ASSERT_TRUE(audioControlIdle());
+  }
+
+  void test_command_queued_before_stop_is_dropped()
+  {
+    CapturePrint::postStats();
+    CapturePrint::postStop();
+    audioControlStep();
+    TEST_ASSERT_EQUAL_UINT32(1, s_out.count("stop\n"));
+    TEST_ASSERT_EQUAL_UINT32(1, s_out.count("丢弃排队的命令 stats"));
+    TEST_ASSERT_EQUAL_UINT32(0, s_out.count("[ctl]"));
+    TEST_ASSERT_TRUE(audioControlIdle());
+  }
+
+  void test_command_after_newer_stop_waits_for_it()
+  {
+    // stop 计数推到回绕前一步，下面的 stop 使计数从 0xFFFF 回绕到 0
+    for (uint32_t i = 0; i < 0xFFFF; i++)
+      CapturePrint::postStop();
+    audioControlStep();
+    s_out.text.clear();
+
+    CapturePrint::postStop();
+    s_out.armed = true;
+    audioControlStep(); // 执行第一个 stop；期间又来了 stop 与 stats（stats 比本步已执行的 stop 新）
+    TEST_ASSERT_EQUAL_UINT32(0, s_out.count("丢弃"));
+    TEST_ASSERT_EQUAL_UINT32(0, s_out.count("[ctl]"));
+    TEST_ASSERT_FALSE(audioControlIdle()); // 留在 pending
+
+    audioControlStep(); // 先执行第二个 stop，再执行 stats
+    TEST_ASSERT_EQUAL_UINT32(2, s_out.count("stop\n"));
+    TEST_ASSERT_EQUAL_UINT32(0, s_out.count("丢弃"));
+    TEST_ASSERT_EQUAL_UINT32(1, s_out.count("[ctl] state idle"));
+    TEST_ASSERT_TRUE(s_out.text.rfind("stop\n") < s_out.text.find("[ctl]"));
+    TEST_ASSERT_TRUE(audioControlIdle());
+  }
+
+  void test_software_volume_follows_codec_db_curve()
+  {
+    // 0.55 → 寄存器 140 → -25.5 dB（硬件路径写入的值），软件路径应得到同样的衰减
+    TEST_ASSERT_FALSE(audioSetOutputVolume(0.55f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, powf(10.0f, es8311VolumeDb(140) / 20.0f), s_player.volume());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4, 0.0531, s_player.volume());
+    TEST_ASSERT_FALSE(audioSetOutputVolume(1.0f)); // +32 dB：软件不放大
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1.0, s_player.volume());
+  }
+
+  void test_record_after_play_restores_record_format()
+  {
+    writeCdWav(host::env().sd_root + "/cd.wav");
+    runCommand("play /cd.wav");
+    TEST_ASSERT_EQUAL_UINT32(1, s_out.count("播放完成"));
+    TEST_ASSERT_EQUAL_INT(44100, s_i2s.audioInfo().sample_rate); // 播放器按文件格式设置了 I2S
+    TEST_ASSERT_EQUAL_INT(16, s_i2s.audioInfo().bits_per_sample);
+
+    runCommand("record 1");
+    TEST_ASSERT_EQUAL_UINT32(1, s_out.count("录音完成"));
+    TEST_ASSERT_TRUE(s_i2s.audioInfo() == RecordFormat::info());
+
+    File rec = SD.open("/rec.wav");
+    uint8_t h[44];
+    TEST_ASSERT_EQUAL_UINT32(sizeof(h), rec.read(h, sizeof(h)));
+    WavFormat fmt{};
+    TEST_ASSERT_TRUE(parseWavHeader(h, sizeof(h), rec.size(), fmt) == WavError::None);
+    rec.close();
+    TEST_ASSERT_EQUAL_UINT32(RecordFormat::sample_rate, fmt.sample_rate);
+    TEST_ASSERT_EQUAL_UINT32(RecordFormat::channels, fmt.channels);
+    TEST_ASSERT_EQUAL_UINT32(RecordFormat::bits_per_sample, fmt.bits_per_sample);
+    TEST_ASSERT_EQUAL_UINT32(RecordFormat::bytes(1), fmt.data_length);
+  }
+}
+
+void setUp() { s_out.text.clear(); }
+void tearDown() {}
+
+int main(int, char **)
+{
+  host::Env &e = host::env();
+  e.sd_root = "test_audio_control_sd";
+  e.i2s_rx_path.clear(); // 合成正弦波
+  e.i2s_tx_path.clear();
+  std::filesystem::create_directories(e.sd_root);
+
+  I2SCodecConfig cfg = s_i2s.defaultConfig(RXTX_MODE);
+  cfg.copyFrom(RecordFormat::info());
+  s_i2s.begin(cfg);
+  s_player.begin(0, false);
+  audioTasksBegin(s_i2s, s_i2s_out, s_player, s_fanout, s_tx);
+  s_fanout.add(s_level);
+
+  AudioControlConfig config{};
+  config.record_fs = &SD;
+  config.play_fs = &SD;
+  config.record_path = "/rec.wav";
+  config.encoder = &s_encoder;
+  config.info = RecordFormat::info();
+  config.i2s = &s_i2s;
+  config.record_seconds = 1;
+  config.player = &s_player;
+  config.level = &s_level;
+  config.out = &s_out;
+  audioControlBegin(config);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_stats_executes_when_idle);
+  RUN_TEST(test_command_queued_before_stop_is_dropped);
+  RUN_TEST(test_command_after_newer_stop_waits_for_it);
+  RUN_TEST(test_software_volume_follows_codec_db_curve);
+  RUN_TEST(test_record_after_play_restores_record_format);
+  return UNITY_END();
+}
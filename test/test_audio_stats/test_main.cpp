@@ -0,0 +1,143 @@
+/**
+ * @file test_main.cpp
+ * @brief 流水线统计：延迟直方图分位、I2S 读写计数与溢出 / 欠载判断、SD 写入包装、JSON 输出
+ *
+ * 运行：pio test -e native -f test_audio_stats（micros() 为主机虚拟时钟）
+ */
+#include <unity.h>
+
+#include "audio_stats.h"
+#include "host_env.h"
+
+namespace
+{
+  /** @brief 只接受一半数据的输出（模拟 SD 写入不完整） */
+  class HalfPrint : public Print
+  {
+  public:
+    using Print::write;
+    size_t write(uint8_t) override { return 1; }
+    size_t write(const uint8_t *, size_t len) override { return len / 2; }
+  };
+
+  const AudioInfo kInfo(16000, 1, 32); // 64000 字节/秒
+
+  void test_histogram_empty_and_small_values()
+  {
+    LatencyHistogram &h = g_audio_stats.sd_write_latency;
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentile(50));
+    h.record(0);
+    h.record(1);
+    h.record(3);
+    TEST_ASSERT_EQUAL_UINT32(3, h.count.load());
+    TEST_ASSERT_EQUAL_UINT32(1, h.percentile(50)); // 小于子桶数的值精确记录
+    TEST_ASSERT_EQUAL_UINT32(3, h.percentile(100));
+  }
+
+  void test_histogram_percentiles_within_bucket_precision()
+  {
+    LatencyHistogram &h = g_audio_stats.sd_write_latency;
+    for (uint32_t us = 1; us <= 1000; us++)
+      h.record(us);
+    uint32_t p50 = h.percentile(50);
+    uint32_t p99 = h.percentile(99);
+    TEST_ASSERT_TRUE(p50 >= 500 && p50 <= 500 * 1.25);
+    TEST_ASSERT_TRUE(p99 >= 990 && p99 <= 1000);    // 桶上界不超过最大值
+    TEST_ASSERT_EQUAL_UINT32(1000, h.percentile(100));
+    TEST_ASSERT_EQUAL_UINT32(1000, h.max_us.load());
+
+    h.record(0xFFFFFFFFu); // 最大的桶
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFFu, h.percentile(100));
+  }
+
+  void test_i2s_read_counts_short_reads_and_overruns()
+  {
+    audioStatsSetDmaBudget(kInfo, 6, 512); // 3072 字节 = 48 ms
+    TEST_ASSERT_EQUAL_UINT32(48000, g_audio_stats.dma_budget_us.load());
+
+    host::advanceMicros(1);
+    statI2SRead(512, 512); // 第一次读取只建立基准
+    host::advanceMicros(8000);
+    statI2SRead(512, 256);
+    TEST_ASSERT_EQUAL_UINT32(768, g_audio_stats.i2s_rx_bytes.load());
+    TEST_ASSERT_EQUAL_UINT32(1, g_audio_stats.short_reads.load());
+    TEST_ASSERT_EQUAL_UINT32(0, g_audio_stats.overruns.load());
+
+    host::advanceMicros(50000);
+    statI2SRead(512, 512);
+    TEST_ASSERT_EQUAL_UINT32(1, g_audio_stats.overruns.load());
+    TEST_ASSERT_EQUAL_UINT32(50000, g_audio_stats.rx_gap_max_us.load());
+    TEST_ASSERT_EQUAL_UINT32(2, g_audio_stats.rx_jitter.count.load());
+
+    // 新一段录音：段间空闲不算溢出
+    statI2SRestart();
+    host::advanceMicros(1000000);
+    statI2SRead(512, 512);
+    TEST_ASSERT_EQUAL_UINT32(1, g_audio_stats.overruns.load());
+  }
+
+  void test_i2s_write_counts_underruns_and_block_max()
+  {
+    audioStatsSetDmaBudget(kInfo, 6, 512);
+    host::advanceMicros(1);
+    statI2SWrite(512);
+    host::advanceMicros(8000);
+    statI2SWrite(1024);
+    TEST_ASSERT_EQUAL_UINT32(1536, g_audio_stats.i2s_tx_bytes.load());
+    TEST_ASSERT_EQUAL_UINT32(1024, g_audio_stats.tx_block_max.load());
+    TEST_ASSERT_EQUAL_UINT32(0, g_audio_stats.underruns.load());
+    host::advanceMicros(48001);
+    statI2SWrite(512);
+    TEST_ASSERT_EQUAL_UINT32(1, g_audio_stats.underruns.load());
+  }
+
+  void test_file_sink_counts_writes_and_short_writes()
+  {
+    HalfPrint half;
+    StatsFileSink sink(half);
+    uint8_t data[100] = {};
+    TEST_ASSERT_EQUAL_UINT32(50, sink.write(data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT32(1, g_audio_stats.sd_writes.load());
+    TEST_ASSERT_EQUAL_UINT32(50, g_audio_stats.sd_write_bytes.load());
+    TEST_ASSERT_EQUAL_UINT32(1, g_audio_stats.sd_short_writes.load());
+    TEST_ASSERT_EQUAL_UINT32(1, g_audio_stats.sd_write_latency.count.load());
+  }
+
+  void test_json_contains_counters_and_truncates()
+  {
+    statAdd(g_audio_stats.encoder_bytes, 4096);
+    statAdd(g_audio_stats.overruns, 2);
+    char json[640];
+    size_t n = audioStatsToJson(json, sizeof(json));
+    TEST_ASSERT_EQUAL_UINT32(strlen(json), n);
+    TEST_ASSERT_EQUAL('{', json[0]);
+    TEST_ASSERT_EQUAL('}', json[n - 1]);
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"encoder\":{\"bytes\":4096}"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"overruns\":2,"));
+
+    char small[16];
+    TEST_ASSERT_EQUAL_UINT32(sizeof(small) - 1, audioStatsToJson(small, sizeof(small)));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(small) - 1, strlen(small));
+  }
+}
+
+void setUp()
+{
+  audioStatsReset();
+  g_audio_stats.dma_budget_us.store(0);
+  g_audio_stats.byte_rate.store(0);
+}
+
+void tearDown() {}
+
+int main(int, char **)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_histogram_empty_and_small_values);
+  RUN_TEST(test_histogram_percentiles_within_bucket_precision);
+  RUN_TEST(test_i2s_read_counts_short_reads_and_overruns);
+  RUN_TEST(test_i2s_write_counts_underruns_and_block_max);
+  RUN_TEST(test_file_sink_counts_writes_and_short_writes);
+  RUN_TEST(test_json_contains_counters_and_truncates);
+  return UNITY_END();
+}
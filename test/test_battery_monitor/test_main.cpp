@@ -0,0 +1,107 @@
+/**
+ * @file test_main.cpp
+ * @brief 电池监视：电量映射、IIR 平均、区间滞回
+ *
+ *  - 电量映射：刻度两端截断、中点、单调
+ *  - IIR：第一个样本为初值，阶跃后按 1 - (1 - 2^-SHIFT)^n 收敛，稳态无误差，噪声峰峰值减半
+ *  - 区间：在阈值附近抖动的输入不会反复切换（只在下降与越过滞回时切换）
+ *
+ * 运行：pio test -e native -f test_battery_monitor
+ */
+#include <unity.h>
+
+#include "battery_monitor.h"
+
+#include <cmath>
+
+namespace
+{
+  void test_level_clamps_at_both_ends()
+  {
+    TEST_ASSERT_EQUAL_UINT8(0, batteryLevel(0));
+    TEST_ASSERT_EQUAL_UINT8(0, batteryLevel(BATTERY_EMPTY_MV));
+    TEST_ASSERT_EQUAL_UINT8(255, batteryLevel(BATTERY_FULL_MV));
+    TEST_ASSERT_EQUAL_UINT8(255, batteryLevel(5000));
+  }
+
+  void test_level_midpoint_and_monotonic()
+  {
+    TEST_ASSERT_EQUAL_UINT8(127, batteryLevel((BATTERY_EMPTY_MV + BATTERY_FULL_MV) / 2));
+    for (uint32_t mv = BATTERY_EMPTY_MV; mv < BATTERY_FULL_MV; mv++)
+      TEST_ASSERT_TRUE(batteryLevel(mv) <= batteryLevel(mv + 1));
+  }
+
+  void test_iir_primes_and_follows_step()
+  {
+    BatteryFilter f;
+    TEST_ASSERT_EQUAL_UINT32(3900, f.update(3900));
+    double expected = 3900;
+    for (int n = 1; n <= 8; n++)
+    {
+      uint32_t y = f.update(3500);
+      expected += (3500 - expected) / (1 << BATTERY_IIR_SHIFT);
+      TEST_ASSERT_FLOAT_WITHIN(1.0, expected, y);
+    }
+    for (int n = 0; n < 200; n++)
+      f.update(3500);
+    TEST_ASSERT_EQUAL_UINT32(3500, f.millivolts());
+  }
+
+  void test_iir_halves_noise()
+  {
+    BatteryFilter noisy;
+    uint32_t seed = 1;
+    uint32_t lo = 0xFFFFFFFF, hi = 0;
+    for (int n = 0; n < 1000; n++)
+    {
+      seed = seed * 1103515245 + 12345;
+      uint32_t y = noisy.update(3800 + (seed >> 16) % 101 - 50); // ±50 mV 噪声
+      if (n >= 100)
+      {
+        lo = y < lo ? y : lo;
+        hi = y > hi ? y : hi;
+      }
+    }
+    TEST_ASSERT_LESS_THAN_UINT32(50, hi - lo); // 原始峰峰值 100 mV
+  }
+
+  void test_zone_thresholds_and_hysteresis()
+  {
+    TEST_ASSERT_TRUE(batteryZone(255, BatteryZone::Ok) == BatteryZone::Ok);
+    TEST_ASSERT_TRUE(batteryZone(BATTERY_HALF_LEVEL, BatteryZone::Ok) == BatteryZone::Half);
+    TEST_ASSERT_TRUE(batteryZone(BATTERY_WARNING_LEVEL, BatteryZone::Half) == BatteryZone::Low);
+    TEST_ASSERT_TRUE(batteryZone(BATTERY_WARNING_LEVEL, BatteryZone::Ok) == BatteryZone::Low); // 大幅下降直接到 low
+    TEST_ASSERT_TRUE(batteryZone(BATTERY_HALF_LEVEL + BATTERY_HYSTERESIS, BatteryZone::Half) == BatteryZone::Half);
+    TEST_ASSERT_TRUE(batteryZone(BATTERY_HALF_LEVEL + BATTERY_HYSTERESIS + 1, BatteryZone::Half) == BatteryZone::Ok);
+    TEST_ASSERT_TRUE(batteryZone(255, BatteryZone::Low) == BatteryZone::Ok); // 充电后恢复
+  }
+
+  void test_zone_chatter_switches_once()
+  {
+    BatteryZone zone = BatteryZone::Ok;
+    int changes = 0;
+    for (int n = 0; n < 1000; n++)
+    {
+      uint8_t level = (uint8_t)(BATTERY_HALF_LEVEL + (n % 2 ? 3 : -3)); // 在阈值两侧抖动
+      BatteryZone next = batteryZone(level, zone);
+      changes += next != zone;
+      zone = next;
+    }
+    TEST_ASSERT_EQUAL_INT(1, changes);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_level_clamps_at_both_ends);
+  RUN_TEST(test_level_midpoint_and_monotonic);
+  RUN_TEST(test_iir_primes_and_follows_step);
+  RUN_TEST(test_iir_halves_noise);
+  RUN_TEST(test_zone_thresholds_and_hysteresis);
+  RUN_TEST(test_zone_chatter_switches_once);
+  return UNITY_END();
+}
@@ -0,0 +1,215 @@
+/**
+ * @file test_main.cpp
+ * @brief 块池（block_pool.h）：耗尽与计数、引用计数、两级选择，多线程下的 Treiber 栈与 16 位版本号
+ *
+ * 多线程部分让多个线程在很小的池上反复获取 / 释放（CAS 竞争最激烈，版本号多次回绕）；
+ * 持有期间写入线程独有的内容，释放前检查没有被其他线程同时持有，最后所有块都回到空闲链表。
+ *
+ * 运行：pio test -e native -f test_block_pool
+ * ThreadSanitizer：pio test -e native_tsan -f test_block_pool
+ */
+#include <unity.h>
+
+#include "block_pool.h"
+
+#include <thread>
+#include <vector>
+
+// 多线程部分每个线程的获取次数
+#ifndef POOL_TEST_ITERATIONS
+#define POOL_TEST_ITERATIONS 2000000
+#endif
+
+namespace
+{
+  /** @brief 获取全部块后应耗尽，再全部归还 */
+  template <class Pool>
+  void checkAllFree(Pool &pool)
+  {
+    std::vector<AudioBlock *> held;
+    while (AudioBlock *b = pool.acquire())
+      held.push_back(b);
+    TEST_ASSERT_EQUAL_UINT32(pool.count(), held.size());
+    for (size_t i = 0; i < held.size(); i++)
+      for (size_t j = i + 1; j < held.size(); j++)
+        TEST_ASSERT_TRUE(held[i] != held[j]);
+    for (AudioBlock *b : held)
+      releaseAudioBlock(b);
+    TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+  }
+
+  //===========================================================
+  // 单线程
+  //===========================================================
+  void test_exhaustion_and_counters()
+  {
+    StaticBlockPool<64, 4> pool;
+    AudioBlock *b[4];
+    for (int i = 0; i < 4; i++)
+    {
+      b[i] = pool.acquire();
+      TEST_ASSERT_NOT_NULL(b[i]);
+      TEST_ASSERT_EQUAL_UINT32(64, b[i]->capacity);
+      TEST_ASSERT_EQUAL_UINT32(0, b[i]->length);
+      TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)b[i]->data % 4);
+    }
+    TEST_ASSERT_NULL(pool.acquire());
+    TEST_ASSERT_EQUAL_UINT32(1, pool.exhausted());
+    TEST_ASSERT_EQUAL_UINT32(4, pool.peakInUse());
+    for (AudioBlock *x : b)
+      releaseAudioBlock(x);
+    TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+    TEST_ASSERT_EQUAL_UINT32(4, pool.acquired());
+    checkAllFree(pool);
+  }
+
+  void test_last_reference_returns_block()
+  {
+    StaticBlockPool<64, 2> pool;
+    AudioBlock *b = pool.acquire();
+    retainAudioBlock(b, 2); // 三个持有者
+    releaseAudioBlock(b);
+    releaseAudioBlock(b);
+    TEST_ASSERT_EQUAL_UINT32(1, pool.inUse());
+    releaseAudioBlock(b);
+    TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+  }
+
+  void test_version_tag_wraps()
+  {
+    // 每次获取 / 释放版本号各加一，远超 16 位后链表仍然完整
+    StaticBlockPool<64, 3> pool;
+    for (uint32_t i = 0; i < 0x30000; i++)
+    {
+      AudioBlock *a = pool.acquire();
+      AudioBlock *b = pool.acquire();
+      releaseAudioBlock(a);
+      releaseAudioBlock(b);
+    }
+    checkAllFree(pool);
+  }
+
+  void test_tier_selection()
+  {
+    TEST_ASSERT_TRUE(psramBlockPoolBegin(4096, 2));
+    AudioBlock *small = acquireAudioBlock(AUDIO_DMA_BLOCK_SIZE);
+    AudioBlock *large = acquireAudioBlock(AUDIO_DMA_BLOCK_SIZE + 1);
+    TEST_ASSERT_TRUE(small->pool == &g_dma_blocks);
+    TEST_ASSERT_TRUE(large->pool == &g_psram_blocks);
+    TEST_ASSERT_NULL(acquireAudioBlock(4097)); // 超过最大块
+    releaseAudioBlock(small);
+    releaseAudioBlock(large);
+  }
+
+  //===========================================================
+  // 多线程
+  //===========================================================
+  void test_threads_never_share_a_block()
+  {
+    // 3 个块、4 个线程：线程在读取链表头与 CAS 之间被抢占时，其他线程已经把同一块取走再放回（ABA）
+    static StaticBlockPool<64, 3> pool;
+    static std::atomic<uint32_t> owner[3];
+    const uint32_t kThreads = 4;
+    std::vector<uint32_t> errors(kThreads, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < kThreads; t++)
+    {
+      threads.emplace_back(
+          [&, t]
+          {
+            AudioBlock *held[2] = {};
+            for (uint32_t i = 0; i < POOL_TEST_ITERATIONS; i++)
+            {
+              // 每个线程最多持有两块，池经常耗尽
+              AudioBlock *&slot = held[i & 1];
+              if (slot)
+              {
+                if (*(uint32_t *)slot->data != t)
+                  errors[t]++;
+                owner[slot->index].store(0, std::memory_order_relaxed);
+                releaseAudioBlock(slot);
+              }
+              slot = pool.acquire();
+              if (!slot)
+                continue;
+              // 同一块同时只能有一个持有者
+              if (owner[slot->index].exchange(t + 1, std::memory_order_relaxed) != 0)
+                errors[t]++;
+              *(uint32_t *)slot->data = t;
+            }
+            for (AudioBlock *b : held)
+              if (b)
+              {
+                owner[b->index].store(0, std::memory_order_relaxed);
+                releaseAudioBlock(b);
+              }
+          });
+    }
+    for (std::thread &th : threads)
+      th.join();
+
+    for (uint32_t t = 0; t < kThreads; t++)
+      TEST_ASSERT_EQUAL_UINT32(0, errors[t]);
+    TEST_ASSERT_EQUAL_UINT32(0, pool.inUse());
+    TEST_ASSERT_EQUAL_UINT32(kThreads * POOL_TEST_ITERATIONS, pool.acquired() + pool.exhausted());
+    checkAllFree(pool);
+  }
+
+  void test_cross_thread_release()
+  {
+    // 生产者获取、消费者释放（录音的 audio → storage 方向）
+    static StaticBlockPool<64, 8> pool;
+    std::atomic<AudioBlock *> mailbox[8] = {};
+    std::atomic<bool> done{false};
+    uint32_t bad = 0;
+    std::thread consumer(
+        [&]
+        {
+          uint32_t expect = 0;
+          while (!done.load(std::memory_order_acquire) || expect < POOL_TEST_ITERATIONS)
+          {
+            AudioBlock *b = mailbox[expect & 7].exchange(nullptr, std::memory_order_acquire);
+            if (!b)
+            {
+              std::this_thread::yield();
+              continue;
+            }
+            if (*(uint32_t *)b->data != expect)
+              bad++;
+            expect++;
+            releaseAudioBlock(b);
+          }
+        });
+    for (uint32_t i = 0; i < POOL_TEST_ITERATIONS; i++)
+    {
+      AudioBlock *b;
+      while (!(b = pool.acquire()) || mailbox[i & 7].load(std::memory_order_acquire))
+      {
+        if (b)
+          releaseAudioBlock(b);
+        std::this_thread::yield();
+      }
+      *(uint32_t *)b->data = i;
+      mailbox[i & 7].store(b, std::memory_order_release);
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    TEST_ASSERT_EQUAL_UINT32(0, bad);
+    checkAllFree(pool);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_exhaustion_and_counters);
+  RUN_TEST(test_last_reference_returns_block);
+  RUN_TEST(test_version_tag_wraps);
+  RUN_TEST(test_tier_selection);
+  RUN_TEST(test_threads_never_share_a_block);
+  RUN_TEST(test_cross_thread_release);
+  return UNITY_END();
+}
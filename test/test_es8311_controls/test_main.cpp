@@ -0,0 +1,123 @@
+/**
+ * @file test_main.cpp
+ * @brief ES8311 硬件处理（es8311_controls.h）与录音增益 / 高通的硬件优先、软件退回
+ *
+ * 模拟 I2C 总线上挂载 ES8311 寄存器模型，检查写入的寄存器值与事务数；
+ * 寄存器缓存未就绪时所有接口返回 false，audioSetInput*() 退回软件处理。
+ * 寄存器在缓存之外被改写（invalidate）后，下一次调整先读回芯片，不覆盖其他位。
+ *
+ * 运行：pio test -e native -f test_es8311_controls
+ */
+#include <unity.h>
+
+#include "AudioBoard.h"
+#include "audio_tasks.h"
+#include "es8311_controls.h"
+
+namespace
+{
+  TwoWire s_wire(1);
+  host::I2CRegisterDevice *s_dev = nullptr;
+
+  void test_volume_register_mapping()
+  {
+    TEST_ASSERT_EQUAL_HEX8(ES8311_VOLUME_0DB, es8311VolumeReg(0.0f));
+    TEST_ASSERT_EQUAL_HEX8(0x00, es8311VolumeReg(ES8311_VOLUME_MIN_DB));
+    TEST_ASSERT_EQUAL_HEX8(0x00, es8311VolumeReg(-120.0f));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, es8311VolumeReg(ES8311_VOLUME_MAX_DB));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, es8311VolumeReg(40.0f));
+    TEST_ASSERT_EQUAL_HEX8(ES8311_VOLUME_0DB + 12, es8311VolumeReg(6.0f)); // 0.5 dB 步进
+    TEST_ASSERT_EQUAL_HEX8(ES8311_VOLUME_0DB - 1, es8311VolumeReg(-0.4f)); // 就近取整
+    for (int reg = 0; reg <= 0xFF; reg++)
+      TEST_ASSERT_EQUAL_HEX8(reg, es8311VolumeReg(es8311VolumeDb((uint8_t)reg)));
+  }
+
+  void test_not_ready_falls_back_to_software()
+  {
+    TEST_ASSERT_FALSE(g_es8311.ready());
+    TEST_ASSERT_FALSE(es8311SetAdcVolumeDb(6.0f));
+    TEST_ASSERT_FALSE(es8311SetDacVolumeDb(0.0f));
+    TEST_ASSERT_FALSE(es8311SetAdcHpf(true));
+    TEST_ASSERT_FALSE(es8311AdcHpfEnabled());
+    TEST_ASSERT_FALSE(es8311SetAlc(Es8311Alc{}));
+    TEST_ASSERT_FALSE(audioSetInputGainDb(6.0f));
+    TEST_ASSERT_FALSE(audioSetInputHpf(true));
+    audioSetInputGainDb(0.0f);
+    audioSetInputHpf(false);
+  }
+
+  void test_adc_volume_and_hpf_go_to_hardware()
+  {
+    TEST_ASSERT_TRUE(g_es8311.begin(s_wire));
+    TEST_ASSERT_TRUE(audioSetInputGainDb(6.0f));
+    TEST_ASSERT_EQUAL_HEX8(ES8311_VOLUME_0DB + 12, s_dev->regs[0x17]);
+
+    TEST_ASSERT_TRUE(audioSetInputHpf(true));
+    TEST_ASSERT_TRUE(es8311AdcHpfEnabled());
+    TEST_ASSERT_EQUAL_HEX8(0x0A, s_dev->regs[0x1B] & 0x1F);
+    TEST_ASSERT_EQUAL_HEX8(0x20 | 0x0A, s_dev->regs[0x1C] & 0x3F);
+
+    TEST_ASSERT_TRUE(es8311SetAdcHpf(false, 0x05, 0x06));
+    TEST_ASSERT_FALSE(es8311AdcHpfEnabled());
+    TEST_ASSERT_EQUAL_HEX8(0x05, s_dev->regs[0x1B] & 0x1F);
+    TEST_ASSERT_EQUAL_HEX8(0x06, s_dev->regs[0x1C] & 0x3F);
+
+    TEST_ASSERT_TRUE(es8311SetDacVolumeDb(-10.0f));
+    TEST_ASSERT_EQUAL_HEX8(ES8311_VOLUME_0DB - 20, s_dev->regs[0x32]);
+  }
+
+  void test_alc_and_unchanged_writes_skip_the_bus()
+  {
+    Es8311Alc alc;
+    alc.enable = true;
+    alc.window = 0x03;
+    alc.max_level = 0x0C;
+    alc.min_level = 0x04;
+    TEST_ASSERT_TRUE(es8311SetAlc(alc));
+    TEST_ASSERT_EQUAL_HEX8(0x80 | 0x03, s_dev->regs[0x18] & 0x8F);
+    TEST_ASSERT_EQUAL_HEX8(0xC4, s_dev->regs[0x19]);
+
+    // 与影子相同的值不产生 I2C 事务
+    uint32_t before = s_wire.stats().transactions;
+    TEST_ASSERT_TRUE(es8311SetAlc(alc));
+    TEST_ASSERT_TRUE(es8311SetAdcVolumeDb(6.0f));
+    TEST_ASSERT_EQUAL_UINT32(before, s_wire.stats().transactions);
+  }
+
+  void test_invalidate_rereads_registers_changed_outside_the_cache()
+  {
+    TEST_ASSERT_TRUE(es8311SetAdcHpf(false, 0x05, 0x06));
+    // AudioBoard / 精简驱动重新配置时改写了同一寄存器的其他位并打开高通
+    s_dev->regs[0x1C] = 0x40 | 0x20 | 0x06;
+    TEST_ASSERT_FALSE(es8311AdcHpfEnabled()); // 影子仍是旧值
+    g_es8311.invalidate();
+    TEST_ASSERT_TRUE(es8311AdcHpfEnabled());
+
+    s_dev->regs[0x1C] = 0x40 | 0x06;
+    g_es8311.invalidate();
+    TEST_ASSERT_TRUE(es8311SetAdcHpf(true));
+    TEST_ASSERT_EQUAL_HEX8(0x40 | 0x20 | 0x0A, s_dev->regs[0x1C]); // 位 6 保留
+
+    // 没有新的 invalidate 时不再读回
+    uint32_t before = s_wire.stats().transactions;
+    TEST_ASSERT_TRUE(es8311AdcHpfEnabled());
+    TEST_ASSERT_EQUAL_UINT32(before, s_wire.stats().transactions);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  s_dev = &host::attachEs8311(s_wire);
+  s_dev->ready_at_us = 0;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_volume_register_mapping);
+  RUN_TEST(test_not_ready_falls_back_to_software); // 必须在 g_es8311.begin() 之前
+  RUN_TEST(test_adc_volume_and_hpf_go_to_hardware);
+  RUN_TEST(test_alc_and_unchanged_writes_skip_the_bus);
+  RUN_TEST(test_invalidate_rereads_registers_changed_outside_the_cache);
+  return UNITY_END();
+}
@@ -0,0 +1,140 @@
+/**
+ * @file test_main.cpp
+ * @brief 精简 ES8311 驱动（src/es8311.c）在模拟 I2C 总线上的寄存器检查
+ *
+ *  - 初始化后的寄存器值（16 kHz、32 位、MCLK = 256 fs）
+ *  - 时钟分频：MCLK 引脚 / SCLK 作时钟源 / 44.1 kHz 16 位 / 不支持的组合
+ *  - 音量、静音、待机与恢复
+ *  - 芯片 ID 错误、上电前无应答
+ *
+ * 运行：pio test -e native -f test_es8311_driver
+ */
+#include <unity.h>
+
+#include "AudioBoard.h"
+#include "es8311.h"
+#include "es8311_regs.h"
+
+namespace
+{
+  struct Bus
+  {
+    TwoWire wire{1};
+    host::I2CRegisterDevice *dev;
+    es8311_bus_t bus;
+
+    Bus()
+    {
+      wire.begin(-1, -1, 100000);
+      dev = &host::attachEs8311(wire);
+      dev->ready_at_us = 0;
+      bus = es8311WireBus(wire, ES8311_DEFAULT_ADDR);
+    }
+  };
+
+  // 本项目的格式：16 kHz、32 位，MCLK = 256 fs
+  const es8311_clock_t kClock = {4096000, 16000, 32, false};
+
+  Bus *s_bus = nullptr;
+  es8311_t s_dev;
+  const uint8_t *r = nullptr;
+
+  void test_init_registers()
+  {
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_init(&s_dev, &s_bus->bus, &kClock, ES8311_MODE_BOTH));
+    // 从模式，状态机与时钟开启
+    TEST_ASSERT_EQUAL_HEX8(0x80, r[0x00]);
+    TEST_ASSERT_EQUAL_HEX8(0x3F, r[0x01]);
+    // 256 fs：无预倍频 / 分频；BCLK 4 分频，LRCK 256 分频
+    TEST_ASSERT_EQUAL_HEX8(0x00, r[0x02]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, r[0x05]);
+    TEST_ASSERT_EQUAL_HEX8(0x03, r[0x06]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, r[0x07]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, r[0x08]);
+    // I2S，输入输出 32 位
+    TEST_ASSERT_EQUAL_HEX8(0x10, r[0x09]);
+    TEST_ASSERT_EQUAL_HEX8(0x10, r[0x0A]);
+    // ADC、PGA 与 DAC 上电
+    TEST_ASSERT_EQUAL_HEX8(0x01, r[0x0D]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, r[0x0E]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, r[0x12]);
+    TEST_ASSERT_EQUAL_HEX8(0x1A, r[0x14]);
+    // 0 dB，未静音
+    TEST_ASSERT_EQUAL_HEX8(0xBF, r[0x17]);
+    TEST_ASSERT_EQUAL_HEX8(0xBF, r[0x32]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, r[0x31]);
+  }
+
+  void test_clocking()
+  {
+    es8311_clock_t sclk = {0, 16000, 32, true};
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_set_clock(&s_dev, &sclk));
+    TEST_ASSERT_EQUAL_HEX8(0xBF, r[0x01]); // bit 7：MCLK 取自 SCLK
+    TEST_ASSERT_EQUAL_HEX8(0x10, r[0x02]); // ×4 预倍频
+
+    es8311_clock_t cd = {11289600, 44100, 16, false};
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_set_clock(&s_dev, &cd));
+    TEST_ASSERT_EQUAL_HEX8(0x0C, r[0x09]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, r[0x08]);
+
+    es8311_clock_t odd = {4000000, 16000, 32, false}; // 250 fs
+    TEST_ASSERT_EQUAL_INT(ES8311_ERR_CLOCK, es8311_set_clock(&s_dev, &odd));
+
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_set_clock(&s_dev, &kClock));
+    TEST_ASSERT_EQUAL_HEX8(0x3F, r[0x01]);
+  }
+
+  void test_volume_mute_and_power()
+  {
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_set_volume(&s_dev, 50));
+    TEST_ASSERT_EQUAL_HEX8(0x7F, r[0x32]); // 驱动刻度
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_set_mute(&s_dev, true));
+    TEST_ASSERT_EQUAL_HEX8(0x60, r[0x31]);
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_set_mute(&s_dev, false));
+    TEST_ASSERT_EQUAL_HEX8(0x00, r[0x31]);
+
+    // 待机：时钟与模拟部分关闭
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_set_power(&s_dev, false));
+    TEST_ASSERT_EQUAL_HEX8(0x00, r[0x01]);
+    TEST_ASSERT_EQUAL_HEX8(0xFA, r[0x0D]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, r[0x12]);
+    TEST_ASSERT_EQUAL_INT(ES8311_OK, es8311_set_power(&s_dev, true));
+    TEST_ASSERT_EQUAL_HEX8(0x3F, r[0x01]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, r[0x0D]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, r[0x12]);
+  }
+
+  void test_wrong_chip_id()
+  {
+    Bus wrong;
+    wrong.dev->regs[0xFE] = 0x10;
+    es8311_t d;
+    TEST_ASSERT_EQUAL_INT(ES8311_ERR_ID, es8311_init(&d, &wrong.bus, &kClock, ES8311_MODE_BOTH));
+  }
+
+  void test_no_ack_before_power_up()
+  {
+    Bus asleep;
+    asleep.dev->ready_at_us = host::nowMicros() + 1000000;
+    es8311_t d;
+    TEST_ASSERT_EQUAL_INT(ES8311_ERR_I2C, es8311_init(&d, &asleep.bus, &kClock, ES8311_MODE_BOTH));
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  static Bus bus;
+  s_bus = &bus;
+  r = bus.dev->regs;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_init_registers);
+  RUN_TEST(test_clocking);
+  RUN_TEST(test_volume_mute_and_power);
+  RUN_TEST(test_wrong_chip_id);
+  RUN_TEST(test_no_ack_before_power_up);
+  return UNITY_END();
+}
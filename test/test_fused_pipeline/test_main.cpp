@@ -0,0 +1,169 @@
+/**
+ * @file test_main.cpp
+ * @brief 编译期组合流水线（fused_pipeline.h）：输出与逐级处理（运行时 Print 链的顺序）逐字节相同
+ *
+ * 处理：32 位单声道 → 直流去除 → 增益 → 打包 16 / 24 / 32 位。
+ * 参考输出按运行时链的方式逐块、逐级计算（每级处理完整个块再交给下一级，状态跨块保留），
+ * 块大小与流水线的 FUSED_BLOCK_SAMPLES 不同，检查状态在块边界上连续。
+ * 单独的直流去除 / 增益级与录音路径的 InputDsp<int32_t> 输出相同（共用 input_dsp.h 的内核）。
+ *
+ * 运行：pio test -e native -f test_fused_pipeline
+ */
+#include <unity.h>
+
+#include "fused_pipeline.h"
+
+#include <vector>
+
+namespace
+{
+  //===========================================================
+  // 输入：固定的合成信号（三角波 + 直流偏移 + 满刻度采样，考验饱和），可限制每次读取的采样数
+  //===========================================================
+  class PcmStream : public Stream
+  {
+  public:
+    PcmStream(const std::vector<int32_t> &pcm, size_t max_read) : pcm_(pcm), max_read_(max_read) {}
+
+    size_t readBytes(uint8_t *data, size_t len) override
+    {
+      size_t n = std::min(std::min(len / 4, max_read_), pcm_.size() - pos_);
+      memcpy(data, &pcm_[pos_], n * 4);
+      pos_ += n;
+      return n * 4;
+    }
+    size_t write(const uint8_t *, size_t len) override { return len; }
+
+  private:
+    const std::vector<int32_t> &pcm_;
+    size_t max_read_;
+    size_t pos_ = 0;
+  };
+
+  class CapturePrint : public Print
+  {
+  public:
+    using Print::write;
+    size_t write(const uint8_t *data, size_t len) override
+    {
+      bytes.insert(bytes.end(), data, data + len);
+      return len;
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+
+    std::vector<uint8_t> bytes;
+  };
+
+  std::vector<int32_t> stimulus(size_t samples)
+  {
+    std::vector<int32_t> s(samples);
+    for (size_t i = 0; i < samples; i++)
+    {
+      int32_t tri = (int32_t)((i * 7919) % 4096) - 2048;
+      s[i] = (int32_t)(tri * 400000) + 150000000;
+    }
+    s[100] = INT32_MAX; // 直流去除与增益的饱和
+    s[101] = INT32_MIN;
+    s[102] = INT32_MAX;
+    return s;
+  }
+
+  /** @brief 参考：按 chunk 个采样逐块、逐级处理 */
+  template <class Pack>
+  std::vector<uint8_t> chain(const std::vector<int32_t> &in, float gain_db, size_t chunk)
+  {
+    DcBlock dc;
+    Gain gain(gain_db);
+    std::vector<uint8_t> out(in.size() * Pack::kBytes);
+    std::vector<int32_t> buf;
+    uint8_t *o = out.data();
+    for (size_t pos = 0; pos < in.size(); pos += chunk)
+    {
+      buf.assign(in.begin() + pos, in.begin() + std::min(in.size(), pos + chunk));
+      for (int32_t &v : buf)
+        v = dc.process(v);
+      for (int32_t &v : buf)
+        v = gain.process(v);
+      for (int32_t v : buf)
+        o = Pack::put(o, v);
+    }
+    return out;
+  }
+
+  template <class Pack>
+  std::vector<uint8_t> fused(const std::vector<int32_t> &in, float gain_db, size_t max_read)
+  {
+    PcmStream src(in, max_read);
+    CapturePrint out;
+    Pipeline<I2SRx, DcBlock, Gain, Pack, PrintSink> p{I2SRx(src), DcBlock(), Gain(gain_db), Pack(), PrintSink(out)};
+    TEST_ASSERT_EQUAL_UINT32(in.size(), p.run(in.size() + 1)); // 输入结束时停止
+    return out.bytes;
+  }
+
+  template <class Pack>
+  void checkSame(float gain_db, size_t chunk, size_t max_read)
+  {
+    std::vector<int32_t> in = stimulus(FUSED_BLOCK_SAMPLES * 20 + 37); // 最后一块不完整
+    std::vector<uint8_t> ref = chain<Pack>(in, gain_db, chunk);
+    std::vector<uint8_t> got = fused<Pack>(in, gain_db, max_read);
+    TEST_ASSERT_EQUAL_UINT32(ref.size(), got.size());
+    TEST_ASSERT_EQUAL_MEMORY(ref.data(), got.data(), ref.size());
+  }
+
+  void test_pack24_gain6_matches_chain() { checkSame<Pack24>(6.0f, 128, SIZE_MAX); }
+  void test_pack24_small_chunks_and_short_reads() { checkSame<Pack24>(6.0f, 16, 50); }
+  void test_pack16_matches_chain() { checkSame<Pack16>(0.0f, 512, SIZE_MAX); }
+  void test_pack32_high_gain_saturates_like_chain() { checkSame<Pack32>(42.0f, 100, 77); }
+
+  /** @brief 单个处理级与 InputDsp<int32_t> 的输出相同 */
+  template <class Stage>
+  void checkStageMatchesInputDsp(Stage stage, bool hpf, float gain_db)
+  {
+    std::vector<int32_t> in = stimulus(FUSED_BLOCK_SAMPLES * 8);
+    std::vector<int32_t> want = in;
+    InputDsp<int32_t> dsp;
+    dsp.setHpf(hpf);
+    dsp.setGainDb(gain_db);
+    AudioBlock block{};
+    block.data = (uint8_t *)want.data();
+    block.capacity = block.length = (uint32_t)(want.size() * sizeof(int32_t));
+    dsp.process(&block);
+    for (int32_t &v : in)
+      v = stage.process(v);
+    TEST_ASSERT_EQUAL_MEMORY(want.data(), in.data(), in.size() * sizeof(int32_t));
+  }
+
+  void test_stages_match_input_dsp()
+  {
+    checkStageMatchesInputDsp(DcBlock(), true, 0.0f);
+    checkStageMatchesInputDsp(Gain(6.0f), false, 6.0f);
+    checkStageMatchesInputDsp(Gain(60.0f), false, 60.0f); // 同样限制在 +42 dB，满刻度饱和
+  }
+
+  void test_pack_layout_little_endian()
+  {
+    uint8_t b[4];
+    TEST_ASSERT_EQUAL_UINT32(2, Pack16::put(b, 0x12345678) - b);
+    TEST_ASSERT_EQUAL_HEX8(0x34, b[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, b[1]);
+    TEST_ASSERT_EQUAL_UINT32(3, Pack24::put(b, 0x12345678) - b);
+    TEST_ASSERT_EQUAL_HEX8(0x56, b[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, b[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, b[2]);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_pack24_gain6_matches_chain);
+  RUN_TEST(test_pack24_small_chunks_and_short_reads);
+  RUN_TEST(test_pack16_matches_chain);
+  RUN_TEST(test_pack32_high_gain_saturates_like_chain);
+  RUN_TEST(test_stages_match_input_dsp);
+  RUN_TEST(test_pack_layout_little_endian);
+  return UNITY_END();
+}
@@ -0,0 +1,263 @@
+/**
+ * @file test_main.cpp
+ * @brief 参考文件回归测试：固定激励经过录音链与播放链，输出与 golden/ 下提交的 WAV 比较
+ *
+ *  - 录音：I2S RX（激励 PCM）→ audio 任务（软件高通 + 增益，InputDsp）→ storage 任务 → WAVEncoder → SD
+ *  - 播放：SD 上的激励 WAV → WAVDecoder → 播放器软件音量 → BlockTxStream → audio 任务 → I2S TX（WAV）
+ * 激励只用整数运算生成，结果与平台的 libm 无关；默认要求逐位一致（GOLDEN_TOLERANCE LSB）。
+ *
+ * 运行：pio test -e native -f test_golden
+ * 有意修改输出时重新生成：GOLDEN_UPDATE=1 pio test -e native -f test_golden，
+ * 不一致时可用 host/tools/wavdiff.py 查看误差与 SNR（渲染结果在 GOLDEN_OUT_DIR）。
+ */
+#include <unity.h>
+
+#include "AudioTools.h"
+#include "SD.h"
+#include "audio_stats.h"
+#include "audio_tasks.h"
+#include "audio_format.h"
+#include "block_fanout.h"
+#include "wav_header.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+// 参考文件目录（相对项目根目录，pio test 的工作目录）
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "test/test_golden/golden"
+#endif
+
+// 渲染输出目录（同时作为模拟 SD 卡根目录）
+#ifndef GOLDEN_OUT_DIR
+#define GOLDEN_OUT_DIR ".pio/test_golden"
+#endif
+
+// 每个采样允许的最大误差（LSB）；0 为逐位一致
+#ifndef GOLDEN_TOLERANCE
+#define GOLDEN_TOLERANCE 0
+#endif
+
+namespace
+{
+  using Format = RecordFormat;
+  constexpr size_t kSamples = Format::block_frames * 64; // 整数个块（约 0.5 秒）
+
+  // 与 main.cpp 相同的对象组合（不经过 setup()，不启动 ES8311：增益、高通与音量都走软件路径）
+  I2SCodecStream s_i2s(nullptr);
+  StatsOutputStream s_i2s_out(s_i2s);
+  BlockTxStream s_tx(s_i2s_out);
+  WAVDecoder s_decoder;
+  AudioSourceSD s_source("/", ".wav");
+  AudioPlayer s_player(s_source, s_tx, s_decoder);
+  BlockFanout s_fanout;
+  WAVEncoder s_encoder;
+
+  bool s_rendered = false;
+
+  //===========================================================
+  // 激励
+  //===========================================================
+  /** @brief 录音激励：三角波扫频 + 直流偏移 + 伪随机噪声（32 位，考验高通与增益饱和） */
+  std::vector<int32_t> recordStimulus()
+  {
+    std::vector<int32_t> s(kSamples);
+    uint32_t seed = 12345;
+    int64_t phase = 0;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+      phase += 40000 + (int64_t)i * 24; // 每采样的相位增量逐渐变大（扫频）
+      int64_t p = phase & 0xFFFFFF;
+      int64_t tri = p < 0x800000 ? p - 0x400000 : 0xC00000 - p; // ±2^22
+      seed = seed * 1664525u + 1013904223u;
+      int64_t v = tri * 300 + 0x10000000 + (int32_t)(seed >> 12) - (1 << 19); // 直流 1/8 满刻度
+      s[i] = (int32_t)(v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : v);
+    }
+    return s;
+  }
+
+  /** @brief 播放激励：满刻度正负交替 + 伪随机值（考验音量缩放的舍入与饱和） */
+  std::vector<int32_t> playStimulus()
+  {
+    std::vector<int32_t> s(kSamples);
+    for (size_t i = 0; i < s.size(); i++)
+    {
+      if (i < 64)
+        s[i] = (i & 1) ? INT32_MIN : INT32_MAX;
+      else
+        s[i] = (int32_t)((i * 2654435761u) ^ ((i / 40) & 1 ? 0x40000000u : 0xC0000000u));
+    }
+    return s;
+  }
+
+  void writeLe32(std::vector<uint8_t> &out, uint32_t v)
+  {
+    for (int i = 0; i < 4; i++)
+      out.push_back((uint8_t)(v >> (8 * i)));
+  }
+
+  /** @brief 32 位单声道 PCM WAV（44 字节头） */
+  std::vector<uint8_t> wavFile(const std::vector<int32_t> &pcm)
+  {
+    std::vector<uint8_t> w;
+    uint32_t data_len = (uint32_t)(pcm.size() * 4);
+    w.insert(w.end(), {'R', 'I', 'F', 'F'});
+    writeLe32(w, data_len + 36);
+    w.insert(w.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    writeLe32(w, 16);
+    writeLe32(w, 1 | (1u << 16)); // PCM，单声道
+    writeLe32(w, Format::sample_rate);
+    writeLe32(w, Format::sample_rate * Format::frame_bytes);
+    writeLe32(w, Format::frame_bytes | ((uint32_t)Format::bits_per_sample << 16));
+    w.insert(w.end(), {'d', 'a', 't', 'a'});
+    writeLe32(w, data_len);
+    for (int32_t v : pcm)
+      writeLe32(w, (uint32_t)v);
+    return w;
+  }
+
+  bool writeHostFile(const std::string &path, const void *data, size_t len)
+  {
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f)
+      return false;
+    bool ok = fwrite(data, 1, len, f) == len;
+    return fclose(f) == 0 && ok;
+  }
+
+  bool readHostFile(const std::string &path, std::vector<uint8_t> &out)
+  {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f)
+      return false;
+    out.clear();
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+      out.insert(out.end(), buf, buf + n);
+    fclose(f);
+    return true;
+  }
+
+  //===========================================================
+  // 渲染
+  //===========================================================
+  bool render()
+  {
+    std::error_code ec;
+    std::filesystem::create_directories(GOLDEN_OUT_DIR, ec);
+    host::Env &e = host::env();
+    e.sd_root = GOLDEN_OUT_DIR;
+    e.i2s_rx_path = GOLDEN_OUT_DIR "/rx.pcm";
+    e.i2s_tx_path = GOLDEN_OUT_DIR "/play.wav";
+
+    std::vector<int32_t> rx = recordStimulus();
+    std::vector<uint8_t> play_in = wavFile(playStimulus());
+    if (!writeHostFile(e.i2s_rx_path, rx.data(), rx.size() * 4) ||
+        !writeHostFile(GOLDEN_OUT_DIR "/play_in.wav", play_in.data(), play_in.size()))
+      return false;
+
+    I2SCodecConfig cfg = s_i2s.defaultConfig(RXTX_MODE);
+    cfg.copyFrom(Format::info());
+    if (!s_i2s.begin(cfg))
+      return false;
+    audioTasksBegin(s_i2s, s_i2s_out, s_player, s_fanout, s_tx);
+
+    // 录音：软件高通 + 6 dB 增益
+    audioSetInputHpf(true);
+    audioSetInputGainDb(6.0f);
+    File rec = SD.open("/rec.wav", FILE_WRITE);
+    if (!rec)
+      return false;
+    s_encoder.begin(Format::info());
+    s_encoder.setOutput(rec);
+    size_t samples = audioRecord(s_encoder, kSamples);
+    s_encoder.end();
+    rec.close();
+    if (samples != kSamples)
+      return false;
+
+    // 播放：软件音量 0.55（与 setup() 相同）
+    audioSetOutputVolume(0.55f);
+    s_player.begin(0, false);
+    if (!s_player.setPath("/play_in.wav"))
+      return false;
+    s_player.play();
+    audioPlay();
+    s_i2s.end(); // 回填 TX WAV 头
+    return true;
+  }
+
+  //===========================================================
+  // 比较（与 host/tools/wavdiff.py 相同的判定：格式、长度、逐采样误差）
+  //===========================================================
+  void compareWithGolden(const char *name)
+  {
+    TEST_ASSERT_TRUE_MESSAGE(s_rendered, "render failed");
+    std::string actual_path = std::string(GOLDEN_OUT_DIR "/") + name;
+    std::string golden_path = std::string(GOLDEN_DIR "/") + name;
+    std::vector<uint8_t> actual, golden;
+    TEST_ASSERT_TRUE_MESSAGE(readHostFile(actual_path, actual), actual_path.c_str());
+
+    const char *update = getenv("GOLDEN_UPDATE");
+    if (update && *update && strcmp(update, "0") != 0)
+    {
+      TEST_ASSERT_TRUE_MESSAGE(writeHostFile(golden_path, actual.data(), actual.size()), golden_path.c_str());
+      TEST_MESSAGE(("updated " + golden_path).c_str());
+      return;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(readHostFile(golden_path, golden), ("missing " + golden_path).c_str());
+
+    WavFormat g{}, a{};
+    TEST_ASSERT_TRUE_MESSAGE(parseWavHeader(golden.data(), golden.size(), golden.size(), g) == WavError::None,
+                             "golden is not a valid WAV");
+    TEST_ASSERT_TRUE_MESSAGE(parseWavHeader(actual.data(), actual.size(), actual.size(), a) == WavError::None,
+                             "output is not a valid WAV");
+    TEST_ASSERT_TRUE_MESSAGE(g.channels == a.channels && g.sample_rate == a.sample_rate &&
+                                 g.bits_per_sample == a.bits_per_sample,
+                             "format mismatch");
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(g.data_length, a.data_length, "length mismatch");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(32, g.bits_per_sample, "golden files are 32 bit");
+
+    int64_t max_err = 0;
+    size_t first = SIZE_MAX;
+    for (size_t i = 0; i < g.data_length / 4; i++)
+    {
+      int32_t x, y;
+      memcpy(&x, &golden[g.data_offset + i * 4], 4);
+      memcpy(&y, &actual[a.data_offset + i * 4], 4);
+      int64_t d = std::llabs((int64_t)x - (int64_t)y);
+      max_err = d > max_err ? d : max_err;
+      if (d > GOLDEN_TOLERANCE && first == SIZE_MAX)
+        first = i;
+    }
+    if (first != SIZE_MAX)
+    {
+      char msg[320];
+      snprintf(msg, sizeof(msg),
+               "%s: sample %zu over tolerance, max error %lld LSB; see python3 host/tools/wavdiff.py %s %s --tolerance %d",
+               name, first, (long long)max_err, golden_path.c_str(), actual_path.c_str(), GOLDEN_TOLERANCE);
+      TEST_FAIL_MESSAGE(msg);
+    }
+  }
+
+  void test_render() { TEST_ASSERT_TRUE_MESSAGE(s_rendered, "record / playback chain failed"); }
+  void test_record_matches_golden() { compareWithGolden("rec.wav"); }
+  void test_playback_matches_golden() { compareWithGolden("play.wav"); }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  host::env().pace_i2s = false;
+  s_rendered = render();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_render);
+  RUN_TEST(test_record_matches_golden);
+  RUN_TEST(test_playback_matches_golden);
+  return UNITY_END();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file test_main.cpp
+ * @brief i2s_std 后端（I2SDirectStream）的 DMA 环模型
+ *
+ *  - RX：缓冲时长、读取在描述符完成时返回、短于环的停顿不溢出、长于环的停顿按被覆盖的描述符计数
+ *  - TX：预写满环后等待、播放中断流计为饥饿而两段播放之间的空闲不计
+ *  - 负载：每块处理之外偶尔停顿，环长于停顿时不溢出，短于停顿时溢出
+ *
+ * 运行：pio test -e native -f test_i2s_direct（模型按采样率推进主机虚拟时钟）
+ */
+#include <unity.h>
+
+#include "host_env.h"
+#include "i2s_direct.h"
+
+namespace
+{
+  const size_t kBlock = 512; // audio 任务每次读取的字节数（AUDIO_DMA_BLOCK_SIZE）
+
+  I2SDirectConfig config(uint32_t desc, uint32_t frames, bool rx, bool tx)
+  {
+    I2SDirectConfig cfg;
+    cfg.info = AudioInfo(16000, 1, 32);
+    cfg.dma_desc_num = desc;
+    cfg.dma_frame_num = frames;
+    cfg.rx = rx;
+    cfg.tx = tx;
+    return cfg;
+  }
+
+  /** @brief 读取一块，返回虚拟耗时（微秒） */
+  uint64_t timedRead(I2SDirectStream &s, uint8_t *buf)
+  {
+    uint64_t t0 = host::nowMicros();
+    s.readBytes(buf, kBlock);
+    return host::nowMicros() - t0;
+  }
+
+  void test_rx_latency_and_pacing()
+  {
+    uint8_t buf[kBlock];
+    I2SDirectStream rx;
+    TEST_ASSERT_TRUE(rx.begin(config(4, 128, true, false)));
+    TEST_ASSERT_EQUAL_UINT32(32000, rx.latencyUs()); // 4 × 128 帧，16 kHz
+    TEST_ASSERT_EQUAL_UINT32(512, rx.descriptorBytes());
+    TEST_ASSERT_EQUAL_UINT32(8000, timedRead(rx, buf)); // 第一个描述符完成时返回
+    for (int i = 0; i < 100; i++)
+      TEST_ASSERT_EQUAL_UINT32(8000, timedRead(rx, buf));
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats().rx_overflow);
+  }
+
+  void test_rx_stall_shorter_than_ring_does_not_overflow()
+  {
+    uint8_t buf[kBlock];
+    I2SDirectStream rx;
+    rx.begin(config(4, 128, true, false));
+    timedRead(rx, buf);
+    host::advanceMicros(24000); // 3 个描述符（环中最多 4 - 1 个）
+    TEST_ASSERT_EQUAL_UINT32(0, timedRead(rx, buf));
+    TEST_ASSERT_EQUAL_UINT32(0, rx.stats().rx_overflow);
+  }
+
+  void test_rx_stall_longer_than_ring_counts_overwritten_descriptors()
+  {
+    uint8_t buf[kBlock];
+    I2SDirectStream rx;
+    rx.begin(config(4, 128, true, false));
+    timedRead(rx, buf);
+    // 停顿 48 ms：6 个描述符完成，DMA 占用一个，环中只能保留 3 个
+    host::advanceMicros(48000);
+    timedRead(rx, buf);
+    TEST_ASSERT_EQUAL_UINT32(3, rx.stats().rx_overflow);
+  }
+
+  void test_tx_fills_ring_then_waits()
+  {
+    uint8_t buf[kBlock] = {};
+    I2SDirectStream tx;
+    tx.begin(config(4, 128, false, true));
+    uint64_t t0 = host::nowMicros();
+    for (int i = 0; i < 4; i++)
+      tx.write(buf, kBlock);
+    TEST_ASSERT_EQUAL_UINT32(0, host::nowMicros() - t0); // 前 4 块写满环，不等待
+    tx.write(buf, kBlock);
+    TEST_ASSERT_EQUAL_UINT32(8000, host::nowMicros() - t0); // 第 5 块等待一个描述符
+    for (int i = 0; i < 20; i++)
+      tx.write(buf, kBlock);
+    TEST_ASSERT_EQUAL_UINT32(0, tx.stats().tx_starved);
+  }
+
+  void test_tx_gap_starves_but_idle_does_not()
+  {
+    uint8_t buf[kBlock] = {};
+    I2SDirectStream tx;
+    tx.begin(config(4, 128, false, true));
+    for (int i = 0; i < 5; i++)
+      tx.write(buf, kBlock);
+    host::advanceMicros(32000 + 16000); // 写满的环播放完后又空了 2 个描述符
+    tx.write(buf, kBlock);
+    TEST_ASSERT_EQUAL_UINT32(2, tx.stats().tx_starved);
+    host::advanceMicros(1000000); // 两段播放之间的空闲（> I2S_DIRECT_IDLE_MS）
+    tx.write(buf, kBlock);
+    TEST_ASSERT_EQUAL_UINT32(2, tx.stats().tx_starved);
+  }
+
+  /** @brief 每块处理 300 us，每 50 块停顿 20 ms，读取 2 秒，返回溢出的描述符数 */
+  uint32_t runLoad(uint32_t desc, uint32_t frames)
+  {
+    I2SDirectStream s;
+    s.begin(config(desc, frames, true, false));
+    uint8_t buf[kBlock];
+    for (size_t i = 0; i < 2 * 16000 * 4 / kBlock; i++)
+    {
+      s.readBytes(buf, kBlock);
+      host::advanceMicros(300 + (i % 50 == 49 ? 20000 : 0));
+    }
+    return s.stats().rx_overflow;
+  }
+
+  void test_ring_must_cover_the_stall()
+  {
+    TEST_ASSERT_GREATER_THAN_UINT32(0, runLoad(2, 128)); // 16 ms < 20 ms 停顿
+    TEST_ASSERT_EQUAL_UINT32(0, runLoad(4, 128));        // 32 ms
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  host::env().pace_i2s = true; // 模型按采样率推进虚拟时间
+
+  UNITY_BEGIN();
+  RUN_TEST(test_rx_latency_and_pacing);
+  RUN_TEST(test_rx_stall_shorter_than_ring_does_not_overflow);
+  RUN_TEST(test_rx_stall_longer_than_ring_counts_overwritten_descriptors);
+  RUN_TEST(test_tx_fills_ring_then_waits);
+  RUN_TEST(test_tx_gap_starves_but_idle_does_not);
+  RUN_TEST(test_ring_must_cover_the_stall);
+  return UNITY_END();
+}
@@ -0,0 +1,240 @@
+/**
+ * @file test_main.cpp
+ * @brief 录音软件处理（InputDsp<sample_t>）：编译期内核与逐采样判断的参考实现输出逐字节相同
+ *
+ *  - 16 / 32 位 × 高通 / 增益 / 两者，多块连续处理（滤波器状态跨块保留）
+ *  - 满刻度输入与 +42 dB 增益的饱和
+ *  - 0 dB 且高通关闭时 active() 为 false、不修改数据
+ *  - RecordFormat 推导出的采样类型与 InputDsp 一致
+ *  - 另一个线程修改增益时，每块只使用一个增益（设置在块边界生效）
+ *
+ * 运行：pio test -e native -f test_input_dsp
+ * ThreadSanitizer：pio test -e native_tsan -f test_input_dsp
+ */
+#include <unity.h>
+
+#include "audio_format.h"
+#include "input_dsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+  //===========================================================
+  // 参考实现：运行时判断字长与高通（模板化之前的 InputDsp）
+  //===========================================================
+  class RuntimeDsp
+  {
+  public:
+    void setGainDb(float db)
+    {
+      float g = powf(10.0f, db / 20.0f);
+      gain_q16_ = (int32_t)lrintf((g > 128.0f ? 128.0f : g) * 65536.0f);
+    }
+    void setHpf(bool enable) { hpf_ = enable; }
+    bool active() const { return hpf_ || gain_q16_ != (1 << 16); }
+
+    void process(AudioBlock *block, size_t bytes_per_sample)
+    {
+      if (!active())
+        return;
+      if (bytes_per_sample == 2)
+        processSamples((int16_t *)block->data, block->length / 2);
+      else
+        processSamples((int32_t *)block->data, block->length / 4);
+    }
+
+  private:
+    template <class T>
+    void processSamples(T *s, size_t n)
+    {
+      const int64_t lo = std::numeric_limits<T>::min();
+      const int64_t hi = std::numeric_limits<T>::max();
+      int64_t x1 = x1_, y1 = y1_;
+      for (size_t i = 0; i < n; i++)
+      {
+        int64_t v = s[i];
+        if (hpf_)
+        {
+          int64_t y = v - x1 + y1 - (y1 >> INPUT_DSP_HPF_SHIFT);
+          x1 = v;
+          y1 = y;
+          v = y;
+        }
+        v = (v * gain_q16_) >> 16;
+        s[i] = (T)(v < lo ? lo : v > hi ? hi : v);
+      }
+      x1_ = x1;
+      y1_ = y1;
+    }
+
+    int32_t gain_q16_ = 1 << 16;
+    bool hpf_ = false;
+    int64_t x1_ = 0;
+    int64_t y1_ = 0;
+  };
+
+  const size_t kBlockBytes = 512; // AUDIO_DMA_BLOCK_SIZE
+  const size_t kBlocks = 40;
+
+  /** @brief 合成输入：正弦 + 直流偏移，第 3 块开头放满刻度采样（考验饱和） */
+  template <class T>
+  std::vector<T> stimulus()
+  {
+    const size_t n = kBlocks * kBlockBytes / sizeof(T);
+    const double full = (double)std::numeric_limits<T>::max();
+    std::vector<T> s(n);
+    for (size_t i = 0; i < n; i++)
+      s[i] = (T)(sin((double)i * 0.05) * full * 0.6 + full * 0.1);
+    size_t k = 3 * kBlockBytes / sizeof(T);
+    s[k] = std::numeric_limits<T>::max();
+    s[k + 1] = std::numeric_limits<T>::min();
+    s[k + 2] = std::numeric_limits<T>::max();
+    return s;
+  }
+
+  /** @brief 逐块处理整段输入 */
+  template <class T, class Dsp, class... Args>
+  std::vector<T> run(Dsp &dsp, std::vector<T> pcm, Args... args)
+  {
+    for (size_t b = 0; b < kBlocks; b++)
+    {
+      AudioBlock block{};
+      block.data = (uint8_t *)pcm.data() + b * kBlockBytes;
+      block.capacity = kBlockBytes;
+      block.length = kBlockBytes;
+      dsp.process(&block, args...);
+    }
+    return pcm;
+  }
+
+  template <class T>
+  void checkSame(bool hpf, float gain_db)
+  {
+    std::vector<T> in = stimulus<T>();
+    RuntimeDsp ref;
+    ref.setHpf(hpf);
+    ref.setGainDb(gain_db);
+    InputDsp<T> dsp;
+    dsp.setHpf(hpf);
+    dsp.setGainDb(gain_db);
+    TEST_ASSERT_TRUE(dsp.active());
+    std::vector<T> want = run(ref, in, sizeof(T));
+    std::vector<T> got = run(dsp, in);
+    TEST_ASSERT_EQUAL_MEMORY(want.data(), got.data(), want.size() * sizeof(T));
+  }
+
+  void test_32bit_hpf() { checkSame<int32_t>(true, 0.0f); }
+  void test_32bit_gain() { checkSame<int32_t>(false, 6.0f); }
+  void test_32bit_hpf_and_gain() { checkSame<int32_t>(true, 6.0f); }
+  void test_16bit_hpf() { checkSame<int16_t>(true, 0.0f); }
+  void test_16bit_gain() { checkSame<int16_t>(false, -6.0f); }
+  void test_16bit_hpf_and_gain() { checkSame<int16_t>(true, 6.0f); }
+
+  void test_high_gain_saturates()
+  {
+    checkSame<int32_t>(true, 42.0f);
+    checkSame<int16_t>(false, 60.0f); // 限制在 +42 dB
+    std::vector<int32_t> in = stimulus<int32_t>();
+    InputDsp<int32_t> dsp;
+    dsp.setGainDb(42.0f);
+    std::vector<int32_t> got = run(dsp, in);
+    TEST_ASSERT_EQUAL_INT(INT32_MAX, got[3 * kBlockBytes / 4]);
+    TEST_ASSERT_EQUAL_INT(INT32_MIN, got[3 * kBlockBytes / 4 + 1]);
+  }
+
+  void test_inactive_leaves_data_untouched()
+  {
+    InputDsp<int32_t> dsp;
+    TEST_ASSERT_FALSE(dsp.active());
+    dsp.setGainDb(0.0f);
+    dsp.setHpf(false);
+    TEST_ASSERT_FALSE(dsp.active());
+    std::vector<int32_t> in = stimulus<int32_t>();
+    std::vector<int32_t> got = run(dsp, in);
+    TEST_ASSERT_EQUAL_MEMORY(in.data(), got.data(), in.size() * sizeof(int32_t));
+  }
+
+  void test_reset_restarts_filter()
+  {
+    std::vector<int32_t> in = stimulus<int32_t>();
+    InputDsp<int32_t> dsp;
+    dsp.setHpf(true);
+    std::vector<int32_t> first = run(dsp, in);
+    dsp.reset(); // 新一段录音
+    std::vector<int32_t> second = run(dsp, in);
+    TEST_ASSERT_EQUAL_MEMORY(first.data(), second.data(), first.size() * sizeof(int32_t));
+  }
+
+  void test_settings_from_another_thread_apply_per_block()
+  {
+    // audio 任务逐块处理直流输入，control 线程在 0 dB / +6 dB 之间切换增益并请求清除滤波器
+    InputDsp<int32_t> dsp;
+    std::atomic<bool> done{false};
+    std::thread control(
+        [&]
+        {
+          for (uint32_t i = 0; !done.load(std::memory_order_relaxed); i++)
+          {
+            dsp.setGainDb(i & 1 ? 6.0f : 0.0f);
+            dsp.reset();
+            std::this_thread::yield();
+          }
+        });
+
+    const int32_t x = 1000000;
+    const int32_t x6 = (int32_t)(((int64_t)x * inputDspGainQ16(6.0f)) >> 16);
+    std::vector<int32_t> buf(kBlockBytes / 4);
+    uint32_t mixed = 0, seen6 = 0;
+    for (int b = 0; b < 20000 && !(seen6 && b > 2000); b++)
+    {
+      std::fill(buf.begin(), buf.end(), x);
+      AudioBlock block{};
+      block.data = (uint8_t *)buf.data();
+      block.capacity = block.length = kBlockBytes;
+      dsp.process(&block);
+      bool all_x = std::all_of(buf.begin(), buf.end(), [&](int32_t v) { return v == x; });
+      bool all_x6 = std::all_of(buf.begin(), buf.end(), [&](int32_t v) { return v == x6; });
+      mixed += !(all_x || all_x6);
+      seen6 += all_x6;
+    }
+    done.store(true, std::memory_order_relaxed);
+    control.join();
+    TEST_ASSERT_EQUAL_UINT32(0, mixed);
+  }
+
+  void test_record_format()
+  {
+    TEST_ASSERT_TRUE((std::is_same<RecordFormat::sample_t, int32_t>::value));
+    TEST_ASSERT_EQUAL_UINT32(4, RecordFormat::bytes_per_sample);
+    TEST_ASSERT_EQUAL_UINT32(16000, RecordFormat::info().sample_rate);
+    TEST_ASSERT_EQUAL_UINT32(1, RecordFormat::info().channels);
+    TEST_ASSERT_EQUAL_UINT32(32, RecordFormat::info().bits_per_sample);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_32bit_hpf);
+  RUN_TEST(test_32bit_gain);
+  RUN_TEST(test_32bit_hpf_and_gain);
+  RUN_TEST(test_16bit_hpf);
+  RUN_TEST(test_16bit_gain);
+  RUN_TEST(test_16bit_hpf_and_gain);
+  RUN_TEST(test_high_gain_saturates);
+  RUN_TEST(test_inactive_leaves_data_untouched);
+  RUN_TEST(test_reset_restarts_filter);
+  RUN_TEST(test_settings_from_another_thread_apply_per_block);
+  RUN_TEST(test_record_format);
+  return UNITY_END();
+}
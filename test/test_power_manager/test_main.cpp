@@ -0,0 +1,121 @@
+/**
+ * @file test_main.cpp
+ * @brief 电源管理：PmGovernor 的升频 / 降频判断与电流估算模型
+ *
+ *  - 低负载不升频、超过 PM_BOOST_PCT 的下一块升频、阈值 3/4 以上保持、连续 PM_RELAX_BLOCKS 块低负载后才降频
+ *  - 电流估算的边界：空闲只有实际可以浅睡眠的时间按浅睡眠计算，其余在 80 MHz 等待
+ *  - pm JSON：I2S 通道运行时空闲不计入浅睡眠
+ *
+ * 运行：pio test -e native -f test_power_manager
+ */
+#include <unity.h>
+
+#include "host_env.h"
+#include "power_manager.h"
+
+#include <string.h>
+
+namespace
+{
+  const uint32_t kBlockUs = 8000; // 512 字节，16 kHz 32 位单声道
+
+  void test_light_load_never_boosts()
+  {
+    PmGovernor g;
+    bool boosted = false;
+    for (int i = 0; i < 1000; i++)
+      boosted |= g.update(900, PM_MIN_MHZ, kBlockUs); // 80 MHz 下 11%
+    TEST_ASSERT_FALSE(boosted);
+    TEST_ASSERT_EQUAL_UINT32(0, g.boosts());
+  }
+
+  void test_boost_hysteresis()
+  {
+    PmGovernor g;
+    // 80 MHz 下处理 5 ms（> 50% 块时长）：下一块升频，只计一次
+    TEST_ASSERT_TRUE(g.update(5000, PM_MIN_MHZ, kBlockUs));
+    TEST_ASSERT_EQUAL_UINT32(1, g.boosts());
+
+    // 升频后的处理时间按频率折算：240 MHz 下 1.2 ms = 80 MHz 下 3.6 ms（45%，仍高于阈值的 3/4）
+    for (int i = 0; i < PM_RELAX_BLOCKS * 2; i++)
+      TEST_ASSERT_TRUE(g.update(1200, PM_MAX_MHZ, kBlockUs));
+
+    // 连续 PM_RELAX_BLOCKS 块低负载后才降频
+    for (int i = 0; i < PM_RELAX_BLOCKS - 1; i++)
+      TEST_ASSERT_TRUE(g.update(300, PM_MAX_MHZ, kBlockUs));
+    TEST_ASSERT_FALSE(g.update(300, PM_MAX_MHZ, kBlockUs));
+    TEST_ASSERT_EQUAL_UINT32(1, g.boosts());
+  }
+
+  void test_reset_drops_boost()
+  {
+    PmGovernor g;
+    g.update(5000, PM_MIN_MHZ, kBlockUs);
+    TEST_ASSERT_TRUE(g.boost());
+    g.reset(); // 录音 / 播放结束
+    TEST_ASSERT_FALSE(g.boost());
+  }
+
+  void test_current_estimate_bounds()
+  {
+    PmTimes idle{1000000, 0, 0, 0, 0};
+    TEST_ASSERT_EQUAL_UINT32(PM_UA_IDLE_240, pmEstimateUa(idle, PmMode::Off));
+    TEST_ASSERT_EQUAL_UINT32(PM_UA_IDLE_80, pmEstimateUa(idle, PmMode::Stream));
+    // 空闲但没有可以浅睡眠的时间（I2S 通道运行）：80 MHz 等待，不按浅睡眠计算
+    TEST_ASSERT_EQUAL_UINT32(PM_UA_IDLE_80, pmEstimateUa(idle, PmMode::Dfs));
+
+    PmTimes asleep{1000000, 0, 0, 0, 1000000};
+    TEST_ASSERT_EQUAL_UINT32(PM_UA_LIGHT_SLEEP, pmEstimateUa(asleep, PmMode::Dfs));
+    TEST_ASSERT_EQUAL_UINT32(PM_UA_IDLE_240, pmEstimateUa(asleep, PmMode::Off)); // 没有 esp_pm 时不浅睡眠
+
+    PmTimes half{1000000, 0, 0, 0, 500000};
+    TEST_ASSERT_EQUAL_UINT32((PM_UA_LIGHT_SLEEP + PM_UA_IDLE_80) / 2, pmEstimateUa(half, PmMode::Dfs));
+
+    PmTimes busy{1000000, 1000000, 1000000, 0, 0};
+    TEST_ASSERT_EQUAL_UINT32(PM_UA_RUN_240, pmEstimateUa(busy, PmMode::Off));
+    TEST_ASSERT_EQUAL_UINT32(PM_UA_RUN_240, pmEstimateUa(busy, PmMode::Dfs));
+
+    TEST_ASSERT_EQUAL_UINT32((PM_UA_IDLE_80 + PM_UA_IDLE_240) / 2, pmCurrentUa(160, false));
+    TEST_ASSERT_EQUAL_UINT32(PM_UA_RUN_80, pmCurrentUa(PM_MIN_MHZ, true));
+    TEST_ASSERT_EQUAL_UINT32(0, pmEstimateUa(PmTimes{}, PmMode::Dfs));
+  }
+
+  void test_idle_with_i2s_running_is_not_sleep()
+  {
+    char json[512];
+    TEST_ASSERT_TRUE(pmBegin());
+    pmSetI2SRunning(true);
+    pmStatsReset();
+    for (int i = 0; i < 10; i++)
+    {
+      host::advanceMicros(100000);
+      pmIdleStep();
+    }
+    pmToJson(json, sizeof(json));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"total\":1000,"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"sleep\":0}"));
+
+    // 录音 / 播放期间计入 stream
+    pmStreamBegin();
+    host::advanceMicros(500000);
+    pmStreamEnd();
+    pmIdleStep();
+    pmToJson(json, sizeof(json));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"stream\":500,"));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"sleep\":0}"));
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_light_load_never_boosts);
+  RUN_TEST(test_boost_hysteresis);
+  RUN_TEST(test_reset_drops_boost);
+  RUN_TEST(test_current_estimate_bounds);
+  RUN_TEST(test_idle_with_i2s_running_is_not_sleep);
+  return UNITY_END();
+}
@@ -0,0 +1,245 @@
+/**
+ * @file test_main.cpp
+ * @brief 环形缓冲区（ring_buffer.h）：满 / 空、到回绕点为止的连续区域、多线程下的顺序与内容
+ *
+ * 多线程部分交替使用逐个、批量复制与连续区域三种写法，覆盖回绕点；
+ * 生产者写入带序号与校验的元素，消费者检查顺序与内容。
+ *
+ * 运行：pio test -e native -f test_ring_buffer
+ * ThreadSanitizer：pio test -e native_tsan -f test_ring_buffer
+ */
+#include <unity.h>
+
+#include "ring_buffer.h"
+
+#include <thread>
+#include <vector>
+
+// 多线程部分每项的元素数
+#ifndef RING_TEST_ITEMS
+#define RING_TEST_ITEMS 200000
+#endif
+
+namespace
+{
+  struct Item
+  {
+    uint32_t producer;
+    uint32_t seq;
+    uint32_t check; // producer ^ seq 的校验
+  };
+
+  Item spscItem(uint32_t seq) { return {0, seq, seq ^ 0x5a5a5a5au}; }
+  bool spscItemOk(const Item &it, uint32_t seq) { return it.seq == seq && it.check == (seq ^ 0x5a5a5a5au); }
+
+  //===========================================================
+  // 单线程
+  //===========================================================
+  void test_spsc_full_and_empty()
+  {
+    SpscRing<uint32_t, 8> ring;
+    uint32_t v;
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_FALSE(ring.pop(v));
+    for (uint32_t i = 0; i < 8; i++)
+      TEST_ASSERT_TRUE(ring.push(i));
+    TEST_ASSERT_FALSE(ring.push(8));
+    TEST_ASSERT_EQUAL_UINT32(8, ring.size());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.writeSpan().count);
+    for (uint32_t i = 0; i < 8; i++)
+    {
+      TEST_ASSERT_TRUE(ring.pop(v));
+      TEST_ASSERT_EQUAL_UINT32(i, v);
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.readSpan().count);
+  }
+
+  void test_spsc_spans_stop_at_wrap_and_copies_split()
+  {
+    SpscRing<uint32_t, 8> ring;
+    uint32_t buf[8];
+    for (uint32_t i = 0; i < 6; i++)
+      ring.push(i);
+    TEST_ASSERT_EQUAL_UINT32(6, ring.read(buf, 6)); // 读写位置都在 6
+
+    RingSpan<uint32_t> w = ring.writeSpan();
+    TEST_ASSERT_EQUAL_UINT32(2, w.count); // 到回绕点为止
+    w.data[0] = 100;
+    w.data[1] = 101;
+    ring.commitWrite(2);
+    w = ring.writeSpan(3);
+    TEST_ASSERT_EQUAL_UINT32(3, w.count); // 回绕后从下标 0 开始
+    for (uint32_t k = 0; k < 3; k++)
+      w.data[k] = 102 + k;
+    ring.commitWrite(3);
+
+    uint32_t src[4] = {105, 106, 107, 108};
+    TEST_ASSERT_EQUAL_UINT32(3, ring.write(src, 4)); // 只剩 3 个空位
+
+    RingSpan<const uint32_t> r = ring.readSpan();
+    TEST_ASSERT_EQUAL_UINT32(2, r.count);
+    TEST_ASSERT_EQUAL_UINT32(100, r.data[0]);
+    ring.commitRead(1);
+    TEST_ASSERT_EQUAL_UINT32(7, ring.read(buf, 8)); // 跨回绕点分两段复制
+    for (uint32_t k = 0; k < 7; k++)
+      TEST_ASSERT_EQUAL_UINT32(101 + k, buf[k]);
+    TEST_ASSERT_TRUE(ring.empty());
+  }
+
+  void test_mpsc_fifo_full_and_spans()
+  {
+    MpscRing<uint32_t, 4> ring;
+    uint32_t v;
+    TEST_ASSERT_FALSE(ring.pop(v));
+    for (uint32_t round = 0; round < 3; round++) // 三轮覆盖序号回绕
+    {
+      for (uint32_t i = 0; i < 4; i++)
+        TEST_ASSERT_TRUE(ring.push(round * 10 + i));
+      TEST_ASSERT_FALSE(ring.push(99));
+      TEST_ASSERT_TRUE(ring.pop(v));
+      TEST_ASSERT_EQUAL_UINT32(round * 10, v);
+      RingSpan<const uint32_t> r = ring.readSpan();
+      TEST_ASSERT_TRUE(r.count >= 1);
+      for (size_t k = 0; k < r.count; k++)
+        TEST_ASSERT_EQUAL_UINT32(round * 10 + 1 + k, r.data[k]);
+      ring.commitRead(r.count);
+      while (ring.pop(v))
+        ;
+      TEST_ASSERT_TRUE(ring.empty());
+    }
+  }
+
+  //===========================================================
+  // 多线程
+  //===========================================================
+  void test_spsc_threaded_order_and_content()
+  {
+    static SpscRing<Item, 64> ring;
+    const uint32_t items = RING_TEST_ITEMS;
+    std::thread producer(
+        [&]
+        {
+          uint32_t seq = 0;
+          Item buf[7];
+          while (seq < items)
+          {
+            uint32_t before = seq;
+            // 交替使用三种写法，覆盖回绕点
+            switch (seq % 3)
+            {
+            case 0:
+              if (ring.push(spscItem(seq)))
+                seq++;
+              break;
+            case 1:
+            {
+              size_t n = std::min<size_t>(7, items - seq);
+              for (size_t k = 0; k < n; k++)
+                buf[k] = spscItem(seq + (uint32_t)k);
+              seq += (uint32_t)ring.write(buf, n);
+              break;
+            }
+            default:
+            {
+              RingSpan<Item> w = ring.writeSpan(std::min<size_t>(5, items - seq));
+              for (size_t k = 0; k < w.count; k++)
+                w.data[k] = spscItem(seq + (uint32_t)k);
+              ring.commitWrite(w.count);
+              seq += (uint32_t)w.count;
+              break;
+            }
+            }
+            if (seq == before)
+              std::this_thread::yield();
+          }
+        });
+
+    uint32_t expect = 0, bad = 0;
+    Item buf[11];
+    while (expect < items)
+    {
+      size_t n;
+      if (expect & 1)
+      {
+        n = ring.read(buf, 11);
+        for (size_t k = 0; k < n; k++)
+          bad += !spscItemOk(buf[k], expect + (uint32_t)k);
+      }
+      else
+      {
+        RingSpan<const Item> r = ring.readSpan(9);
+        n = r.count;
+        for (size_t k = 0; k < n; k++)
+          bad += !spscItemOk(r.data[k], expect + (uint32_t)k);
+        ring.commitRead(n);
+      }
+      expect += (uint32_t)n;
+      if (!n)
+        std::this_thread::yield();
+    }
+    producer.join();
+    TEST_ASSERT_EQUAL_UINT32(0, bad);
+    TEST_ASSERT_TRUE(ring.empty());
+  }
+
+  void test_mpsc_threaded_per_producer_order()
+  {
+    static MpscRing<Item, 64> ring;
+    const int producers = 4;
+    const uint32_t per = RING_TEST_ITEMS / producers;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+      threads.emplace_back(
+          [&, p]
+          {
+            for (uint32_t i = 0; i < per; i++)
+              while (!ring.push({(uint32_t)p, i, (uint32_t)p ^ i}))
+                std::this_thread::yield();
+          });
+
+    // 每个生产者自己的元素必须按顺序到达
+    std::vector<uint32_t> next((size_t)producers, 0);
+    uint32_t total = per * (uint32_t)producers, got = 0, bad = 0;
+    auto check = [&](const Item &it)
+    {
+      bad += !(it.producer < (uint32_t)producers && it.seq == next[it.producer]++ && it.check == (it.producer ^ it.seq));
+    };
+    while (got < total)
+    {
+      Item item;
+      if ((got & 1) && ring.pop(item))
+      {
+        check(item);
+        got++;
+        continue;
+      }
+      RingSpan<const Item> r = ring.readSpan(13);
+      for (size_t k = 0; k < r.count; k++)
+        check(r.data[k]);
+      ring.commitRead(r.count);
+      got += (uint32_t)r.count;
+      if (!r.count)
+        std::this_thread::yield();
+    }
+    for (auto &t : threads)
+      t.join();
+    TEST_ASSERT_EQUAL_UINT32(0, bad);
+    for (int p = 0; p < producers; p++)
+      TEST_ASSERT_EQUAL_UINT32(per, next[(size_t)p]);
+  }
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main(int, char **)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_spsc_full_and_empty);
+  RUN_TEST(test_spsc_spans_stop_at_wrap_and_copies_split);
+  RUN_TEST(test_mpsc_fifo_full_and_spans);
+  RUN_TEST(test_spsc_threaded_order_and_content);
+  RUN_TEST(test_mpsc_threaded_per_producer_order);
+  return UNITY_END();
+}